@@ -0,0 +1,83 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "benchmark_shared.h"
+
+#include "mcrl2/atermpp/aterm_int.h"
+
+#include "mcrl2/atermpp/standard_containers/indexed_set.h"
+#include "mcrl2/atermpp/standard_containers/concurrent_indexed_set.h"
+#include "mcrl2/utilities/configuration.h"
+
+using namespace atermpp;
+
+/// \brief Every thread inserts its own part of the keys, and afterwards looks up the part of the next thread,
+///        which resembles how the explorer inserts and finds states in its set of discovered states.
+template<typename Set>
+void benchmark_set(const std::string& name, const std::vector<aterm>& keys, std::size_t number_of_threads)
+{
+  Set set(number_of_threads);
+  const std::size_t part = keys.size() / number_of_threads;
+
+  std::cerr << name << " with " << number_of_threads << " threads, ";
+  benchmark_threads(number_of_threads, [&](std::size_t id)
+    {
+      // The indexed_set requires threads to be numbered from one when there are multiple threads.
+      const std::size_t thread_index = number_of_threads == 1 ? 0 : id + 1;
+
+      for (std::size_t i = id * part; i < (id + 1) * part; ++i)
+      {
+        set.insert(keys[i], thread_index);
+      }
+
+      const std::size_t next = (id + 1) % number_of_threads;
+      for (std::size_t i = next * part; i < (next + 1) * part; ++i)
+      {
+        set.index(keys[i], thread_index);
+      }
+    });
+}
+
+int main(int argc, char* argv[])
+{
+  // Accept one argument for the number of threads, otherwise all powers of two up to 64 are measured.
+  std::vector<std::size_t> thread_counts = { 1, 2, 4, 8, 16, 32, 64 };
+  if (argc > 1)
+  {
+    thread_counts = { static_cast<std::size_t>(std::stoi(argv[1])) };
+  }
+
+  std::size_t number_of_keys = 1 << 22;
+  if (argc > 2)
+  {
+    number_of_keys = static_cast<std::size_t>(std::stoi(argv[2])) << 20;
+  }
+
+  // The keys resemble small state vectors.
+  function_symbol state("state", 3);
+  std::vector<aterm> keys;
+  keys.reserve(number_of_keys);
+  for (std::size_t i = 0; i < number_of_keys; ++i)
+  {
+    keys.emplace_back(state, aterm_int(i % 1024), aterm_int(i / 1024), aterm_int(i % 7));
+  }
+
+  for (std::size_t number_of_threads : thread_counts)
+  {
+    if (number_of_threads > 1 && !mcrl2::utilities::detail::GlobalThreadSafe)
+    {
+      continue;
+    }
+
+    benchmark_set<indexed_set<aterm, mcrl2::utilities::detail::GlobalThreadSafe>>("indexed_set", keys, number_of_threads);
+    benchmark_set<concurrent_indexed_set<aterm>>("concurrent_indexed_set", keys, number_of_threads);
+  }
+
+  return 0;
+}
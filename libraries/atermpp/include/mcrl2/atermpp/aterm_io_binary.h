@@ -13,9 +13,12 @@
 #include "mcrl2/atermpp/aterm_io.h"
 
 #include "mcrl2/utilities/bitstream.h"
+#include "mcrl2/utilities/memory_mapped_file.h"
 #include "mcrl2/atermpp/standard_containers/deque.h"
 #include "mcrl2/atermpp/standard_containers/indexed_set.h"
 
+#include <sstream>
+
 namespace atermpp
 {
 
@@ -89,6 +92,121 @@ private:
   std::deque<function_symbol> m_function_symbols; ///< An index of read function symbols.
 };
 
+/// \brief Describes one section of an indexed binary aterm file.
+struct indexed_binary_aterm_section
+{
+  std::size_t offset;          ///< The position of the first byte of the section in the file.
+  std::size_t size;            ///< The number of bytes in the section.
+  std::size_t number_of_terms; ///< The number of terms that were written to the section.
+};
+
+/// \brief Writes terms in the indexed binary aterm format to an output stream.
+/// \details The indexed format splits the sequence of written terms into sections, where every section is
+///          an independent stream in the streamable binary aterm format (see binary_aterm_ostream). Sections
+///          do not share subterms, so each of them can be decoded without reading the others. The sections
+///          are followed by a table that stores the position, size and number of terms of every section and
+///          a fixed size trailer that refers to this table. Readers that have random access to the file
+///          (for example by mapping it into memory) can therefore find and decode any section directly.
+///
+///          Every section is prefixed by its size, and an empty section marks the end of the sections, such
+///          that the format can also be read sequentially from a stream that does not support seeking.
+class indexed_binary_aterm_ostream final : public aterm_ostream
+{
+public:
+  /// \brief Provide the output stream to which the terms are written.
+  /// \param terms_per_section The number of terms after which a new section is started automatically, or
+  ///        zero to only start new sections by calling start_section().
+  indexed_binary_aterm_ostream(std::ostream& os, std::size_t terms_per_section = 0);
+
+  /// \brief Finishes the last section and writes the section table.
+  ~indexed_binary_aterm_ostream() override;
+
+  void put(const aterm& term) override;
+
+  /// \brief Finishes the current section, the following terms are written to a new section.
+  /// \details Terms in different sections are not shared, so sections should not be too small.
+  void start_section();
+
+private:
+  std::ostream& m_stream;
+  std::size_t m_terms_per_section;
+  std::size_t m_position; ///< The number of bytes written to m_stream so far.
+
+  std::stringstream m_section_buffer; ///< Stores the encoding of the current section.
+  std::unique_ptr<binary_aterm_ostream> m_section; ///< Writes to the current section, if one has been started.
+  std::size_t m_section_terms = 0; ///< The number of terms written to the current section.
+
+  std::vector<indexed_binary_aterm_section> m_sections; ///< The sections that have been written.
+};
+
+/// \brief Reads terms from a stream in the indexed binary aterm format.
+/// \details When a filename is given the file is mapped into memory and only the section table is read on
+///          construction, sections are decoded lazily once terms from them are requested. Streams can only
+///          be read sequentially.
+class indexed_binary_aterm_istream final : public aterm_istream
+{
+public:
+  /// \brief Reads the terms sequentially from the given stream.
+  indexed_binary_aterm_istream(std::istream& is);
+
+  /// \brief Maps the file with the given name into memory for random access to its sections.
+  indexed_binary_aterm_istream(const std::string& filename);
+
+  /// \brief Reads the next term, continuing with the next section at the end of a section.
+  void get(aterm& t) override;
+
+  /// \returns The number of sections in the file.
+  /// \pre This stream was constructed from a filename.
+  std::size_t number_of_sections() const;
+
+  /// \returns The description of the given section.
+  /// \pre This stream was constructed from a filename.
+  const indexed_binary_aterm_section& section(std::size_t index) const;
+
+  /// \brief The following calls to get() read the terms of the given section, and the sections after it.
+  /// \pre This stream was constructed from a filename.
+  void seek(std::size_t index);
+
+  /// \brief Sets the number of threads that decode sections in parallel, where zero means one thread per core.
+  /// \details Every thread decodes a whole section into its own thread_aterm_pool, after which the terms of the
+  ///          sections are merged in their original order. The transformer must be safe to call concurrently
+  ///          and, because sections are decoded ahead of reading, should not be changed while reading.
+  ///          Without multithreading support the sections are always decoded sequentially.
+  void set_decoding_threads(std::size_t number_of_threads);
+
+private:
+  /// \brief Determines the next section, where the buffer stores its bytes when they are read from a stream.
+  /// \returns False when there are no more sections.
+  bool next_section(std::string& buffer, const char*& data, std::size_t& size);
+
+  /// \brief Prepares m_section to decode the next section.
+  /// \returns False when there are no more sections.
+  bool open_next_section();
+
+  /// \brief Decodes the next sections in parallel, one per decoding thread, and appends their terms to m_decoded.
+  /// \returns False when there are no more sections.
+  bool decode_next_sections();
+
+  /// \brief Throws an exception when the file is not mapped into memory.
+  void require_random_access(const std::string& operation) const;
+
+  std::istream* m_stream = nullptr; ///< The stream that is read sequentially, if any.
+  std::unique_ptr<mcrl2::utilities::memory_mapped_file> m_file; ///< The mapped file, if any.
+
+  std::vector<indexed_binary_aterm_section> m_sections; ///< The section table of the mapped file.
+  std::size_t m_next_section = 0; ///< The index of the next section to be read from the mapped file.
+
+  std::string m_section_buffer; ///< Stores the current section when it is read from a stream.
+  std::unique_ptr<mcrl2::utilities::memory_istream> m_section_stream; ///< Reads the bytes of the current section.
+  std::unique_ptr<binary_aterm_istream> m_section; ///< Decodes the current section, if any.
+
+  std::size_t m_decoding_threads = 1; ///< The number of sections that are decoded in parallel.
+  atermpp::deque<aterm> m_decoded; ///< The terms of sections that were decoded in parallel, but not yet read.
+};
+
+/// \returns True iff the file with the given name is written in the indexed binary aterm format.
+bool is_indexed_binary_aterm_file(const std::string& filename);
+
 } // namespace atermpp
 
 bool is_a_binary_aterm(std::istream& is);
@@ -12,6 +12,8 @@
 
 #include "mcrl2/utilities/configuration.h"
 
+#include <cstddef>
+
 namespace atermpp
 {
 namespace detail
@@ -20,6 +22,17 @@ namespace detail
 /// \brief Enable garbage collection.
 constexpr static bool EnableGarbageCollection = true;
 
+/// \brief Enable generational garbage collection by default, in which a collection only considers the terms
+///        created since the previous collection, unless the pool has grown too much. Can be changed at runtime
+///        using aterm_pool::enable_generational_garbage_collection.
+constexpr static bool EnableGenerationalGarbageCollection = false;
+
+/// \brief In generational mode a full collection is performed when the pool has grown by this factor since the last one.
+constexpr static std::size_t GenerationalGrowthFactor = 2;
+
+/// \brief The minimum number of terms in the pool before a garbage collection uses multiple threads.
+constexpr static std::size_t ParallelGarbageCollectionThreshold = 1 << 16;
+
 /// \brief Enable the block allocator for terms.
 constexpr static bool EnableBlockAllocator = true;
 
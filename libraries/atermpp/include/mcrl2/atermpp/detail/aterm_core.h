@@ -69,6 +69,20 @@ public:
     m_function_symbol.m_function_symbol.untag();
   }
 
+  /// \brief Mark this term, which may be done by several threads concurrently.
+  /// \returns True iff the term was not marked before.
+  bool try_mark() const
+  {
+    return m_function_symbol.m_function_symbol.try_tag();
+  }
+
+  /// \brief Remove the mark from a term, which may be done by several threads concurrently.
+  /// \returns True iff the term was marked before.
+  bool try_unmark() const
+  {
+    return m_function_symbol.m_function_symbol.try_untag();
+  }
+
   /// \brief Check if the term is already marked.
   bool is_marked() const
   {
@@ -15,6 +15,8 @@
 
 #include "mcrl2/utilities/shared_mutex.h"
 
+#include <chrono>
+
 namespace atermpp
 {
 namespace detail
@@ -63,8 +65,13 @@ public:
   // Prematurely unregister the thread_aterm_pool_interface.
   void unregister();
 
+  /// \returns The terms created by this thread since the previous garbage collection, only
+  ///          maintained in generational mode.
+  std::vector<const _aterm*>& young_terms() { return m_young_terms; }
+
 private:
   aterm_pool& m_pool;
+  std::vector<const _aterm*> m_young_terms;
   std::function<void()> m_mark_function;
   std::function<void()> m_print_function;
   std::function<std::size_t()> m_protection_set_size_function;
@@ -111,6 +118,14 @@ public:
   /// \brief Prints various performance statistics for the term pool.
   inline void print_performance_statistics() const;
 
+  /// \returns The number of garbage collections performed so far.
+  /// \details threadsafe
+  std::size_t number_of_collections() const { return m_number_of_collections.load(std::memory_order_relaxed); }
+
+  /// \returns The total wall clock time during which garbage collections blocked the other threads.
+  /// \details threadsafe
+  std::chrono::nanoseconds collection_time() const { return std::chrono::nanoseconds(m_collection_time.load(std::memory_order_relaxed)); }
+
   /// \returns A global term that indicates the empty list.
   aterm& empty_list() noexcept { return reinterpret_cast<aterm&>(m_empty_list); }  // TODO remove this reinterpret cast by letting m_empty_list become an aterm.
 
@@ -129,6 +144,22 @@ public:
   /// \brief Enable garbage collection when passing true and disable otherwise.
   inline void enable_garbage_collection(bool enable) { m_enable_garbage_collection = enable; };
 
+  /// \brief Sets the number of threads used to mark and sweep during garbage collection.
+  /// \details When zero, which is the default, one thread is used for every registered thread
+  ///          aterm pool (bounded by the hardware concurrency) since these threads are idle during
+  ///          a collection anyway.
+  inline void set_garbage_collection_threads(std::size_t number_of_threads) { m_garbage_collection_threads = number_of_threads; }
+
+  /// \brief Enable generational garbage collection when passing true and disable otherwise.
+  /// \details In generational mode the terms created since the previous collection are recorded and most
+  ///          collections only mark and sweep these young terms. This is sound because terms are immutable,
+  ///          so older terms can never refer to younger terms.
+  /// \details threadsafe
+  inline void enable_generational_garbage_collection(bool enable);
+
+  /// \returns True iff generational garbage collection is enabled.
+  bool is_generational() const { return m_enable_generational_collection.load(std::memory_order_relaxed); }
+
   inline function_symbol_pool& get_symbol_pool() { return m_function_symbol_pool; }
 
   // These functions of the aterm pool should be called through a thread_aterm_pool.
@@ -147,6 +178,25 @@ private:
   /// \details threadsafe
   inline void collect_impl(mcrl2::utilities::shared_mutex& mutex);
 
+  /// \returns The number of threads that should be used for the current garbage collection.
+  inline std::size_t garbage_collection_threads() const;
+
+  /// \brief Marks the terms referenced by all thread pools, where the thread pools are divided over the given number of threads.
+  inline void mark_parallel(std::size_t number_of_threads);
+
+  /// \brief Sweeps all storages, where the buckets of every storage are divided over the given number of threads.
+  inline void sweep_parallel(std::size_t number_of_threads);
+
+  /// \brief Only collects the terms that were created since the previous collection.
+  inline void collect_young(std::size_t number_of_threads);
+
+  /// \brief Removes all recorded young terms, which makes them part of the old generation.
+  inline void clear_young_terms();
+
+  /// \brief Applies the given function to the storage that contains the given term.
+  template<typename Function>
+  inline void apply_to_storage(const _aterm& term, Function function);
+
   /// \brief Creates a integral term with the given value.
   inline bool create_int(aterm& term, std::size_t val);
 
@@ -215,6 +265,21 @@ private:
 
   std::atomic<bool> m_enable_garbage_collection = EnableGarbageCollection; /// Garbage collection is enabled.
 
+  std::size_t m_garbage_collection_threads = 0; ///< The number of threads used for garbage collection, zero means automatic.
+
+  std::atomic<bool> m_enable_generational_collection = EnableGenerationalGarbageCollection; ///< Generational garbage collection is enabled.
+  std::size_t m_size_after_full_collection = 0; ///< The number of terms that remained after the last full collection.
+  std::vector<const _aterm*> m_orphaned_young_terms; ///< Young terms of thread pools that have been removed.
+
+  // Various performance statistics of garbage collection.
+
+  std::atomic<std::size_t> m_number_of_collections = 0; ///< The number of garbage collections performed.
+  std::atomic<std::chrono::nanoseconds::rep> m_collection_time = 0; ///< The wall clock time spent in garbage collections.
+  std::size_t m_number_of_parallel_collections = 0; ///< The number of garbage collections that used more than one thread.
+  std::size_t m_number_of_young_collections = 0; ///< The number of garbage collections that only considered young terms.
+  std::chrono::nanoseconds m_parallel_elapsed_time{0}; ///< The wall clock time spent in parallel marking and sweeping.
+  std::chrono::nanoseconds m_parallel_work_time{0}; ///< The total time spent by all threads in parallel marking and sweeping.
+
   /// All the shared mutexes.
   mcrl2::utilities::shared_mutex m_shared_mutex;
 
@@ -12,6 +12,7 @@
 #pragma once
 
 #include <chrono>
+#include <thread>
 #include "aterm_pool.h"
 #include "aterm_pool_storage_implementation.h"   // For store_in_argument_array. 
 
@@ -21,6 +22,42 @@ namespace atermpp
 namespace detail
 {
 
+/// \brief Executes the given tasks using the given number of threads, where the calling thread is one of them.
+/// \details The tasks are taken from a shared counter, so that threads that finish early continue with the remaining tasks.
+/// \returns The total time that all threads spent on executing tasks.
+inline std::chrono::nanoseconds execute_in_parallel(const std::vector<std::function<void()>>& tasks, std::size_t number_of_threads)
+{
+  std::atomic<std::size_t> next_task = 0;
+  std::atomic<std::int64_t> work_time = 0;
+
+  auto worker = [&]()
+  {
+    auto timestamp = std::chrono::steady_clock::now();
+    for (std::size_t index = next_task.fetch_add(1); index < tasks.size(); index = next_task.fetch_add(1))
+    {
+      tasks[index]();
+    }
+
+    work_time.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timestamp).count());
+  };
+
+  // The spawned threads must not use the thread local term pool, as the global pool is locked exclusively.
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < std::min(number_of_threads, tasks.size()); ++i)
+  {
+    threads.emplace_back(worker);
+  }
+
+  worker();
+
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  return std::chrono::nanoseconds(work_time.load());
+}
+
 aterm_pool::aterm_pool() :
   m_int_storage(*this),
   m_appl_storage(
@@ -110,13 +147,48 @@ void aterm_pool::remove_thread_aterm_pool(thread_aterm_pool_interface& pool)
   auto it = std::find(m_thread_pools.begin(), m_thread_pools.end(), &pool);
   if (it != m_thread_pools.end())
   {
+    // The young terms of this pool can still be referred to by the young terms of other pools.
+    std::vector<const _aterm*>& young_terms = pool.young_terms();
+    m_orphaned_young_terms.insert(m_orphaned_young_terms.end(), young_terms.begin(), young_terms.end());
+    young_terms.clear();
+
     m_thread_pools.erase(it);  // This only removes the pointer, not the underlying data
                                // structure, which only disappears when the thread is removed. 
   }
 }
 
+void aterm_pool::enable_generational_garbage_collection(bool enable)
+{
+  mcrl2::utilities::lock_guard guard = m_shared_mutex.lock();
+
+  if (!enable)
+  {
+    // Terms that are not recorded are considered old, which is only sound when no young term is recorded.
+    clear_young_terms();
+  }
+
+  m_enable_generational_collection = enable;
+}
+
 void aterm_pool::print_performance_statistics() const
 {
+  if (EnableGarbageCollectionMetrics && m_number_of_young_collections > 0)
+  {
+    mCRL2log(mcrl2::log::info) << "g_term_pool(): " << m_number_of_young_collections << " out of " << m_number_of_collections
+      << " garbage collections only considered young terms.\n";
+  }
+
+  if (EnableGarbageCollectionMetrics && m_number_of_parallel_collections > 0)
+  {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(m_parallel_elapsed_time).count();
+    auto work = std::chrono::duration_cast<std::chrono::milliseconds>(m_parallel_work_time).count();
+
+    // The speedup is the ratio between the time that a single thread would have needed and the wall clock time.
+    mCRL2log(mcrl2::log::info) << "g_term_pool(): " << m_number_of_parallel_collections << " out of " << m_number_of_collections
+      << " garbage collections were parallel, taking " << elapsed << " ms for " << work << " ms of work (speedup "
+      << (m_parallel_elapsed_time.count() > 0 ? static_cast<double>(m_parallel_work_time.count()) / m_parallel_elapsed_time.count() : 1.0) << ").\n";
+  }
+
   m_int_storage.print_performance_stats("integral_storage");
   std::get<0>(m_appl_storage).print_performance_stats("term_storage");
   std::get<1>(m_appl_storage).print_performance_stats("function_application_storage_1");
@@ -207,61 +279,92 @@ void aterm_pool::collect_impl(mcrl2::utilities::shared_mutex& shared_mutex)
       return;
     }
 
+    const auto start = std::chrono::steady_clock::now();
     auto timestamp = std::chrono::system_clock::now();
     std::size_t old_size = size();
 
-    // Mark the terms referenced by all thread pools.
-    for (const auto& pool : m_thread_pools)
+    const std::size_t number_of_threads = garbage_collection_threads();
+    ++m_number_of_collections;
+
+    if (m_enable_generational_collection && size() < GenerationalGrowthFactor * m_size_after_full_collection)
     {
-      pool->mark();
+      // The pool has not grown too much, so only consider the terms created since the previous collection.
+      collect_young(number_of_threads);
     }
-
-    assert(std::get<0>(m_appl_storage).verify_mark());
-    assert(std::get<1>(m_appl_storage).verify_mark());
-    assert(std::get<2>(m_appl_storage).verify_mark());
-    assert(std::get<3>(m_appl_storage).verify_mark());
-    assert(std::get<4>(m_appl_storage).verify_mark());
-    assert(std::get<5>(m_appl_storage).verify_mark());
-    assert(std::get<6>(m_appl_storage).verify_mark());
-    assert(std::get<7>(m_appl_storage).verify_mark());
-    assert(m_appl_dynamic_storage.verify_mark());
-
-    // Keep track of the duration for marking and reset for sweep.
-    auto mark_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
-    timestamp = std::chrono::system_clock::now();
-    // Collect all terms that are not marked.
-    m_appl_dynamic_storage.sweep();
-    std::get<7>(m_appl_storage).sweep();
-    std::get<6>(m_appl_storage).sweep();
-    std::get<5>(m_appl_storage).sweep();
-    std::get<4>(m_appl_storage).sweep();
-    std::get<3>(m_appl_storage).sweep();
-    std::get<2>(m_appl_storage).sweep();
-    std::get<1>(m_appl_storage).sweep();
-    std::get<0>(m_appl_storage).sweep();
-    m_int_storage.sweep();
-
-    // Check that after sweeping the terms are consistent.
-    assert(m_int_storage.verify_sweep());
-    assert(std::get<0>(m_appl_storage).verify_sweep());
-    assert(std::get<1>(m_appl_storage).verify_sweep());
-    assert(std::get<2>(m_appl_storage).verify_sweep());
-    assert(std::get<3>(m_appl_storage).verify_sweep());
-    assert(std::get<4>(m_appl_storage).verify_sweep());
-    assert(std::get<5>(m_appl_storage).verify_sweep());
-    assert(std::get<6>(m_appl_storage).verify_sweep());
-    assert(std::get<7>(m_appl_storage).verify_sweep());
-    assert(m_appl_dynamic_storage.verify_sweep());
-
-    // Print some statistics.
-    if (EnableGarbageCollectionMetrics)
+    else
     {
-      // Update the times
-      auto sweep_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
-
-      // Print the relevant information.
-      mCRL2log(mcrl2::log::info) << "g_term_pool(): Garbage collected " << old_size - size() << " terms, " << size() << " terms remaining in "
-        << mark_duration + sweep_duration << " ms (marking " << mark_duration << " ms + sweep " << sweep_duration << " ms).\n";
+      // Mark the terms referenced by all thread pools.
+      if (number_of_threads > 1)
+      {
+        ++m_number_of_parallel_collections;
+        mark_parallel(number_of_threads);
+      }
+      else
+      {
+        for (const auto& pool : m_thread_pools)
+        {
+          pool->mark();
+        }
+      }
+
+      assert(std::get<0>(m_appl_storage).verify_mark());
+      assert(std::get<1>(m_appl_storage).verify_mark());
+      assert(std::get<2>(m_appl_storage).verify_mark());
+      assert(std::get<3>(m_appl_storage).verify_mark());
+      assert(std::get<4>(m_appl_storage).verify_mark());
+      assert(std::get<5>(m_appl_storage).verify_mark());
+      assert(std::get<6>(m_appl_storage).verify_mark());
+      assert(std::get<7>(m_appl_storage).verify_mark());
+      assert(m_appl_dynamic_storage.verify_mark());
+
+      // Keep track of the duration for marking and reset for sweep.
+      auto mark_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
+      timestamp = std::chrono::system_clock::now();
+      // Collect all terms that are not marked.
+      if (number_of_threads > 1)
+      {
+        sweep_parallel(number_of_threads);
+      }
+      else
+      {
+        m_appl_dynamic_storage.sweep();
+        std::get<7>(m_appl_storage).sweep();
+        std::get<6>(m_appl_storage).sweep();
+        std::get<5>(m_appl_storage).sweep();
+        std::get<4>(m_appl_storage).sweep();
+        std::get<3>(m_appl_storage).sweep();
+        std::get<2>(m_appl_storage).sweep();
+        std::get<1>(m_appl_storage).sweep();
+        std::get<0>(m_appl_storage).sweep();
+        m_int_storage.sweep();
+      }
+
+      // Check that after sweeping the terms are consistent.
+      assert(m_int_storage.verify_sweep());
+      assert(std::get<0>(m_appl_storage).verify_sweep());
+      assert(std::get<1>(m_appl_storage).verify_sweep());
+      assert(std::get<2>(m_appl_storage).verify_sweep());
+      assert(std::get<3>(m_appl_storage).verify_sweep());
+      assert(std::get<4>(m_appl_storage).verify_sweep());
+      assert(std::get<5>(m_appl_storage).verify_sweep());
+      assert(std::get<6>(m_appl_storage).verify_sweep());
+      assert(std::get<7>(m_appl_storage).verify_sweep());
+      assert(m_appl_dynamic_storage.verify_sweep());
+
+      // Print some statistics.
+      if (EnableGarbageCollectionMetrics)
+      {
+        // Update the times
+        auto sweep_duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
+
+        // Print the relevant information.
+        mCRL2log(mcrl2::log::info) << "g_term_pool(): Garbage collected " << old_size - size() << " terms, " << size() << " terms remaining in "
+          << mark_duration + sweep_duration << " ms (marking " << mark_duration << " ms + sweep " << sweep_duration << " ms).\n";
+      }
+
+      // All remaining terms belong to the old generation.
+      clear_young_terms();
+      m_size_after_full_collection = size();
     }
 
     // Garbage collect function symbols.
@@ -276,6 +379,223 @@ void aterm_pool::collect_impl(mcrl2::utilities::shared_mutex& shared_mutex)
     {
       m_count_until_collection = 1;
     }
+
+    m_collection_time.fetch_add((std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+  }
+}
+
+std::size_t aterm_pool::garbage_collection_threads() const
+{
+  if constexpr (mcrl2::utilities::detail::GlobalThreadSafe)
+  {
+    if (size() < ParallelGarbageCollectionThreshold)
+    {
+      // Starting threads is not worth it for small pools.
+      return 1;
+    }
+
+    if (m_garbage_collection_threads != 0)
+    {
+      return m_garbage_collection_threads;
+    }
+
+    return std::max<std::size_t>(1, std::min<std::size_t>(m_thread_pools.size(), std::thread::hardware_concurrency()));
+  }
+  else
+  {
+    return 1;
+  }
+}
+
+void aterm_pool::mark_parallel(std::size_t number_of_threads)
+{
+  // Every thread pool marks its own root set, using its own todo stack.
+  std::vector<std::function<void()>> tasks;
+  for (thread_aterm_pool_interface* pool : m_thread_pools)
+  {
+    tasks.emplace_back([pool]() { pool->mark(); });
+  }
+
+  // The mark bit of a term is set with an atomic read-modify-write, so a term reachable from multiple
+  // root sets is claimed, and its arguments explored, by exactly one thread.
+  auto timestamp = std::chrono::steady_clock::now();
+  m_parallel_work_time += execute_in_parallel(tasks, number_of_threads);
+  m_parallel_elapsed_time += std::chrono::steady_clock::now() - timestamp;
+}
+
+void aterm_pool::sweep_parallel(std::size_t number_of_threads)
+{
+  std::vector<std::function<void()>> tasks;
+
+  // Divide the buckets of every storage into ranges that are swept independently.
+  auto add_sweep_tasks = [&tasks, number_of_threads](auto& storage)
+  {
+    if (storage.has_deletion_hooks())
+    {
+      // Deletion hooks might protect terms, which is only allowed on this thread. These storages are
+      // swept before the others, so that the arguments of a deleted term are still valid in the hooks.
+      storage.sweep();
+    }
+    else
+    {
+      const std::size_t buckets = storage.bucket_count();
+      const std::size_t ranges = std::min(buckets, 4 * number_of_threads);
+      for (std::size_t i = 0; i < ranges; ++i)
+      {
+        tasks.emplace_back([&storage, first = buckets * i / ranges, last = buckets * (i + 1) / ranges]() { storage.sweep(first, last); });
+      }
+    }
+  };
+
+  add_sweep_tasks(m_appl_dynamic_storage);
+  add_sweep_tasks(std::get<7>(m_appl_storage));
+  add_sweep_tasks(std::get<6>(m_appl_storage));
+  add_sweep_tasks(std::get<5>(m_appl_storage));
+  add_sweep_tasks(std::get<4>(m_appl_storage));
+  add_sweep_tasks(std::get<3>(m_appl_storage));
+  add_sweep_tasks(std::get<2>(m_appl_storage));
+  add_sweep_tasks(std::get<1>(m_appl_storage));
+  add_sweep_tasks(std::get<0>(m_appl_storage));
+  add_sweep_tasks(m_int_storage);
+
+  auto timestamp = std::chrono::steady_clock::now();
+  m_parallel_work_time += execute_in_parallel(tasks, number_of_threads);
+  m_parallel_elapsed_time += std::chrono::steady_clock::now() - timestamp;
+
+  // The storages swept in parallel have not cleaned up their blocks yet.
+  auto consolidate = [](auto& storage)
+  {
+    if (!storage.has_deletion_hooks())
+    {
+      storage.consolidate();
+    }
+  };
+
+  consolidate(m_appl_dynamic_storage);
+  consolidate(std::get<7>(m_appl_storage));
+  consolidate(std::get<6>(m_appl_storage));
+  consolidate(std::get<5>(m_appl_storage));
+  consolidate(std::get<4>(m_appl_storage));
+  consolidate(std::get<3>(m_appl_storage));
+  consolidate(std::get<2>(m_appl_storage));
+  consolidate(std::get<1>(m_appl_storage));
+  consolidate(std::get<0>(m_appl_storage));
+  consolidate(m_int_storage);
+}
+
+void aterm_pool::collect_young(std::size_t number_of_threads)
+{
+  auto timestamp = std::chrono::system_clock::now();
+  ++m_number_of_young_collections;
+
+  // Take the young terms, because deletion hooks might create new young terms.
+  std::vector<const _aterm*> young_terms;
+  young_terms.swap(m_orphaned_young_terms);
+  for (thread_aterm_pool_interface* pool : m_thread_pools)
+  {
+    young_terms.insert(young_terms.end(), pool->young_terms().begin(), pool->young_terms().end());
+    pool->young_terms().clear();
+  }
+
+  // Only the young terms are marked, and marking from the root set removes the marks of reachable young terms.
+  for (const _aterm* term : young_terms)
+  {
+    term->mark();
+  }
+
+  young_collection_in_progress() = true;
+  if (number_of_threads > 1)
+  {
+    ++m_number_of_parallel_collections;
+    mark_parallel(number_of_threads);
+  }
+  else
+  {
+    for (const auto& pool : m_thread_pools)
+    {
+      pool->mark();
+    }
+  }
+  young_collection_in_progress() = false;
+
+  // Call all deletion hooks before destroying any term, such that the arguments of deleted terms are still valid.
+  for (const _aterm* term : young_terms)
+  {
+    if (term->is_marked())
+    {
+      apply_to_storage(*term, [term](auto& storage) { storage.call_deletion_hook(term); });
+    }
+  }
+
+  std::size_t number_of_erased = 0;
+  for (const _aterm* term : young_terms)
+  {
+    if (term->is_marked())
+    {
+      term->unmark();
+      apply_to_storage(*term, [term](auto& storage) { storage.erase(*term); });
+      ++number_of_erased;
+    }
+  }
+
+  if (EnableGarbageCollectionMetrics)
+  {
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - timestamp).count();
+
+    mCRL2log(mcrl2::log::info) << "g_term_pool(): Garbage collected " << number_of_erased << " out of " << young_terms.size()
+      << " young terms, " << size() << " terms remaining in " << duration << " ms.\n";
+  }
+}
+
+void aterm_pool::clear_young_terms()
+{
+  m_orphaned_young_terms.clear();
+  for (thread_aterm_pool_interface* pool : m_thread_pools)
+  {
+    pool->young_terms().clear();
+  }
+}
+
+template<typename Function>
+void aterm_pool::apply_to_storage(const _aterm& term, Function function)
+{
+  switch (term.function().arity())
+  {
+  case 0:
+  {
+    if (term.function() == get_symbol_pool().as_int())
+    {
+      function(m_int_storage);
+    }
+    else
+    {
+      function(std::get<0>(m_appl_storage));
+    }
+  }
+    break;
+  case 1:
+    function(std::get<1>(m_appl_storage));
+    break;
+  case 2:
+    function(std::get<2>(m_appl_storage));
+    break;
+  case 3:
+    function(std::get<3>(m_appl_storage));
+    break;
+  case 4:
+    function(std::get<4>(m_appl_storage));
+    break;
+  case 5:
+    function(std::get<5>(m_appl_storage));
+    break;
+  case 6:
+    function(std::get<6>(m_appl_storage));
+    break;
+  case 7:
+    function(std::get<7>(m_appl_storage));
+    break;
+  default:
+    function(m_appl_dynamic_storage);
   }
 }
 
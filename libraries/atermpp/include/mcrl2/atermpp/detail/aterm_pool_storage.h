@@ -33,6 +33,15 @@ class aterm_pool;
 /// \brief Marks a term and recursively all arguments that are not reachable.
 inline void mark_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& todo);
 
+/// \returns A reference to a flag that is true iff a collection of only the young terms is in progress.
+/// \details During such a collection only the young terms are marked beforehand, and marking a
+///          term instead removes the mark of the young terms that are reachable from it.
+inline bool& young_collection_in_progress()
+{
+  static bool in_progress = false;
+  return in_progress;
+}
+
 /// \brief This class provides for all types of term storage. It also
 ///       provides garbage collection via its mark and sweep functions.
 /// \details Internally a hash set is used to ensure that the created terms are unique.
@@ -157,6 +166,23 @@ public:
   ///        mark() was called first.
   void sweep();
 
+  /// \brief Destroys all terms that are not reachable in the buckets [first, last) of the hash table.
+  /// \details Requires that mark() was called first. Calls on disjoint bucket ranges are threadsafe
+  ///          when this storage has no deletion hooks. Afterwards consolidate() must be called.
+  void sweep(std::size_t first, std::size_t last);
+
+  /// \brief Frees the blocks of the allocator that no longer contain terms.
+  void consolidate();
+
+  /// \brief Destroys the given term of this storage, which must be unreachable, without calling the deletion hooks.
+  void erase(const _aterm& term);
+
+  /// \returns The number of buckets of the underlying hash table.
+  std::size_t bucket_count() const noexcept { return m_term_set.bucket_count(); }
+
+  /// \returns True iff a deletion hook has been registered for a function symbol in this storage.
+  bool has_deletion_hooks() const noexcept { return !m_deletion_hooks.empty(); }
+
   /// \brief Resizes the hash table if necessary.
   void resize_if_needed();
 
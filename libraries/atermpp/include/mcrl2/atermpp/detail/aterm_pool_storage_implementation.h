@@ -81,9 +81,39 @@ inline std::array<unprotected_aterm_core, N> construct_arguments(InputIterator i
   return arguments;
 }
 
+/// \brief Removes the mark of a young term and recursively of all its marked arguments.
+inline void unmark_young_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& todo)
+{
+  if (root.try_unmark())
+  {
+    todo.push(const_cast<_aterm&>(root));
+
+    while (!todo.empty())
+    {
+      _term_appl& term = static_cast<_term_appl&>(todo.top().get());
+      todo.pop();
+
+      // Old terms are never marked, and can only have old terms as arguments.
+      const std::size_t arity = term.function().arity();
+      for (std::size_t i = 0; i < arity; ++i)
+      {
+        _aterm& argument = *detail::address(term.arg(i));
+        if (argument.try_unmark())
+        {
+          todo.push(argument);
+        }
+      }
+    }
+  }
+}
+
 void mark_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& todo)
 {
-  if (!root.is_marked())
+  if (young_collection_in_progress())
+  {
+    unmark_young_term(root, todo);
+  }
+  else if (root.try_mark())
   {
     // Do not use the stack, because this might run out of stack memory for large lists.
     todo.push(const_cast<_aterm&>(root));
@@ -94,8 +124,6 @@ void mark_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& t
       _aterm& term = todo.top();
       todo.pop();
 
-      // Each term should be marked.
-      term.mark();
       // Determine the arity of the function application.
       const std::size_t arity = term.function().arity();
       _term_appl& term_appl = static_cast<_term_appl&>(term);
@@ -103,12 +131,11 @@ void mark_term(const _aterm& root, std::stack<std::reference_wrapper<_aterm>>& t
       for (std::size_t i = 0; i < arity; ++i)
       {
         // Marks all arguments that are not already (marked as) reachable, because the current
-        // term is reachable and as such its arguments are reachable as well.
+        // term is reachable and as such its arguments are reachable as well. Marking is an atomic
+        // operation, so when terms are marked in parallel each term is explored by one thread.
         _aterm& argument = *detail::address(term_appl.arg(i));
-        if (!argument.is_marked())
+        if (argument.try_mark())
         {
-          argument.mark();
-
           // Add the argument to be explored as well.
           todo.push(argument);
         }
@@ -344,6 +371,37 @@ void ATERM_POOL_STORAGE::sweep()
     }
   }
 
+  consolidate();
+}
+
+ATERM_POOL_STORAGE_TEMPLATES
+void ATERM_POOL_STORAGE::sweep(std::size_t first, std::size_t last)
+{
+  assert(m_deletion_hooks.empty());
+
+  m_term_set.erase_if(first, last, [](const Element& term)
+    {
+      if (term.is_marked())
+      {
+        // Reset terms that have been marked.
+        term.unmark();
+        return false;
+      }
+
+      return true;
+    });
+}
+
+ATERM_POOL_STORAGE_TEMPLATES
+void ATERM_POOL_STORAGE::erase(const _aterm& term)
+{
+  assert(!term.is_marked());
+  m_term_set.erase(static_cast<const Element&>(term));
+}
+
+ATERM_POOL_STORAGE_TEMPLATES
+void ATERM_POOL_STORAGE::consolidate()
+{
   if constexpr (EnableBlockAllocator)
   {
     // Clean up unnecessary blocks.
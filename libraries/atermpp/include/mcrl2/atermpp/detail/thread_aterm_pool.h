@@ -120,6 +120,10 @@ public:
   inline void collect() { m_pool.collect(m_shared_mutex); }
 
 private:
+  /// \brief Records a term that was just added to the pool, when generational garbage collection is enabled.
+  /// \details Must be called while holding the shared lock, such that it cannot interleave with changing the mode.
+  inline void record_young_term(const aterm& term);
+
   aterm_pool& m_pool;
 
   /// Keeps track of pointers to all existing aterm variables and containers.
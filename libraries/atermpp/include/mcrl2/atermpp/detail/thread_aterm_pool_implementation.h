@@ -39,6 +39,7 @@ void thread_aterm_pool::create_int(aterm& term, size_t val)
 {
   mcrl2::utilities::shared_guard guard = m_shared_mutex.lock_shared();
   bool added = m_pool.create_int(term, val);
+  if (added) { record_young_term(term); }
   guard.unlock_shared();
    
   if (added) { m_pool.created_term(!m_shared_mutex.is_shared_locked(), m_shared_mutex); }
@@ -48,6 +49,7 @@ void thread_aterm_pool::create_term(aterm& term, const atermpp::function_symbol&
 {
   mcrl2::utilities::shared_guard guard = m_shared_mutex.lock_shared();
   bool added = m_pool.create_term(term, sym);
+  if (added) { record_young_term(term); }
   guard.unlock_shared();
 
   if (added) { m_pool.created_term(!m_shared_mutex.is_shared_locked(), m_shared_mutex); }
@@ -58,6 +60,7 @@ void thread_aterm_pool::create_appl(aterm& term, const function_symbol& sym, con
 {
   mcrl2::utilities::shared_guard guard = m_shared_mutex.lock_shared();
   bool added = m_pool.create_appl(term, sym, arguments...);
+  if (added) { record_young_term(term); }
   guard.unlock_shared();
 
   if (added) { m_pool.created_term(!m_shared_mutex.is_shared_locked(), m_shared_mutex); }
@@ -94,6 +97,7 @@ void thread_aterm_pool::create_appl_index(aterm& term, const function_symbol& sy
                                 insert(*reinterpret_cast<INDEX_TYPE*>(&argument_array[0])));
     added = m_pool.create_appl(term, sym, argument_array[0], argument_array[1], term);
   }
+  if (added) { record_young_term(term); }
   guard.unlock_shared();
 
   if (added) { m_pool.created_term(!m_shared_mutex.is_shared_locked(), m_shared_mutex); }
@@ -107,6 +111,7 @@ void thread_aterm_pool::create_appl_dynamic(aterm& term,
 {
   mcrl2::utilities::shared_guard guard = m_shared_mutex.lock_shared();
   bool added = m_pool.create_appl_dynamic(term, sym, begin, end);
+  if (added) { record_young_term(term); }
   guard.unlock_shared();
     
   if (added) { m_pool.created_term(!m_shared_mutex.is_shared_locked(), m_shared_mutex); }
@@ -121,11 +126,20 @@ void thread_aterm_pool::create_appl_dynamic(aterm& term,
 {  
   mcrl2::utilities::shared_guard guard = m_shared_mutex.lock_shared();
   bool added = m_pool.create_appl_dynamic(term, sym, convert_to_aterm, begin, end);
+  if (added) { record_young_term(term); }
   guard.unlock_shared();
 
   if (added) { m_pool.created_term(!m_shared_mutex.is_shared_locked(), m_shared_mutex); }
 }
 
+void thread_aterm_pool::record_young_term(const aterm& term)
+{
+  if (m_pool.is_generational())
+  {
+    m_thread_interface.young_terms().push_back(detail::address(reinterpret_cast<const unprotected_aterm_core&>(term)));
+  }
+}
+
 void thread_aterm_pool::register_variable(aterm_core* variable)
 {
   if constexpr (EnableVariableRegistrationMetrics) { ++m_variable_insertions; }
@@ -183,9 +197,9 @@ void thread_aterm_pool::mark()
     {
       // Mark all terms (and their subterms) that are reachable, i.e the root set.
       _aterm* term = detail::address(*variable);
-      if (term != nullptr && !term->is_marked()) 
+      if (term != nullptr) 
       {
-        // This variable is not a default term and that term has not been marked.
+        // This variable is not a default term, marking stops immediately when the term has already been visited.
         mark_term(*term, m_todo);
       }
     }
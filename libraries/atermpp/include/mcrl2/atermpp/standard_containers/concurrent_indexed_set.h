@@ -0,0 +1,68 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
+#define MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
+
+#include "mcrl2/atermpp/detail/aterm_container.h"
+#include "mcrl2/atermpp/detail/thread_aterm_pool.h"
+#include "mcrl2/utilities/concurrent_indexed_set.h"
+#include "mcrl2/utilities/shared_mutex.h"
+
+namespace atermpp
+{
+
+/// \brief A concurrent set that assigns each element an unique index, and protects its internal terms en masse.
+/// \details Can be used instead of atermpp::indexed_set, see mcrl2::utilities::concurrent_indexed_set.
+template<typename Key,
+         typename Hash = std::hash<Key>,
+         typename Equals = std::equal_to<Key>>
+class concurrent_indexed_set: public mcrl2::utilities::concurrent_indexed_set<Key, Hash, Equals, detail::reference_aterm<Key>>
+{
+  typedef mcrl2::utilities::concurrent_indexed_set<Key, Hash, Equals, detail::reference_aterm<Key>> super;
+
+public:
+  typedef typename super::size_type size_type;
+
+  concurrent_indexed_set()
+    : container_wrapper(*this)
+  {}
+
+  concurrent_indexed_set(std::size_t number_of_threads)
+    : super(number_of_threads),
+      container_wrapper(*this)
+  {}
+
+  concurrent_indexed_set(std::size_t number_of_threads,
+                       std::size_t initial_hashtable_size,
+                       const typename super::hasher& hash = typename super::hasher(),
+                       const typename super::key_equal& equals = typename super::key_equal())
+    : super(number_of_threads, initial_hashtable_size, hash, equals),
+      container_wrapper(*this)
+  {}
+
+  void clear(std::size_t thread_index=0)
+  {
+    mcrl2::utilities::shared_guard guard = detail::g_thread_term_pool().lock_shared();
+    super::clear(thread_index);
+  }
+
+  std::pair<size_type, bool> insert(const Key& key, std::size_t thread_index=0)
+  {
+    // Garbage collection cannot take place while a key is being stored.
+    mcrl2::utilities::shared_guard guard = detail::g_thread_term_pool().lock_shared();
+    return super::insert(key, thread_index);
+  }
+
+private:
+  detail::generic_aterm_container<super> container_wrapper;
+};
+
+} // namespace atermpp
+
+#endif // MCRL2_ATERMPP_CONCURRENT_INDEXED_SET_H
@@ -9,6 +9,11 @@
 
 #include "mcrl2/atermpp/aterm_io_binary.h"
 #include "mcrl2/atermpp/standard_containers/stack.h"
+#include "mcrl2/utilities/unused.h"
+
+#include <condition_variable>
+#include <fstream>
+#include <thread>
 
 
 namespace atermpp
@@ -39,6 +44,14 @@ static constexpr std::uint16_t BAF_MAGIC = 0x8baf;
 /// 6  August 2024    : version changed to 0x8308 (introduced machine numbers)
 static constexpr std::uint16_t BAF_VERSION = 0x8308;
 
+/// \brief The version of the indexed binary aterm format, which consists of independent sections in the
+///        BAF_VERSION format followed by a section table. The history is the same as for BAF_VERSION.
+///
+/// \details History:
+///
+/// 16 October 2026   : version 0x8309 (introduction of the indexed binary aterm format)
+static constexpr std::uint16_t BAF_INDEXED_VERSION = 0x8309;
+
 /// \brief Each packet has a header consisting of a type.
 /// \details Either indicates a function symbol, a term (either shared or output) or an arbitrary integer.
 enum class packet_type
@@ -319,6 +332,425 @@ unsigned int binary_aterm_istream::function_symbol_index_width()
   return m_function_symbol_index_width;
 }
 
+/// \brief The number of bytes of the header of an indexed binary aterm file; a zero byte, the magic and the version.
+static constexpr std::size_t indexed_header_size = 5;
+
+/// \brief The number of bytes of the trailer of an indexed binary aterm file; the number of sections and the
+///        position of the section table, followed by the magic and the version.
+static constexpr std::size_t indexed_trailer_size = 2 * 8 + 4;
+
+/// \brief The number of bytes of a single entry in the section table.
+static constexpr std::size_t indexed_section_entry_size = 3 * 8;
+
+/// \brief Writes the given number as the given number of bytes, most significant byte first.
+static void write_bytes(std::ostream& stream, std::size_t value, std::size_t number_of_bytes)
+{
+  for (std::size_t i = number_of_bytes; i > 0; --i)
+  {
+    stream.put(static_cast<char>((value >> (8 * (i - 1))) & 0xff));
+  }
+}
+
+/// \brief Reads a number of the given number of bytes, most significant byte first.
+static std::size_t read_bytes(const char* data, std::size_t number_of_bytes)
+{
+  std::size_t value = 0;
+  for (std::size_t i = 0; i < number_of_bytes; ++i)
+  {
+    value = (value << 8) | static_cast<unsigned char>(data[i]);
+  }
+  return value;
+}
+
+/// \brief Reads a number of the given number of bytes from the stream, most significant byte first.
+static std::size_t read_bytes(std::istream& stream, std::size_t number_of_bytes)
+{
+  char buffer[8];
+  assert(number_of_bytes <= sizeof(buffer));
+  if (!stream.read(buffer, static_cast<std::streamsize>(number_of_bytes)))
+  {
+    throw mcrl2::runtime_error("Error while reading: unexpected end of an indexed binary aterm stream.");
+  }
+  return read_bytes(buffer, number_of_bytes);
+}
+
+/// \brief Checks the magic and version of an indexed binary aterm file.
+static void check_indexed_header(std::size_t magic, std::size_t version)
+{
+  if (magic != BAF_MAGIC)
+  {
+    throw mcrl2::runtime_error("Error while reading: missing the BAF_MAGIC control sequence.");
+  }
+
+  if (version != BAF_INDEXED_VERSION)
+  {
+    throw mcrl2::runtime_error("The BAF version (" + std::to_string(version) + ") of the input file is incompatible with the version (" + std::to_string(BAF_INDEXED_VERSION) +
+                               ") of this tool. The input file must be regenerated. ");
+  }
+}
+
+indexed_binary_aterm_ostream::indexed_binary_aterm_ostream(std::ostream& stream, std::size_t terms_per_section)
+  : m_stream(stream),
+    m_terms_per_section(terms_per_section),
+    m_position(indexed_header_size)
+{
+  write_bytes(m_stream, 0, 1);
+  write_bytes(m_stream, BAF_MAGIC, 2);
+  write_bytes(m_stream, BAF_INDEXED_VERSION, 2);
+}
+
+indexed_binary_aterm_ostream::~indexed_binary_aterm_ostream()
+{
+  start_section();
+
+  // An empty section indicates the end of the sections for sequential readers.
+  write_bytes(m_stream, 0, 8);
+  std::size_t table_position = m_position + 8;
+
+  for (const indexed_binary_aterm_section& section : m_sections)
+  {
+    write_bytes(m_stream, section.offset, 8);
+    write_bytes(m_stream, section.size, 8);
+    write_bytes(m_stream, section.number_of_terms, 8);
+  }
+
+  write_bytes(m_stream, m_sections.size(), 8);
+  write_bytes(m_stream, table_position, 8);
+  write_bytes(m_stream, BAF_MAGIC, 2);
+  write_bytes(m_stream, BAF_INDEXED_VERSION, 2);
+  m_stream.flush();
+}
+
+void indexed_binary_aterm_ostream::put(const aterm& term)
+{
+  if (!m_section)
+  {
+    m_section = std::make_unique<binary_aterm_ostream>(m_section_buffer);
+  }
+
+  m_section->set_transformer(m_transformer);
+  m_section->put(term);
+  ++m_section_terms;
+
+  if (m_terms_per_section != 0 && m_section_terms >= m_terms_per_section)
+  {
+    start_section();
+  }
+}
+
+void indexed_binary_aterm_ostream::start_section()
+{
+  if (m_section)
+  {
+    // Destroying the stream writes the end of the section and flushes the underlying bitstream.
+    m_section.reset();
+
+    const std::string data = m_section_buffer.str();
+    write_bytes(m_stream, data.size(), 8);
+    m_stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    m_sections.push_back(indexed_binary_aterm_section{m_position + 8, data.size(), m_section_terms});
+    m_position += 8 + data.size();
+
+    m_section_buffer.str(std::string());
+    m_section_terms = 0;
+  }
+}
+
+indexed_binary_aterm_istream::indexed_binary_aterm_istream(std::istream& is)
+  : m_stream(&is)
+{
+  if (read_bytes(is, 1) != 0)
+  {
+    throw mcrl2::runtime_error("Error while reading: missing the BAF_MAGIC control sequence.");
+  }
+
+  std::size_t magic = read_bytes(is, 2);
+  check_indexed_header(magic, read_bytes(is, 2));
+}
+
+indexed_binary_aterm_istream::indexed_binary_aterm_istream(const std::string& filename)
+  : m_file(std::make_unique<memory_mapped_file>(filename))
+{
+  const char* data = m_file->data();
+  const std::size_t size = m_file->size();
+
+  if (size < indexed_header_size + indexed_trailer_size || data[0] != 0)
+  {
+    throw mcrl2::runtime_error("Error while reading: " + filename + " is not an indexed binary aterm file.");
+  }
+  check_indexed_header(read_bytes(data + 1, 2), read_bytes(data + 3, 2));
+
+  // Only the trailer and the section table are read here, the sections themselves are decoded on demand.
+  const char* trailer = data + size - indexed_trailer_size;
+  check_indexed_header(read_bytes(trailer + 16, 2), read_bytes(trailer + 18, 2));
+
+  std::size_t number_of_sections = read_bytes(trailer, 8);
+  std::size_t table_position = read_bytes(trailer + 8, 8);
+  // The checks are written such that a corrupted table cannot cause an overflow.
+  const std::size_t table_end = size - indexed_trailer_size;
+  if (table_position > table_end
+      || number_of_sections > (table_end - table_position) / indexed_section_entry_size
+      || table_position + number_of_sections * indexed_section_entry_size != table_end)
+  {
+    throw mcrl2::runtime_error("Error while reading: the section table of " + filename + " is corrupted.");
+  }
+
+  m_sections.reserve(number_of_sections);
+  for (std::size_t i = 0; i < number_of_sections; ++i)
+  {
+    const char* entry = data + table_position + i * indexed_section_entry_size;
+    indexed_binary_aterm_section section{read_bytes(entry, 8), read_bytes(entry + 8, 8), read_bytes(entry + 16, 8)};
+    if (section.size > table_position || section.offset > table_position - section.size)
+    {
+      throw mcrl2::runtime_error("Error while reading: the section table of " + filename + " is corrupted.");
+    }
+    m_sections.push_back(section);
+  }
+}
+
+void indexed_binary_aterm_istream::get(aterm& t)
+{
+  if (m_decoding_threads > 1)
+  {
+    while (m_decoded.empty())
+    {
+      if (!decode_next_sections())
+      {
+        t = aterm();
+        return;
+      }
+    }
+
+    t = m_decoded.front();
+    m_decoded.pop_front();
+    return;
+  }
+
+  while (true)
+  {
+    if (!m_section && !open_next_section())
+    {
+      t = aterm();
+      return;
+    }
+
+    m_section->set_transformer(m_transformer);
+    m_section->get(t);
+    if (t.defined())
+    {
+      return;
+    }
+
+    // The end of the current section has been reached.
+    m_section.reset();
+    m_section_stream.reset();
+  }
+}
+
+std::size_t indexed_binary_aterm_istream::number_of_sections() const
+{
+  require_random_access("number_of_sections");
+  return m_sections.size();
+}
+
+const indexed_binary_aterm_section& indexed_binary_aterm_istream::section(std::size_t index) const
+{
+  require_random_access("section");
+  return m_sections.at(index);
+}
+
+void indexed_binary_aterm_istream::seek(std::size_t index)
+{
+  require_random_access("seek");
+  if (index > m_sections.size())
+  {
+    throw mcrl2::runtime_error("Cannot seek to section " + std::to_string(index) + " of " + std::to_string(m_sections.size()) + " sections.");
+  }
+
+  m_section.reset();
+  m_section_stream.reset();
+  m_decoded.clear();
+  m_next_section = index;
+}
+
+bool indexed_binary_aterm_istream::next_section(std::string& buffer, const char*& data, std::size_t& size)
+{
+  if (m_file)
+  {
+    if (m_next_section == m_sections.size())
+    {
+      return false;
+    }
+
+    const indexed_binary_aterm_section& section = m_sections[m_next_section++];
+    data = m_file->data() + section.offset;
+    size = section.size;
+    return true;
+  }
+
+  if (m_stream == nullptr)
+  {
+    return false;
+  }
+
+  size = read_bytes(*m_stream, 8);
+  if (size == 0)
+  {
+    // The remainder is the section table, which is not needed to read sequentially.
+    m_stream = nullptr;
+    return false;
+  }
+
+  buffer.resize(size);
+  if (!m_stream->read(buffer.data(), static_cast<std::streamsize>(size)))
+  {
+    throw mcrl2::runtime_error("Error while reading: unexpected end of an indexed binary aterm stream.");
+  }
+  data = buffer.data();
+  return true;
+}
+
+bool indexed_binary_aterm_istream::open_next_section()
+{
+  const char* data = nullptr;
+  std::size_t size = 0;
+  if (!next_section(m_section_buffer, data, size))
+  {
+    return false;
+  }
+
+  m_section_stream = std::make_unique<memory_istream>(data, size);
+  m_section = std::make_unique<binary_aterm_istream>(*m_section_stream);
+  return true;
+}
+
+bool indexed_binary_aterm_istream::decode_next_sections()
+{
+  // Determine the next sections to decode, one for each thread.
+  std::vector<std::string> buffers(m_decoding_threads);
+  std::vector<std::pair<const char*, std::size_t>> sections;
+  for (std::string& buffer : buffers)
+  {
+    const char* data = nullptr;
+    std::size_t size = 0;
+    if (!next_section(buffer, data, size))
+    {
+      break;
+    }
+    sections.emplace_back(data, size);
+  }
+
+  if (sections.empty())
+  {
+    return false;
+  }
+
+  // Terms are protected by the thread_aterm_pool of the thread that holds them. Therefore, every worker keeps
+  // its decoded terms alive until this thread has copied them, after which the workers are released.
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::size_t number_of_finished = 0;
+  bool released = false;
+
+  std::vector<const std::vector<aterm>*> results(sections.size(), nullptr);
+  std::vector<std::exception_ptr> errors(sections.size());
+  aterm_transformer* transformer = m_transformer;
+
+  std::vector<std::thread> workers;
+  workers.reserve(sections.size());
+  for (std::size_t i = 0; i < sections.size(); ++i)
+  {
+    workers.emplace_back([&, i]()
+      {
+        std::vector<aterm> terms;
+        try
+        {
+          memory_istream stream(sections[i].first, sections[i].second);
+          binary_aterm_istream input(stream);
+          input.set_transformer(transformer);
+
+          aterm t;
+          for (input.get(t); t.defined(); input.get(t))
+          {
+            terms.push_back(t);
+          }
+        }
+        catch (...)
+        {
+          errors[i] = std::current_exception();
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        results[i] = &terms;
+        ++number_of_finished;
+        condition.notify_all();
+        condition.wait(lock, [&]() { return released; });
+      });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [&]() { return number_of_finished == sections.size(); });
+
+    // Merge the terms of the sections in their original order.
+    for (const std::vector<aterm>* terms : results)
+    {
+      m_decoded.insert(m_decoded.end(), terms->begin(), terms->end());
+    }
+
+    released = true;
+    condition.notify_all();
+  }
+
+  for (std::thread& worker : workers)
+  {
+    worker.join();
+  }
+
+  for (const std::exception_ptr& error : errors)
+  {
+    if (error)
+    {
+      std::rethrow_exception(error);
+    }
+  }
+
+  return true;
+}
+
+void indexed_binary_aterm_istream::set_decoding_threads(std::size_t number_of_threads)
+{
+  if constexpr (mcrl2::utilities::detail::GlobalThreadSafe)
+  {
+    m_decoding_threads = number_of_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : number_of_threads;
+  }
+  else
+  {
+    mcrl2::utilities::mcrl2_unused(number_of_threads);
+  }
+}
+
+void indexed_binary_aterm_istream::require_random_access(const std::string& operation) const
+{
+  if (!m_file)
+  {
+    throw mcrl2::runtime_error("The operation " + operation + " is only available for indexed binary aterm files that are read from disk.");
+  }
+}
+
+bool is_indexed_binary_aterm_file(const std::string& filename)
+{
+  std::ifstream stream(filename, std::ios::binary);
+  char header[indexed_header_size];
+  if (!stream.read(header, indexed_header_size))
+  {
+    return false;
+  }
+
+  return header[0] == 0 && read_bytes(header + 1, 2) == BAF_MAGIC && read_bytes(header + 3, 2) == BAF_INDEXED_VERSION;
+}
+
 void write_term_to_binary_stream(const aterm& t, std::ostream& os)
 {
   binary_aterm_ostream(os) << t;
@@ -9,6 +9,10 @@
 
 #include "mcrl2/atermpp/aterm_io_binary.h"
 
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
 #define BOOST_AUTO_TEST_MAIN
 #include <boost/test/included/unit_test.hpp>
 
@@ -104,3 +108,124 @@ BOOST_AUTO_TEST_CASE(transitions_test)
     BOOST_CHECK_EQUAL(t, sequence[index]);
   }
 }
+
+BOOST_AUTO_TEST_CASE(indexed_format_test)
+{
+  std::vector<aterm> sequence;
+
+  function_symbol f("f", 2);
+  aterm current = aterm_int(0);
+  for (std::size_t index = 0; index < 100; ++index)
+  {
+    current = aterm(f, current, aterm_int(index));
+    sequence.push_back(current);
+  }
+
+  const std::string filename = "indexed_format_test.baf";
+  {
+    std::ofstream file(filename, std::ios::binary);
+    indexed_binary_aterm_ostream output(file, 30);
+
+    for (const auto& term : sequence)
+    {
+      output << term;
+    }
+  }
+
+  BOOST_CHECK(is_indexed_binary_aterm_file(filename));
+
+  {
+    // Read the mapped file sequentially.
+    indexed_binary_aterm_istream input(filename);
+    BOOST_CHECK_EQUAL(input.number_of_sections(), 4);
+    BOOST_CHECK_EQUAL(input.section(3).number_of_terms, 10);
+
+    for (const auto& expected : sequence)
+    {
+      aterm t;
+      input.get(t);
+      BOOST_CHECK_EQUAL(t, expected);
+    }
+
+    aterm end;
+    input.get(end);
+    BOOST_CHECK(!end.defined());
+
+    // Jump directly to a section in the middle of the file.
+    input.seek(2);
+    aterm t;
+    input.get(t);
+    BOOST_CHECK_EQUAL(t, sequence[60]);
+  }
+
+  {
+    // Read the same file through a stream that does not provide random access.
+    std::ifstream file(filename, std::ios::binary);
+    indexed_binary_aterm_istream input(file);
+
+    for (const auto& expected : sequence)
+    {
+      aterm t;
+      input.get(t);
+      BOOST_CHECK_EQUAL(t, expected);
+    }
+
+    aterm end;
+    input.get(end);
+    BOOST_CHECK(!end.defined());
+  }
+
+  {
+    // Corrupt the first entry of the section table, such that offset + size of the section overflows.
+    std::fstream file(filename, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-20 - 4 * 24, std::ios::end);
+    for (std::size_t value : { std::numeric_limits<std::size_t>::max() - 7, std::size_t(16) })
+    {
+      for (std::size_t i = 8; i > 0; --i)
+      {
+        file.put(static_cast<char>((value >> (8 * (i - 1))) & 0xff));
+      }
+    }
+  }
+  BOOST_CHECK_THROW(indexed_binary_aterm_istream input(filename), mcrl2::runtime_error);
+
+  std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(indexed_format_parallel_test)
+{
+  std::vector<aterm> sequence;
+
+  function_symbol f("f", 2);
+  aterm current = aterm_int(0);
+  for (std::size_t index = 0; index < 1000; ++index)
+  {
+    current = aterm(f, current, aterm_int(index % 10));
+    sequence.push_back(current);
+  }
+
+  std::stringstream stream;
+  {
+    indexed_binary_aterm_ostream output(stream, 64);
+
+    for (const auto& term : sequence)
+    {
+      output << term;
+    }
+  }
+
+  // The sections are decoded on four threads and merged in their original order.
+  indexed_binary_aterm_istream input(stream);
+  input.set_decoding_threads(4);
+
+  for (const auto& expected : sequence)
+  {
+    aterm t;
+    input.get(t);
+    BOOST_CHECK_EQUAL(t, expected);
+  }
+
+  aterm end;
+  input.get(end);
+  BOOST_CHECK(!end.defined());
+}
@@ -14,6 +14,8 @@
 
 #include "mcrl2/atermpp/aterm_io.h"
 #include "mcrl2/atermpp/aterm_string.h"
+#include "mcrl2/atermpp/standard_containers/vector.h"
+#include "mcrl2/atermpp/detail/global_aterm_pool.h"
 
 using namespace atermpp;
 
@@ -78,3 +80,46 @@ BOOST_AUTO_TEST_CASE(test_several_aterm_io)
   test_aterm_io("[a,b,[]]");
   test_aterm_io("f([a,f(x),[]],2,[g,g(34566)])"); 
 }
+
+BOOST_AUTO_TEST_CASE(test_generational_garbage_collection)
+{
+  detail::g_term_pool().enable_generational_garbage_collection(true);
+
+  // Create an old generation, the first collection is a full one.
+  const function_symbol f("f", 2);
+  atermpp::vector<aterm> old_terms;
+  for (std::size_t i = 0; i < 10000; ++i)
+  {
+    old_terms.push_back(aterm(f, aterm_int(i), aterm_int(i + 1)));
+  }
+  detail::g_thread_term_pool().collect();
+
+  // Young terms that are reachable, which refer to old terms.
+  aterm chain = old_terms[0];
+  for (std::size_t i = 1; i < 100; ++i)
+  {
+    chain = aterm(f, chain, old_terms[i]);
+  }
+  const std::size_t size_with_chain = detail::g_term_pool().size();
+
+  // Young terms that are not reachable.
+  for (std::size_t i = 0; i < 100; ++i)
+  {
+    aterm garbage(f, old_terms[i], aterm_int(i));
+  }
+  BOOST_CHECK(detail::g_term_pool().size() > size_with_chain);
+
+  // Only the young terms are considered, since the pool did not grow much.
+  detail::g_thread_term_pool().collect();
+  BOOST_CHECK(detail::g_term_pool().size() <= size_with_chain);
+
+  for (std::size_t i = 99; i > 0; --i)
+  {
+    BOOST_CHECK(chain[1] == old_terms[i]);
+    aterm argument = chain[0];
+    chain = argument;
+  }
+  BOOST_CHECK(chain == old_terms[0]);
+
+  detail::g_term_pool().enable_generational_garbage_collection(false);
+}
@@ -55,3 +55,45 @@ BOOST_AUTO_TEST_CASE(parallel_vector)
   }
 }
 
+
+BOOST_AUTO_TEST_CASE(parallel_garbage_collection)
+{
+  if constexpr (mcrl2::utilities::detail::GlobalThreadSafe)
+  {
+    // Force marking and sweeping to be divided over multiple threads.
+    atermpp::detail::g_term_pool().set_garbage_collection_threads(4);
+
+    const atermpp::function_symbol f("f", 1);
+    const std::size_t number_of_terms = 2 * atermpp::detail::ParallelGarbageCollectionThreshold;
+
+    // Only the terms with an even value remain reachable.
+    atermpp::vector<atermpp::aterm> reachable;
+    {
+      atermpp::vector<atermpp::aterm> unreachable;
+      for (std::size_t i = 0; i < number_of_terms; ++i)
+      {
+        atermpp::aterm term(f, atermpp::aterm_int(i));
+        if (i % 2 == 0)
+        {
+          reachable.push_back(term);
+        }
+        else
+        {
+          unreachable.push_back(term);
+        }
+      }
+    }
+
+    atermpp::detail::g_thread_term_pool().collect();
+
+    for (std::size_t i = 0; i < reachable.size(); ++i)
+    {
+      BOOST_CHECK_EQUAL(atermpp::down_cast<atermpp::aterm_int>(static_cast<const atermpp::aterm&>(reachable[i])[0]).value(), 2 * i);
+    }
+
+    // Both the applications and the integers with an odd value have been removed.
+    BOOST_CHECK(atermpp::detail::g_term_pool().size() < 2 * number_of_terms);
+
+    atermpp::detail::g_term_pool().set_garbage_collection_threads(0);
+  }
+}
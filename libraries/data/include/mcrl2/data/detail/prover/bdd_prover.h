@@ -480,6 +480,7 @@ class BDD_Prover: protected rewriter
       switch (a_rewrite_strategy)
       {
         case(jitty):
+        case(jitty_bytecode):
 #ifdef MCRL2_ENABLE_JITTYC
         case(jitty_compiling):
 #endif
@@ -492,7 +493,7 @@ class BDD_Prover: protected rewriter
         case(jitty_compiling_prover):
 #endif
         {
-          throw mcrl2::runtime_error("The proving rewriters are not supported by the prover (only jitty and jittyc are supported).");
+          throw mcrl2::runtime_error("The proving rewriters are not supported by the prover (only jitty, jittyb and jittyc are supported).");
         }
         default:
         {
@@ -11,6 +11,8 @@
 #define MCRL2_DATA_DETAIL_REWRITE_JITTY_H
 
 #include "mcrl2/data/detail/rewrite.h"
+#include "mcrl2/data/detail/rewrite/normal_form_memo.h"
+#include "mcrl2/data/detail/rewrite/rewrite_profile.h"
 #include "mcrl2/data/detail/rewrite/rewrite_stack.h"
 #include "mcrl2/data/detail/rewrite/strategy_rule.h"
 
@@ -90,6 +92,8 @@ class RewriterJitty: public Rewriter
     class rewrite_stack m_rewrite_stack;     // Stack for intermediate rewrite results.
 
     std::vector<data_expression> rhs_for_constants_cache; // Cache that contains normal forms for constants. 
+    normal_form_memo m_normal_form_memo;                  // Normal forms of closed terms, if enabled.
+    rewrite_profile m_profile;                            // Counts rewrite steps per function symbol and equation, if enabled.
     std::map< function_symbol, data_equation_list > jitty_eqns;
     std::vector<strategy> jitty_strat;
 
@@ -114,6 +118,12 @@ class RewriterJitty: public Rewriter
                       const application& term,
                       substitution_type& sigma);
 
+    void rewrite_aux_function_symbol_memoised(
+                      data_expression& result,
+                      const function_symbol& op,
+                      const application& term,
+                      substitution_type& sigma);
+
     void rewrite_aux_const_function_symbol(
                       data_expression& result,
                       const function_symbol& op,
@@ -0,0 +1,170 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/jittyb.h
+/// \brief A jitty rewriter that executes its strategies as bytecode. The
+///        strategies of the jitty rewriter are translated to a compact sequence
+///        of instructions when the rewriter is constructed. This is done in
+///        process, so unlike the compiling rewriter no C++ compiler is needed, and
+///        construction of the rewriter only takes milliseconds.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_JITTYB_H
+#define MCRL2_DATA_DETAIL_REWRITE_JITTYB_H
+
+#include <cstdint>
+#include "mcrl2/data/detail/rewrite/jitty.h"
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+/// \brief The instructions of the bytecode executed by the rewriter jittyb.
+/// \details There are three kinds of programs. A strategy program describes for a function symbol in
+///          which order arguments are rewritten and rewrite rules are tried. A match program matches the
+///          arguments of a term against the left hand side of a rewrite rule, storing the subterms under
+///          inspection in registers, and binding the variables of the rule to variable slots. A build
+///          program instantiates a condition or a right hand side of a rule using a stack.
+enum class jittyb_opcode: std::uint8_t
+{
+  // Strategy instructions.
+  rewrite_argument,   ///< Rewrite argument a to normal form, or stop if the term has no argument a.
+  try_rule,           ///< Try rewrite rule m_rules[a].
+  cpp_code,           ///< Apply the function m_cpp_functions[a].
+  stop,               ///< No rule applies; rewrite the remaining arguments.
+
+  // Match instructions.
+  match_term,         ///< Register a must be equal to m_terms[b].
+  match_application,  ///< Register a must be an application with b arguments; store the head in register c and the arguments in c+1,...,c+b.
+  bind_variable,      ///< Bind the variable slot b to register a.
+  compare_variable,   ///< Register a must be equal to the term bound to variable slot b.
+  match_done,         ///< The match succeeded.
+
+  // Build instructions.
+  push_term,          ///< Push m_terms[a].
+  push_variable,      ///< Push the term bound to variable slot a.
+  apply,              ///< Apply the term on the stack a positions below the top to the a terms above it.
+  substitute,         ///< Push m_terms[a] after substituting the variables m_variables[b],...,m_variables[b+c-1].
+  build_done          ///< The term is complete and on top of the stack.
+};
+
+struct jittyb_instruction
+{
+  jittyb_opcode op;
+  std::uint32_t a;
+  std::uint32_t b;
+  std::uint32_t c;
+
+  jittyb_instruction(jittyb_opcode op_, std::size_t a_=0, std::size_t b_=0, std::size_t c_=0)
+   : op(op_),
+     a(static_cast<std::uint32_t>(a_)),
+     b(static_cast<std::uint32_t>(b_)),
+     c(static_cast<std::uint32_t>(c_))
+  {}
+};
+
+/// \brief A rewrite rule translated to bytecode.
+struct jittyb_rule
+{
+  static constexpr std::size_t no_condition = std::size_t(-1);
+
+  std::size_t arity;              // The number of arguments of the left hand side.
+  std::size_t match;              // The start of the match program.
+  std::size_t condition;          // The start of the build program of the condition, or no_condition.
+  std::size_t rhs;                // The start of the build program of the right hand side.
+  data_equation equation;         // The equation from which the rule is generated, for profiling.
+};
+
+/// \brief The bytecode of a function symbol, and the amount of memory needed to execute it.
+struct jittyb_function
+{
+  static constexpr std::size_t no_code = std::size_t(-1);
+
+  std::size_t code = no_code;           // The start of the strategy program.
+  std::size_t number_of_arguments = 0;  // The largest number of arguments of a left hand side.
+  std::size_t number_of_registers = 0;
+  std::size_t number_of_variables = 0;
+};
+
+class RewriterJittyBytecode: public RewriterJitty
+{
+  public:
+    friend class jittyb_argument_rewriter;
+
+    typedef Rewriter::substitution_type substitution_type;
+
+    RewriterJittyBytecode(const data_specification& data_spec, const used_data_equation_selector& equation_selector);
+
+    // The copy constructor.
+    RewriterJittyBytecode(const RewriterJittyBytecode& other) = default;
+
+    // The assignment operator.
+    RewriterJittyBytecode& operator=(const RewriterJittyBytecode& other) = delete;
+
+    virtual ~RewriterJittyBytecode();
+
+    rewrite_strategy getStrategy();
+
+    data_expression rewrite(const data_expression& term, substitution_type& sigma);
+
+    void rewrite(data_expression& result, const data_expression& term, substitution_type& sigma);
+
+    std::shared_ptr<detail::Rewriter> clone()
+    {
+      return std::shared_ptr<Rewriter>(new RewriterJittyBytecode(*this));
+    }
+
+  protected:
+    std::vector<jittyb_instruction> m_code;
+    std::vector<jittyb_rule> m_rules;
+    std::vector<jittyb_function> m_functions;   // Indexed by the index of a function symbol.
+    std::vector<data_expression> m_terms;       // Terms referred to by the bytecode.
+    std::vector<variable> m_variables;          // The variables of the rules, in the order of their slots.
+    std::vector<std::function<void(data_expression&, const data_expression&)> > m_cpp_functions;
+
+    void compile_strategies();
+    std::size_t compile_strategy(const strategy& strat, jittyb_function& f);
+    std::size_t compile_rule(const data_equation& eq, jittyb_function& f);
+    void compile_pattern(const data_expression& p,
+                         std::size_t target,
+                         std::map<variable, std::size_t>& slots,
+                         std::size_t& number_of_registers);
+    void compile_term(const data_expression& t, const std::map<variable, std::size_t>& slots, std::size_t first_variable);
+    std::size_t add_term(const data_expression& t);
+
+    bool match(std::size_t pc,
+               const data_expression** registers,
+               const data_expression** variables,
+               bool* variable_is_a_normal_form,
+               const bool* rewritten_defined,
+               std::size_t number_of_arguments);
+    void build(std::size_t pc, const data_expression** variables, const bool* variable_is_a_normal_form);
+
+    void rewrite_aux(data_expression& result, const data_expression& term, substitution_type& sigma);
+
+    void rewrite_aux_function_symbol(
+                      data_expression& result,
+                      const function_symbol& op,
+                      const application& term,
+                      substitution_type& sigma);
+
+    void apply_cpp_code_to_higher_order_term(
+                      data_expression& result,
+                      const function_symbol& op,
+                      const std::function<void(data_expression&, const data_expression&)>& rewrite_cpp_code,
+                      std::size_t arity,
+                      substitution_type& sigma);
+};
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_JITTYB_H
@@ -38,11 +38,27 @@ typedef std::vector < sort_expression_list> sort_list_vector;
 ///        are inserted in it. By keeping the cache on the stack, the normal forms
 ///        in it will not be freed by the ATerm library, and can therefore be used
 ///        in the generated jittyc code.
+/// \details The generated code refers to the terms by their index in the tables
+///          jittyc_terms and jittyc_addresses, which are filled when the code is
+///          loaded. Hence the code does not depend on the addresses of the terms in
+///          the process that generated it, and the compiled code can be reused.
 ///
 class normal_form_cache
 {
   private:
-    std::set<data_expression> m_lookup;
+    std::map<data_expression, std::size_t> m_lookup;
+    std::vector<const data_expression*> m_terms;
+
+    std::size_t index(const data_expression& t)
+    {
+      const auto [i, inserted] = m_lookup.emplace(t, m_terms.size());
+      if (inserted)
+      {
+        m_terms.push_back(&i->first);
+      }
+      return i->second;
+    }
+
   public:
     normal_form_cache()
     { 
@@ -64,10 +80,26 @@ class normal_form_cache
   ///
   std::string insert(const data_expression& t)
   {
-    std::stringstream ss;
-    const data_expression* cached_term = &*(m_lookup.insert(t).first);
-    ss << "*reinterpret_cast<const data_expression*>(" << (void*)(cached_term) << ")";
-    return ss.str();
+    return "(*jittyc_terms[" + std::to_string(index(t)) + "])";
+  }
+
+  /// \brief Stores t in the cache.
+  /// \return A C++ expression that evaluates to uint_address(t).
+  std::string address(const data_expression& t)
+  {
+    return "jittyc_addresses[" + std::to_string(index(t)) + "]";
+  }
+
+  /// \return The number of terms in the cache.
+  std::size_t size() const
+  {
+    return m_terms.size();
+  }
+
+  /// \return The term with the given index.
+  const data_expression& operator[](std::size_t i) const
+  {
+    return *m_terms[i];
   }
 
   /// \brief Checks whether the cache is empty.
@@ -237,6 +269,25 @@ class RewriterCompilingJitty: public Rewriter
     // The following vector is to store normal forms of constants, indexed by the sequence number in a constant. 
     std::vector<data_expression> normal_forms_for_constants;
 
+    // Normal forms of closed terms, if enabled.
+    normal_form_memo m_normal_form_memo;
+
+    // Counts the calls of the generated functions per function symbol, if profiling was enabled
+    // when the code was generated.
+    rewrite_profile m_profile;
+
+    // The term with the given index in the cache of terms to which the generated code refers.
+    const data_expression& generated_term(std::size_t i) const
+    {
+      return (*m_nf_cache)[i];
+    }
+
+    // The number of terms to which the generated code refers.
+    std::size_t number_of_generated_terms() const
+    {
+      return m_nf_cache->size();
+    }
+
     // Standard assignment operator.
     RewriterCompilingJitty& operator=(const RewriterCompilingJitty& other)=delete;
 
@@ -55,7 +55,7 @@ static void local_rewrite(data_expression& result, const data_expression& t)
 //
 // Forward declarations
 //
-static void set_the_precompiled_rewrite_functions_in_a_lookup_table(RewriterCompilingJitty* this_rewriter);
+static bool set_the_precompiled_rewrite_functions_in_a_lookup_table(RewriterCompilingJitty* this_rewriter);
 
 template <bool ARGUMENTS_IN_NORMAL_FORM>
 static void rewrite_aux(data_expression& result, const data_expression& t, RewriterCompilingJitty* this_rewriter);
@@ -251,6 +251,22 @@ void rewrite_abstraction_aux(data_expression& result, const abstraction& head, c
 }
 
 
+// Rewrite t with f using the normal form memo table of the rewriter. The term is copied, as result
+// and t may be the same object.
+static inline
+void rewrite_memoised(data_expression& result, const application& t, const rewriter_function f, RewriterCompilingJitty* this_rewriter)
+{
+  const data_expression* normal_form = this_rewriter->m_normal_form_memo.find(t);
+  if (normal_form != nullptr)
+  {
+    result = *normal_form;
+    return;
+  }
+  const application t1 = t;
+  f(result, t1, this_rewriter);
+  this_rewriter->m_normal_form_memo.insert(t1, result);
+}
+
 static inline
 void rewrite_appl_aux(data_expression& result, const application& t, RewriterCompilingJitty* this_rewriter)
 {
@@ -357,6 +373,11 @@ void rewrite_aux(data_expression& result, const data_expression& t, RewriterComp
       const rewriter_function f = get_precompiled_rewrite_function<ARGUMENTS_IN_NORMAL_FORM>(down_cast<function_symbol>(head), appl_size, this_rewriter);
       if (f != nullptr)
       {
+        if (this_rewriter->m_normal_form_memo.enabled())
+        {
+          rewrite_memoised(result, appl, f, this_rewriter);
+          return;
+        }
         f(result, appl,this_rewriter);
         assert(result.sort()==t.sort());
         return;
@@ -420,9 +441,14 @@ bool init(rewriter_interface* i, RewriterCompilingJitty* this_rewriter)
     return false;
   }
 
+  if (!set_the_precompiled_rewrite_functions_in_a_lookup_table(this_rewriter))
+  {
+    i->status = "the tables of the rewriter do not match the compiled rewriter.";
+    return false;
+  }
+
   i->rewrite_external = &rewrite;
   i->rewrite_cleanup = &rewrite_cleanup;
-  set_the_precompiled_rewrite_functions_in_a_lookup_table(this_rewriter);
   i->status = "rewriter loaded successfully.";
   return true;
 }
@@ -0,0 +1,154 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/normal_form_memo.h
+/// \brief A bounded table with normal forms of closed terms, used by the jitty rewriters.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_NORMAL_FORM_MEMO_H
+#define MCRL2_DATA_DETAIL_REWRITE_NORMAL_FORM_MEMO_H
+
+#include "mcrl2/atermpp/standard_containers/unordered_map.h"
+#include "mcrl2/data/detail/rewrite_statistics.h"
+#include "mcrl2/data/application.h"
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+namespace detail
+{
+
+// Stores the maximal number of normal forms that a rewriter stores in its normal form memo table.
+template <class T> // note, T is only a dummy
+struct normal_form_memo_size
+{
+  static std::size_t max_normal_form_memo_size;
+};
+
+// Initialization. By default no normal forms are stored.
+template <class T>
+std::size_t normal_form_memo_size<T>::max_normal_form_memo_size = 0;
+
+inline
+void set_normal_form_memo_size(std::size_t size)
+{
+  normal_form_memo_size<std::size_t>::max_normal_form_memo_size = size;
+}
+
+inline
+std::size_t get_normal_form_memo_size()
+{
+  return normal_form_memo_size<std::size_t>::max_normal_form_memo_size;
+}
+
+/// \brief A table that maps closed terms to their normal forms.
+/// \details Only terms without variables, binders and where clauses are stored, as the normal form
+///          of such a term does not depend on the substitution with which it is rewritten. The terms
+///          are maximally shared, so a term is found by its address. The table keeps the terms in it
+///          alive, so an address cannot be reused by another term while it is in the table. When the
+///          table is full it is cleared, and a new generation of terms is collected.
+///          Each rewriter has its own table, so no locking is needed. A copy of a table is empty.
+class normal_form_memo
+{
+  protected:
+    atermpp::unordered_map<data_expression, data_expression> m_table;
+    std::size_t m_capacity;
+    std::size_t m_hits = 0;
+    std::size_t m_lookups = 0;
+    std::vector<const data_expression*> m_todo; // Used to check whether a term is closed.
+
+    // Checks whether t only consists of function symbols, machine numbers and applications.
+    bool is_closed(const data_expression& t)
+    {
+      m_todo.clear();
+      m_todo.push_back(&t);
+      while (!m_todo.empty())
+      {
+        const data_expression& u = *m_todo.back();
+        m_todo.pop_back();
+        if (is_application(u))
+        {
+          const application& ua = atermpp::down_cast<application>(u);
+          m_todo.push_back(&ua.head());
+          for (const data_expression& arg: ua)
+          {
+            m_todo.push_back(&arg);
+          }
+        }
+        else if (!is_function_symbol(u) && !is_machine_number(u))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  public:
+    explicit normal_form_memo(std::size_t capacity = get_normal_form_memo_size())
+      : m_capacity(capacity)
+    {}
+
+    normal_form_memo(const normal_form_memo& other)
+      : m_capacity(other.m_capacity)
+    {}
+
+    normal_form_memo& operator=(const normal_form_memo& other) = delete;
+
+    ~normal_form_memo()
+    {
+      if (m_lookups > 0)
+      {
+        register_normal_form_memo_statistics(m_hits, m_lookups);
+        mCRL2log(log::verbose) << "The normal form memo table of the rewriter was used " << m_lookups << " times, with a hit rate of "
+                               << (100 * m_hits) / m_lookups << "%.\n";
+      }
+    }
+
+    /// \brief Returns true if normal forms are stored.
+    bool enabled() const
+    {
+      return m_capacity > 0;
+    }
+
+    /// \brief Returns the normal form of t if it is in the table, and nullptr otherwise.
+    const data_expression* find(const data_expression& t)
+    {
+      ++m_lookups;
+      const auto i = m_table.find(t);
+      if (i == m_table.end())
+      {
+        return nullptr;
+      }
+      ++m_hits;
+      return &static_cast<const data_expression&>(i->second);
+    }
+
+    /// \brief Stores normal_form as the normal form of t, provided that t is closed.
+    void insert(const data_expression& t, const data_expression& normal_form)
+    {
+      if (!is_closed(t))
+      {
+        return;
+      }
+      if (m_table.size() >= m_capacity)
+      {
+        m_table.clear();
+      }
+      m_table.emplace(t, normal_form);
+    }
+};
+
+} // namespace detail
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_NORMAL_FORM_MEMO_H
@@ -0,0 +1,205 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/data/detail/rewrite/rewrite_profile.h
+/// \brief The profile of a single rewriter, which attributes rewrite steps and time to
+///        head function symbols and equations.
+
+#ifndef MCRL2_DATA_DETAIL_REWRITE_REWRITE_PROFILE_H
+#define MCRL2_DATA_DETAIL_REWRITE_REWRITE_PROFILE_H
+
+#include <unordered_map>
+#include "mcrl2/data/data_equation.h"
+#include "mcrl2/data/detail/rewrite_statistics.h"
+
+namespace mcrl2
+{
+
+namespace data
+{
+
+namespace detail
+{
+
+/// \brief Counts the rewrite steps per head function symbol and per equation of a rewriter.
+/// \details Terms and equations are identified by their address, and are only printed the first
+///          time they are encountered. The rewriter must keep its equations alive. A function symbol
+///          is identified by its index, and the address is used to detect that the index has been
+///          reused. At destruction the profile is added to the global profile in rewrite_statistics.h.
+///          Each rewriter has its own profile, so no locking is needed. A copy of a profile is empty.
+class rewrite_profile
+{
+  protected:
+    struct named_entry
+    {
+      std::string name;
+      const atermpp::detail::_aterm* address = nullptr;
+      std::size_t active = 0;   // The number of calls on the stack, to count recursive calls once in the total time.
+      rewrite_profile_entry counters;
+    };
+
+    struct frame
+    {
+      named_entry* entry;
+      std::chrono::steady_clock::time_point start;
+      std::chrono::nanoseconds nested;
+    };
+
+    bool m_enabled;
+    std::unordered_map<std::size_t, named_entry> m_function_symbols;
+    std::unordered_map<const atermpp::detail::_aterm*, named_entry> m_equations;
+    std::vector<frame> m_stack;
+
+    void flush(const std::string& kind, const named_entry& e)
+    {
+      if (e.counters.calls > 0 || e.counters.match_attempts > 0)
+      {
+        register_rewrite_profile_entry(kind, e.name, e.counters);
+      }
+    }
+
+    named_entry& entry(const function_symbol& f)
+    {
+      named_entry& e = m_function_symbols[atermpp::detail::index_traits<function_symbol, function_symbol_key_type, 2>::index(f)];
+      if (e.address != atermpp::detail::address(f))
+      {
+        // The index of a function symbol that no longer exists has been reused.
+        assert(e.active == 0);
+        flush("function symbol", e);
+        e.counters = rewrite_profile_entry();
+        e.address = atermpp::detail::address(f);
+        e.name = data::pp(f) + ": " + data::pp(f.sort());
+      }
+      return e;
+    }
+
+    named_entry& entry(const data_equation& eq)
+    {
+      named_entry& e = m_equations[atermpp::detail::address(eq)];
+      if (e.address == nullptr)
+      {
+        e.address = atermpp::detail::address(eq);
+        e.name = data::pp(eq);
+      }
+      return e;
+    }
+
+  public:
+    explicit rewrite_profile(bool enabled = rewrite_profiling_enabled())
+      : m_enabled(enabled)
+    {}
+
+    rewrite_profile(const rewrite_profile& other)
+      : m_enabled(other.m_enabled)
+    {}
+
+    rewrite_profile& operator=(const rewrite_profile& other) = delete;
+
+    ~rewrite_profile()
+    {
+      for (const auto& p: m_function_symbols)
+      {
+        flush("function symbol", p.second);
+      }
+      for (const auto& p: m_equations)
+      {
+        flush("equation", p.second);
+      }
+    }
+
+    /// \brief Returns true if rewrite steps are counted.
+    bool enabled() const
+    {
+      return m_enabled;
+    }
+
+    /// \brief Start a rewrite step with head symbol f, or with the right hand side of eq.
+    template <typename Term>
+    void enter(const Term& t)
+    {
+      named_entry& e = entry(t);
+      e.counters.calls++;
+      e.active++;
+      m_stack.push_back(frame{&e, std::chrono::steady_clock::now(), std::chrono::nanoseconds(0)});
+    }
+
+    /// \brief Finish the innermost rewrite step that has been started.
+    void leave()
+    {
+      assert(!m_stack.empty());
+      const frame f = m_stack.back();
+      m_stack.pop_back();
+      const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - f.start;
+      f.entry->counters.self_time += elapsed - f.nested;
+      if (--f.entry->active == 0)
+      {
+        f.entry->counters.total_time += elapsed;
+      }
+      if (!m_stack.empty())
+      {
+        m_stack.back().nested += elapsed;
+      }
+    }
+
+    void match_attempt(const data_equation& eq, bool matches)
+    {
+      named_entry& e = entry(eq);
+      e.counters.match_attempts++;
+      if (!matches)
+      {
+        e.counters.match_failures++;
+      }
+    }
+
+    void condition_failure(const data_equation& eq)
+    {
+      entry(eq).counters.condition_failures++;
+    }
+
+    void application(const data_equation& eq)
+    {
+      entry(eq).counters.applications++;
+    }
+
+    /// \brief Measures a rewrite step from construction to destruction, if profiling is enabled.
+    class scope
+    {
+      protected:
+        rewrite_profile* m_profile;
+
+      public:
+        template <typename Term>
+        scope(rewrite_profile& profile, const Term& t)
+          : m_profile(profile.enabled() ? &profile : nullptr)
+        {
+          if (m_profile != nullptr)
+          {
+            m_profile->enter(t);
+          }
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+        ~scope()
+        {
+          if (m_profile != nullptr)
+          {
+            m_profile->leave();
+          }
+        }
+    };
+};
+
+} // namespace detail
+
+} // namespace data
+
+} // namespace mcrl2
+
+#endif // MCRL2_DATA_DETAIL_REWRITE_REWRITE_PROFILE_H
@@ -12,6 +12,16 @@
 #ifndef MCRL2_DATA_DETAIL_REWRITE_STATISTICS_H
 #define MCRL2_DATA_DETAIL_REWRITE_STATISTICS_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <vector>
 #include "mcrl2/utilities/logger.h"
 
 namespace mcrl2
@@ -23,15 +33,182 @@ namespace data
 namespace detail
 {
 
+/// \brief The counters that the profiling mode of the rewriters keeps for a head function symbol or an equation.
+/// \details For a function symbol, calls is the number of rewrite steps on terms with this head symbol. For
+///          an equation, calls is the number of times its left hand side matched, and match_attempts,
+///          match_failures, condition_failures and applications count how often it was tried. The self time
+///          excludes the time of nested calls, and the total time includes it, where recursive calls are only
+///          counted once.
+struct rewrite_profile_entry
+{
+  std::size_t calls = 0;
+  std::size_t match_attempts = 0;
+  std::size_t match_failures = 0;
+  std::size_t condition_failures = 0;
+  std::size_t applications = 0;
+  std::chrono::nanoseconds self_time{0};
+  std::chrono::nanoseconds total_time{0};
+
+  rewrite_profile_entry& operator+=(const rewrite_profile_entry& other)
+  {
+    calls += other.calls;
+    match_attempts += other.match_attempts;
+    match_failures += other.match_failures;
+    condition_failures += other.condition_failures;
+    applications += other.applications;
+    self_time += other.self_time;
+    total_time += other.total_time;
+    return *this;
+  }
+};
+
+/// \brief The combined profiles of all rewriters that have been destroyed, indexed by kind and name.
+///        If a file name is set, the profile is written to this file at exit.
+class rewrite_profile_store
+{
+  protected:
+    std::mutex m_mutex;
+    std::string m_filename;
+    std::map<std::pair<std::string, std::string>, rewrite_profile_entry> m_entries;
+
+    static std::string json_string(const std::string& s)
+    {
+      std::ostringstream out;
+      out << '"';
+      for (const char c: s)
+      {
+        if (c == '"' || c == '\\')
+        {
+          out << '\\' << c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        }
+        else
+        {
+          out << c;
+        }
+      }
+      out << '"';
+      return out.str();
+    }
+
+    static std::string single_line(std::string s)
+    {
+      std::replace_if(s.begin(), s.end(), [](char c) { return c == '\n' || c == '\t'; }, ' ');
+      return s;
+    }
+
+  public:
+    ~rewrite_profile_store()
+    {
+      if (!m_filename.empty())
+      {
+        std::ofstream out(m_filename);
+        const std::string extension = ".json";
+        write(out, m_filename.size() >= extension.size() &&
+                   m_filename.compare(m_filename.size() - extension.size(), extension.size(), extension) == 0);
+        if (!out)
+        {
+          std::cerr << "Could not write the rewriter profile to " << m_filename << ".\n";
+        }
+      }
+    }
+
+    void set_filename(const std::string& filename)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_filename = filename;
+    }
+
+    const std::string& filename() const
+    {
+      return m_filename;
+    }
+
+    void add(const std::string& kind, const std::string& name, const rewrite_profile_entry& entry)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_entries[std::make_pair(kind, name)] += entry;
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_entries.clear();
+    }
+
+    /// \brief Writes the profile sorted on decreasing self time, as a tab separated table or as json.
+    void write(std::ostream& out, bool json)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      std::vector<const std::pair<const std::pair<std::string, std::string>, rewrite_profile_entry>*> entries;
+      for (const auto& p: m_entries)
+      {
+        entries.push_back(&p);
+      }
+      std::stable_sort(entries.begin(), entries.end(), [](const auto* x, const auto* y) { return x->second.self_time > y->second.self_time; });
+
+      auto seconds = [](std::chrono::nanoseconds t) { return std::chrono::duration<double>(t).count(); };
+      if (json)
+      {
+        out << "[";
+        for (std::size_t i = 0; i < entries.size(); ++i)
+        {
+          const rewrite_profile_entry& e = entries[i]->second;
+          out << (i == 0 ? "\n" : ",\n")
+              << "  {\"kind\":" << json_string(entries[i]->first.first)
+              << ",\"name\":" << json_string(entries[i]->first.second)
+              << ",\"calls\":" << e.calls
+              << ",\"match_attempts\":" << e.match_attempts
+              << ",\"match_failures\":" << e.match_failures
+              << ",\"condition_failures\":" << e.condition_failures
+              << ",\"applications\":" << e.applications
+              << ",\"self_time\":" << seconds(e.self_time)
+              << ",\"total_time\":" << seconds(e.total_time) << "}";
+        }
+        out << "\n]\n";
+      }
+      else
+      {
+        out << "kind\tcalls\tmatch attempts\tmatch failures\tcondition failures\tapplications\tself time (s)\ttotal time (s)\tname\n";
+        for (const auto* p: entries)
+        {
+          const rewrite_profile_entry& e = p->second;
+          out << p->first.first << "\t" << e.calls << "\t" << e.match_attempts << "\t" << e.match_failures << "\t"
+              << e.condition_failures << "\t" << e.applications << "\t" << seconds(e.self_time) << "\t"
+              << seconds(e.total_time) << "\t" << single_line(p->first.second) << "\n";
+        }
+      }
+    }
+};
+
 template <class T> // note, T is only a dummy
 struct rewrite_statistics
 {
   static std::size_t rewrite_count;
+
+  // The lookups in, and hits of, the normal form memo tables of all rewriters that have been destroyed.
+  static std::atomic<std::size_t> normal_form_memo_lookups;
+  static std::atomic<std::size_t> normal_form_memo_hits;
+
+  // The profiles of all rewriters that have been destroyed.
+  static rewrite_profile_store profile;
 };
 
 template <class T>
 std::size_t rewrite_statistics<T>::rewrite_count = 0;
 
+template <class T>
+std::atomic<std::size_t> rewrite_statistics<T>::normal_form_memo_lookups(0);
+
+template <class T>
+std::atomic<std::size_t> rewrite_statistics<T>::normal_form_memo_hits(0);
+
+template <class T>
+rewrite_profile_store rewrite_statistics<T>::profile;
+
 inline
 std::size_t rewrite_count()
 {
@@ -54,6 +231,67 @@ void increment_rewrite_count()
   }
 }
 
+inline
+void register_normal_form_memo_statistics(std::size_t hits, std::size_t lookups)
+{
+  rewrite_statistics<int>::normal_form_memo_hits += hits;
+  rewrite_statistics<int>::normal_form_memo_lookups += lookups;
+}
+
+inline
+std::size_t normal_form_memo_lookups()
+{
+  return rewrite_statistics<int>::normal_form_memo_lookups;
+}
+
+inline
+std::size_t normal_form_memo_hits()
+{
+  return rewrite_statistics<int>::normal_form_memo_hits;
+}
+
+/// \brief The fraction of the lookups in normal form memo tables that were successful.
+inline
+double normal_form_memo_hit_rate()
+{
+  const std::size_t lookups = normal_form_memo_lookups();
+  return lookups == 0 ? 0.0 : static_cast<double>(normal_form_memo_hits()) / lookups;
+}
+
+/// \brief Enables the profiling mode of rewriters that are created from now on. At exit, the
+///        profile is written to filename, as json if filename ends in .json and as a tab separated
+///        table otherwise. Profiling is disabled if filename is empty.
+inline
+void set_rewrite_profile_filename(const std::string& filename)
+{
+  rewrite_statistics<int>::profile.set_filename(filename);
+}
+
+inline
+bool rewrite_profiling_enabled()
+{
+  return !rewrite_statistics<int>::profile.filename().empty();
+}
+
+inline
+void register_rewrite_profile_entry(const std::string& kind, const std::string& name, const rewrite_profile_entry& entry)
+{
+  rewrite_statistics<int>::profile.add(kind, name, entry);
+}
+
+/// \brief Writes the combined profile of all rewriters that have been destroyed to out.
+inline
+void write_rewrite_profile(std::ostream& out, bool json = false)
+{
+  rewrite_statistics<int>::profile.write(out, json);
+}
+
+inline
+void clear_rewrite_profile()
+{
+  rewrite_statistics<int>::profile.clear();
+}
+
 } // namespace detail
 
 } // namespace data
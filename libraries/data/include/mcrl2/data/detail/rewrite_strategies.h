@@ -33,6 +33,7 @@ std::vector<data::rewrite_strategy> initialise_test_rewrite_strategies(const boo
 {
   std::vector<data::rewrite_strategy> result;
   result.push_back(data::jitty);
+  result.push_back(data::jitty_bytecode);
   if (with_prover)
   {
     result.push_back(data::jitty_prover);
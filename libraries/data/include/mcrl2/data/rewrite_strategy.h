@@ -13,6 +13,7 @@ namespace data
 enum rewrite_strategy
 {
   jitty,                      /** \brief JITty */
+  jitty_bytecode,             /** \brief JITty executed as bytecode */
 #ifdef MCRL2_ENABLE_JITTYC
   jitty_compiling,            /** \brief Compiling JITty */
   jitty_prover,               /** \brief JITty + Prover */
@@ -28,6 +29,8 @@ rewrite_strategy parse_rewrite_strategy(const std::string& s)
 {
   if(s == "jitty")
     return jitty;
+  else if (s == "jittyb")
+    return jitty_bytecode;
   else if (s == "jittyp")
     return jitty_prover;
 
@@ -65,6 +68,7 @@ inline std::string pp(const rewrite_strategy s)
   switch (s)
   {
     case jitty: return "jitty";
+    case jitty_bytecode: return "jittyb";
 #ifdef MCRL2_ENABLE_JITTYC
     case jitty_compiling: return "jittyc";
 #endif
@@ -89,6 +93,7 @@ inline std::string description(const rewrite_strategy s)
   switch (s)
   {
     case jitty: return "jitty rewriting";
+    case jitty_bytecode: return "jitty rewriting using bytecode";
 #ifdef MCRL2_ENABLE_JITTYC
     case jitty_compiling: return "compiled jitty rewriting";
 #endif
@@ -13,6 +13,8 @@
 #define MCRL2_DATA_REWRITER_TOOL_H
 
 #include "mcrl2/data/detail/enumerator_iteration_limit.h"
+#include "mcrl2/data/detail/rewrite/normal_form_memo.h"
+#include "mcrl2/data/detail/rewrite_statistics.h"
 #include "mcrl2/data/rewriter.h"
 #include "mcrl2/utilities/command_line_interface.h"
 
@@ -43,6 +45,7 @@ class rewriter_tool: public Tool
 
       utilities::interface_description::enum_argument<data::rewrite_strategy> rewriter_option("NAME");
       rewriter_option.add_value(data::jitty, true);
+      rewriter_option.add_value(data::jitty_bytecode);
 #ifdef MCRL2_ENABLE_JITTYC
       rewriter_option.add_value(data::jitty_compiling);
 #endif
@@ -65,6 +68,21 @@ class rewriter_tool: public Tool
         'Q'
       );
 
+      desc.add_option(
+        "rewriter-memo",
+        utilities::make_mandatory_argument("NUM"),
+        "store the normal forms of at most NUM terms without variables in every rewriter, such that they are not "
+        "rewritten again (default NUM=0, nothing is stored). Only the rewriters jitty, jittyb and jittyc use this option."
+      );
+
+      desc.add_option(
+        "rewriter-profile",
+        utilities::make_file_argument("FILE"),
+        "count the rewrite steps and measure the time per head function symbol and per equation, and write "
+        "this profile to FILE at exit, as json if FILE ends in .json and as a tab separated table sorted on time "
+        "otherwise. The rewriters jitty and jittyb count per function symbol and per equation, and jittyc only per "
+        "function symbol. Profiling slows down rewriting considerably."
+      );
     }
 
     /// \brief Add options to an interface description. Also includes
@@ -93,6 +111,16 @@ class rewriter_tool: public Tool
       {
         data::detail::set_enumerator_iteration_limit(10);
       }
+
+      if (parser.options.count("rewriter-memo"))
+      {
+        data::detail::set_normal_form_memo_size(parser.option_argument_as< std::size_t >("rewriter-memo"));
+      }
+
+      if (parser.options.count("rewriter-profile"))
+      {
+        data::detail::set_rewrite_profile_filename(parser.option_argument("rewriter-profile"));
+      }
     }
 
   public:
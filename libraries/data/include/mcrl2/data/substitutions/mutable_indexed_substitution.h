@@ -112,7 +112,9 @@ public:
         }
         if (m_super.m_variables_in_rhs_set_is_defined)
         {
-          std::set<variable_type> s=find_free_variables(i->second);
+          // The stored value is wrapped in a reference_aterm, which must be converted to an
+          // expression explicitly, as the traverser does not look into the wrapper.
+          std::set<variable_type> s=find_free_variables(static_cast<const expression_type&>(i->second));
           for(const variable& v: s) 
           { 
             // Remove one occurrence of v. 
@@ -244,7 +246,7 @@ public:
     {
       for(const auto& p: m_substitution)
       {
-        std::set<variable_type> s=find_free_variables(p.second);
+        std::set<variable_type> s=find_free_variables(static_cast<const expression_type&>(p.second));
         m_variables_in_rhs.insert(s.begin(),s.end());
       }
       m_variables_in_rhs_set_is_defined=true;
@@ -524,6 +524,11 @@ void RewriterJitty::rewrite_aux(
   
     if (is_function_symbol(head) && head!=this_term_is_in_normal_form())
     {
+      if (m_normal_form_memo.enabled())
+      {
+        rewrite_aux_function_symbol_memoised(result, atermpp::down_cast<function_symbol>(head),terma,sigma);
+        return;
+      }
       // return rewrite_aux_function_symbol(atermpp::down_cast<function_symbol>(head),term,sigma);
       rewrite_aux_function_symbol(result, atermpp::down_cast<function_symbol>(head),terma,sigma);
       return;
@@ -589,6 +594,24 @@ void RewriterJitty::rewrite_aux(
   }
 }
 
+// Rewrite term using the normal form memo table. The term is copied, as result and term may be the same object.
+void RewriterJitty::rewrite_aux_function_symbol_memoised(
+                      data_expression& result,
+                      const function_symbol& op,
+                      const application& term,
+                      substitution_type& sigma)
+{
+  const data_expression* normal_form=m_normal_form_memo.find(term);
+  if (normal_form!=nullptr)
+  {
+    result.assign(*normal_form, *m_thread_aterm_pool);
+    return;
+  }
+  const application t=term;
+  rewrite_aux_function_symbol(result, op, t, sigma);
+  m_normal_form_memo.insert(t, result);
+}
+
 void RewriterJitty::rewrite_aux_function_symbol(
                       data_expression& result, 
                       const function_symbol& op,
@@ -596,6 +619,7 @@ void RewriterJitty::rewrite_aux_function_symbol(
                       substitution_type& sigma)
 {
   assert(is_function_sort(op.sort()));
+  const rewrite_profile::scope profile_scope(m_profile, op);
 
   const std::size_t arity=detail::recursive_number_of_args(term);
   assert(arity>0);
@@ -706,8 +730,13 @@ void RewriterJitty::rewrite_aux_function_symbol(
             break;
           }
         }
+        if (m_profile.enabled())
+        {
+          m_profile.match_attempt(rule1, matches);
+        }
         if (matches)
         {
+          const rewrite_profile::scope rule_profile_scope(m_profile, rule1);
           bool condition_of_this_rule=false;
           if (rule1.condition()==sort_bool::true_())
           { 
@@ -721,9 +750,17 @@ void RewriterJitty::rewrite_aux_function_symbol(
             {
               condition_of_this_rule=true;
             }
+            else if (m_profile.enabled())
+            {
+              m_profile.condition_failure(rule1);
+            }
           }
           if (condition_of_this_rule)
           {
+            if (m_profile.enabled())
+            {
+              m_profile.application(rule1);
+            }
             const data_expression& rhs=rule1.rhs();
 
             if (arity == rule_arity)
@@ -842,6 +879,7 @@ void RewriterJitty::rewrite_aux_const_function_symbol(
     return;
   }
 
+  const rewrite_profile::scope profile_scope(m_profile, op);
   const strategy& strat=jitty_strat[op_value];
 
   for (const strategy_rule& rule : strat.rules())
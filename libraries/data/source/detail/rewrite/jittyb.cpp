@@ -0,0 +1,772 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/data/detail/rewrite/jittyb.h"
+#include "mcrl2/data/detail/rewrite/jitty_jittyc.h"
+
+#include "mcrl2/data/find.h"
+
+#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
+#include "mcrl2/data/detail/rewrite_statistics.h"
+#endif
+
+namespace mcrl2
+{
+namespace data
+{
+namespace detail
+{
+
+class jittyb_argument_rewriter
+{
+  protected:
+    mutable_indexed_substitution<>& m_sigma;
+    RewriterJittyBytecode& m_r;
+  public:
+    jittyb_argument_rewriter(mutable_indexed_substitution<>& sigma, RewriterJittyBytecode& r)
+     : m_sigma(sigma), m_r(r)
+    {}
+
+  void operator()(data_expression& result, const data_expression& t)
+  {
+    m_r.rewrite_aux(result, t, m_sigma);
+  }
+};
+
+RewriterJittyBytecode::RewriterJittyBytecode(
+           const data_specification& data_spec,
+           const mcrl2::data::used_data_equation_selector& equation_selector)
+ : RewriterJitty(data_spec, equation_selector)
+{
+  compile_strategies();
+}
+
+RewriterJittyBytecode::~RewriterJittyBytecode()
+{
+}
+
+void RewriterJittyBytecode::compile_strategies()
+{
+  m_functions.resize(jitty_strat.size());
+  for (std::size_t i=0; i<jitty_strat.size(); ++i)
+  {
+    if (!jitty_strat[i].rules().empty())
+    {
+      m_functions[i].code=compile_strategy(jitty_strat[i], m_functions[i]);
+    }
+  }
+  mCRL2log(log::debug) << "Translated the rewrite strategies to " << m_code.size() << " instructions for "
+                       << m_rules.size() << " rewrite rules.\n";
+}
+
+std::size_t RewriterJittyBytecode::compile_strategy(const strategy& strat, jittyb_function& f)
+{
+  // The arguments of a term occupy the first registers. Subterms of arguments are stored after them.
+  for (const strategy_rule& rule: strat.rules())
+  {
+    if (rule.is_equation())
+    {
+      const data_expression& lhs=rule.equation().lhs();
+      f.number_of_arguments=std::max(f.number_of_arguments, is_function_symbol(lhs)?0:recursive_number_of_args(lhs));
+    }
+  }
+  f.number_of_registers=f.number_of_arguments;
+
+  // The match and build programs of the rules are generated first, such that the
+  // strategy program itself is a consecutive sequence of instructions.
+  std::vector<jittyb_instruction> program;
+  for (const strategy_rule& rule: strat.rules())
+  {
+    if (rule.is_rewrite_index())
+    {
+      program.emplace_back(jittyb_opcode::rewrite_argument, rule.rewrite_index());
+    }
+    else if (rule.is_cpp_code())
+    {
+      program.emplace_back(jittyb_opcode::cpp_code, m_cpp_functions.size());
+      m_cpp_functions.push_back(rule.rewrite_cpp_code());
+    }
+    else
+    {
+      program.emplace_back(jittyb_opcode::try_rule, compile_rule(rule.equation(), f));
+    }
+  }
+  program.emplace_back(jittyb_opcode::stop);
+
+  const std::size_t start=m_code.size();
+  m_code.insert(m_code.end(), program.begin(), program.end());
+  return start;
+}
+
+std::size_t RewriterJittyBytecode::compile_rule(const data_equation& eq, jittyb_function& f)
+{
+  const data_expression& lhs=eq.lhs();
+  jittyb_rule rule;
+  rule.equation=eq;
+  rule.arity=(is_function_symbol(lhs)?0:recursive_number_of_args(lhs));
+
+  std::map<variable, std::size_t> slots;
+  std::size_t number_of_registers=f.number_of_arguments;
+  rule.match=m_code.size();
+  for (std::size_t i=0; i<rule.arity; ++i)
+  {
+    compile_pattern(get_argument_of_higher_order_term(atermpp::down_cast<application>(lhs), i), i, slots, number_of_registers);
+  }
+  m_code.emplace_back(jittyb_opcode::match_done);
+
+  const std::size_t first_variable=m_variables.size();
+  m_variables.resize(first_variable+slots.size());
+  for (const std::pair<const variable, std::size_t>& p: slots)
+  {
+    m_variables[first_variable+p.second]=p.first;
+  }
+
+  rule.condition=jittyb_rule::no_condition;
+  if (eq.condition()!=sort_bool::true_())
+  {
+    rule.condition=m_code.size();
+    compile_term(eq.condition(), slots, first_variable);
+    m_code.emplace_back(jittyb_opcode::build_done);
+  }
+
+  rule.rhs=m_code.size();
+  compile_term(eq.rhs(), slots, first_variable);
+  m_code.emplace_back(jittyb_opcode::build_done);
+
+  f.number_of_registers=std::max(f.number_of_registers, number_of_registers);
+  f.number_of_variables=std::max(f.number_of_variables, slots.size());
+  m_rules.push_back(rule);
+  return m_rules.size()-1;
+}
+
+// Generate code that matches the term in register target with pattern p. The order in which
+// subterms are inspected is the same as in the function match_jitty of the jitty rewriter.
+void RewriterJittyBytecode::compile_pattern(
+                     const data_expression& p,
+                     const std::size_t target,
+                     std::map<variable, std::size_t>& slots,
+                     std::size_t& number_of_registers)
+{
+  if (is_variable(p))
+  {
+    const variable& v=atermpp::down_cast<variable>(p);
+    std::map<variable, std::size_t>::const_iterator i=slots.find(v);
+    if (i==slots.end())
+    {
+      const std::size_t slot=slots.size();
+      slots[v]=slot;
+      m_code.emplace_back(jittyb_opcode::bind_variable, target, slot);
+    }
+    else
+    {
+      m_code.emplace_back(jittyb_opcode::compare_variable, target, i->second);
+    }
+  }
+  else if (is_application(p))
+  {
+    const application& pa=atermpp::down_cast<application>(p);
+    const std::size_t first=number_of_registers;
+    number_of_registers=number_of_registers+pa.size()+1;
+    m_code.emplace_back(jittyb_opcode::match_application, target, pa.size(), first);
+    compile_pattern(pa.head(), first, slots, number_of_registers);
+    for (std::size_t i=0; i<pa.size(); ++i)
+    {
+      compile_pattern(pa[i], first+1+i, slots, number_of_registers);
+    }
+  }
+  else
+  {
+    // Function symbols and machine numbers.
+    m_code.emplace_back(jittyb_opcode::match_term, target, add_term(p));
+  }
+}
+
+// Generate code that pushes t on the rewrite stack where the variables in slots are replaced
+// by the terms to which they are bound. This does the same as subst_values in the jitty rewriter.
+void RewriterJittyBytecode::compile_term(
+                     const data_expression& t,
+                     const std::map<variable, std::size_t>& slots,
+                     const std::size_t first_variable)
+{
+  if (is_variable(t))
+  {
+    std::map<variable, std::size_t>::const_iterator i=slots.find(atermpp::down_cast<variable>(t));
+    if (i==slots.end())
+    {
+      m_code.emplace_back(jittyb_opcode::push_term, add_term(t));
+    }
+    else
+    {
+      m_code.emplace_back(jittyb_opcode::push_variable, i->second);
+    }
+    return;
+  }
+
+  const std::set<variable> free_variables=find_free_variables(t);
+  if (std::none_of(free_variables.begin(), free_variables.end(), [&](const variable& v){ return slots.count(v)>0; }))
+  {
+    // Subterms in which no variable of the rule occurs are not reconstructed.
+    m_code.emplace_back(jittyb_opcode::push_term, add_term(t));
+  }
+  else if (is_application(t))
+  {
+    const application& ta=atermpp::down_cast<application>(t);
+    compile_term(ta.head(), slots, first_variable);
+    for (const data_expression& u: ta)
+    {
+      compile_term(u, slots, first_variable);
+    }
+    m_code.emplace_back(jittyb_opcode::apply, ta.size());
+  }
+  else
+  {
+    // Binders and where clauses may require renaming of bound variables, which is left to subst_values.
+    assert(is_abstraction(t) || is_where_clause(t));
+    m_code.emplace_back(jittyb_opcode::substitute, add_term(t), first_variable, slots.size());
+  }
+}
+
+std::size_t RewriterJittyBytecode::add_term(const data_expression& t)
+{
+  m_terms.push_back(t);
+  return m_terms.size()-1;
+}
+
+bool RewriterJittyBytecode::match(
+                     std::size_t pc,
+                     const data_expression** registers,
+                     const data_expression** variables,
+                     bool* variable_is_a_normal_form,
+                     const bool* rewritten_defined,
+                     const std::size_t number_of_arguments)
+{
+  while (true)
+  {
+    const jittyb_instruction& instruction=m_code[pc++];
+    switch (instruction.op)
+    {
+      case jittyb_opcode::match_term:
+      {
+        if (*registers[instruction.a]!=m_terms[instruction.b])
+        {
+          return false;
+        }
+        break;
+      }
+      case jittyb_opcode::match_application:
+      {
+        // Arguments are only matched against applications if they are in normal form.
+        const data_expression& t=*registers[instruction.a];
+        if (!is_application(t))
+        {
+          return false;
+        }
+        const application& ta=atermpp::down_cast<application>(t);
+        if (ta.size()!=instruction.b)
+        {
+          return false;
+        }
+        registers[instruction.c]=&ta.head();
+        for (std::size_t i=0; i<instruction.b; ++i)
+        {
+          registers[instruction.c+1+i]=&ta[i];
+        }
+        break;
+      }
+      case jittyb_opcode::bind_variable:
+      {
+        variables[instruction.b]=registers[instruction.a];
+        variable_is_a_normal_form[instruction.b]=(instruction.a<number_of_arguments?rewritten_defined[instruction.a]:true);
+        break;
+      }
+      case jittyb_opcode::compare_variable:
+      {
+        if (*registers[instruction.a]!=*variables[instruction.b])
+        {
+          return false;
+        }
+        break;
+      }
+      case jittyb_opcode::match_done:
+      {
+        return true;
+      }
+      default:
+      {
+        assert(false);
+        return false;
+      }
+    }
+  }
+}
+
+void RewriterJittyBytecode::build(
+                     std::size_t pc,
+                     const data_expression** variables,
+                     const bool* variable_is_a_normal_form)
+{
+  while (true)
+  {
+    const jittyb_instruction& instruction=m_code[pc++];
+    switch (instruction.op)
+    {
+      case jittyb_opcode::push_term:
+      {
+        m_rewrite_stack.increase(1);
+        m_rewrite_stack.top().assign(m_terms[instruction.a], *m_thread_aterm_pool);
+        break;
+      }
+      case jittyb_opcode::push_variable:
+      {
+        m_rewrite_stack.increase(1);
+        if (variable_is_a_normal_form[instruction.a])
+        {
+          // Variables that are in normal form get a tag that they are in normal form.
+          make_application(m_rewrite_stack.top(), this_term_is_in_normal_form(), *variables[instruction.a]);
+        }
+        else
+        {
+          m_rewrite_stack.top().assign(*variables[instruction.a], *m_thread_aterm_pool);
+        }
+        break;
+      }
+      case jittyb_opcode::apply:
+      {
+        const std::size_t n=instruction.a;
+        make_application(m_rewrite_stack.element(0,n+1),
+                         m_rewrite_stack.element(0,n+1),
+                         m_rewrite_stack.stack_iterator(1,n+1),
+                         m_rewrite_stack.stack_iterator(1,n+1)+n);
+        m_rewrite_stack.decrease(n);
+        break;
+      }
+      case jittyb_opcode::substitute:
+      {
+        std::vector<jitty_variable_assignment_for_a_rewrite_rule> assignment_vector;
+        assignment_vector.reserve(instruction.c);
+        for (std::size_t i=0; i<instruction.c; ++i)
+        {
+          assignment_vector.emplace_back(m_variables[instruction.b+i], *variables[i], variable_is_a_normal_form[i]);
+        }
+        jitty_assignments_for_a_rewrite_rule assignments(assignment_vector.data());
+        assignments.size=instruction.c;
+        m_rewrite_stack.increase(1);
+        subst_values(m_rewrite_stack.top(), assignments, m_terms[instruction.a], m_generator);
+        break;
+      }
+      case jittyb_opcode::build_done:
+      {
+        return;
+      }
+      default:
+      {
+        assert(false);
+        return;
+      }
+    }
+  }
+}
+
+/// \brief Rewrite a term with a given substitution and put the rewritten term in result.
+void RewriterJittyBytecode::rewrite_aux(
+                      data_expression& result,
+                      const data_expression& term,
+                      substitution_type& sigma)
+{
+  if (is_function_symbol(term))
+  {
+    assert(term!=this_term_is_in_normal_form());
+    rewrite_aux_const_function_symbol(result,atermpp::down_cast<const function_symbol>(term),sigma);
+    return;
+  }
+  if (is_variable(term))
+  {
+    sigma.apply(atermpp::down_cast<variable>(term),result, *m_thread_aterm_pool);
+    return;
+  }
+  if (is_machine_number(term))
+  {
+    result=term;
+    return;
+  }
+  if (is_where_clause(term))
+  {
+    rewrite_where(result,atermpp::down_cast<where_clause>(term),sigma);
+    return;
+  }
+  if (is_abstraction(term))
+  {
+    const abstraction& ta=atermpp::down_cast<abstraction>(term);
+    if (is_exists(ta))
+    {
+      existential_quantifier_enumeration(result,ta,sigma);
+      return;
+    }
+    if (is_forall(ta))
+    {
+      universal_quantifier_enumeration(result,ta,sigma);
+      return;
+    }
+    assert(is_lambda(ta));
+    rewrite_single_lambda(result,ta.variables(),ta.body(),false,sigma);
+    return;
+  }
+
+  // Here term must have the shape appl(t1,...,tn)
+  assert(is_application(term));
+  const application& terma=atermpp::down_cast<application>(term);
+  if (terma.head()==this_term_is_in_normal_form())
+  {
+    assert(terma.size()==1);
+    result.assign(terma[0], *m_thread_aterm_pool);
+    return;
+  }
+
+  const data_expression& head=get_nested_head(term);
+  if (is_function_symbol(head) && head!=this_term_is_in_normal_form())
+  {
+    if (m_normal_form_memo.enabled())
+    {
+      // The term is copied, as result and term may be the same object.
+      const data_expression* normal_form=m_normal_form_memo.find(terma);
+      if (normal_form!=nullptr)
+      {
+        result.assign(*normal_form, *m_thread_aterm_pool);
+        return;
+      }
+      const application t=terma;
+      rewrite_aux_function_symbol(result, atermpp::down_cast<function_symbol>(head),t,sigma);
+      m_normal_form_memo.insert(t, result);
+      return;
+    }
+    rewrite_aux_function_symbol(result, atermpp::down_cast<function_symbol>(head),terma,sigma);
+    return;
+  }
+
+  // The head is a variable or a binder. See RewriterJitty::rewrite_aux for an explanation.
+  m_rewrite_stack.increase(2);
+  const std::size_t t = 0;
+  rewrite_aux(m_rewrite_stack.element(t,2),terma.head(),sigma);
+
+  const std::size_t head1 = 1;
+  m_rewrite_stack.element(head1,2) = get_nested_head(m_rewrite_stack.element(t,2));
+  if (is_function_symbol(m_rewrite_stack.element(head1,2)))
+  {
+    make_application(result, m_rewrite_stack.element(t,2), terma.begin(), terma.end());
+    rewrite_aux_function_symbol(m_rewrite_stack.element(t,2),
+                                atermpp::down_cast<function_symbol>(m_rewrite_stack.element(head1,2)),
+                                atermpp::down_cast<application>(result),
+                                sigma);
+    result=m_rewrite_stack.element(t,2);
+    m_rewrite_stack.decrease(2);
+    return;
+  }
+  else if (is_variable(m_rewrite_stack.element(head1,2)))
+  {
+    jittyb_argument_rewriter r(sigma,*this);
+    const bool do_not_rewrite_head=false;
+    make_application(result, m_rewrite_stack.element(t,2), terma.begin(), terma.end(), r, do_not_rewrite_head);
+    m_rewrite_stack.decrease(2);
+    return;
+  }
+  const abstraction& ta=atermpp::down_cast<abstraction>(m_rewrite_stack.element(t,2));
+  const binder_type& binder(ta.binding_operator());
+  if (is_lambda_binder(binder))
+  {
+    rewrite_lambda_application(result,ta,terma,sigma);
+  }
+  else if (is_exists_binder(binder))
+  {
+    existential_quantifier_enumeration(result,ta,sigma);
+  }
+  else
+  {
+    assert(is_forall_binder(binder));
+    universal_quantifier_enumeration(result,ta,sigma);
+  }
+  m_rewrite_stack.decrease(2);
+}
+
+void RewriterJittyBytecode::rewrite_aux_function_symbol(
+                      data_expression& result,
+                      const function_symbol& op,
+                      const application& term,
+                      substitution_type& sigma)
+{
+  assert(is_function_sort(op.sort()));
+  const rewrite_profile::scope profile_scope(m_profile, op);
+
+  const std::size_t arity=detail::recursive_number_of_args(term);
+  assert(arity>0);
+  // The rewritten arguments are stored at positions 0,...,arity-1 of the frame. The position arity is used for
+  // the term that is rewritten next.
+  m_rewrite_stack.increase(arity+1);
+  bool* rewritten_defined = MCRL2_SPECIFIC_STACK_ALLOCATOR(bool, arity);
+  for(std::size_t i=0; i<arity; ++i)
+  {
+    rewritten_defined[i]=false;
+  }
+
+  const std::size_t op_value=atermpp::detail::index_traits<data::function_symbol,function_symbol_key_type, 2>::index(op);
+  if (op_value<m_functions.size() && m_functions[op_value].code!=jittyb_function::no_code)
+  {
+    const jittyb_function& f=m_functions[op_value];
+    const data_expression** registers = MCRL2_SPECIFIC_STACK_ALLOCATOR(const data_expression*, f.number_of_registers);
+    const data_expression** variables = MCRL2_SPECIFIC_STACK_ALLOCATOR(const data_expression*, f.number_of_variables);
+    bool* variable_is_a_normal_form = MCRL2_SPECIFIC_STACK_ALLOCATOR(bool, f.number_of_variables);
+    const std::size_t number_of_loaded_arguments=std::min(arity, f.number_of_arguments);
+    for(std::size_t i=0; i<number_of_loaded_arguments; ++i)
+    {
+      registers[i]=&detail::get_argument_of_higher_order_term(term,i);
+    }
+
+    std::size_t pc=f.code;
+    bool no_rule_applies=false;
+    while (!no_rule_applies)
+    {
+      const jittyb_instruction& instruction=m_code[pc++];
+      switch (instruction.op)
+      {
+        case jittyb_opcode::rewrite_argument:
+        {
+          const std::size_t i=instruction.a;
+          if (i>=arity)
+          {
+            no_rule_applies=true;
+            break;
+          }
+          if (!rewritten_defined[i])
+          {
+            rewrite_aux(m_rewrite_stack.element(i,arity+1),detail::get_argument_of_higher_order_term(term,i),sigma);
+            rewritten_defined[i]=true;
+            if (i<number_of_loaded_arguments)
+            {
+              registers[i]=&m_rewrite_stack.element(i,arity+1);
+            }
+          }
+          break;
+        }
+        case jittyb_opcode::try_rule:
+        {
+          const jittyb_rule& rule=m_rules[instruction.a];
+          if (rule.arity>arity)
+          {
+            no_rule_applies=true;
+            break;
+          }
+          const bool matches=match(rule.match, registers, variables, variable_is_a_normal_form, rewritten_defined, f.number_of_arguments);
+          if (m_profile.enabled())
+          {
+            m_profile.match_attempt(rule.equation, matches);
+          }
+          if (!matches)
+          {
+            break;
+          }
+          const rewrite_profile::scope rule_profile_scope(m_profile, rule.equation);
+          if (rule.condition!=jittyb_rule::no_condition)
+          {
+            // The condition is not rewritten into result, as result and term may be the same.
+            build(rule.condition, variables, variable_is_a_normal_form);
+            m_rewrite_stack.increase(1);
+            rewrite_aux(m_rewrite_stack.element(1,2), m_rewrite_stack.element(0,2), sigma);
+            const bool condition_holds=(m_rewrite_stack.top()==sort_bool::true_());
+            m_rewrite_stack.decrease(2);
+            if (!condition_holds)
+            {
+              if (m_profile.enabled())
+              {
+                m_profile.condition_failure(rule.equation);
+              }
+              break;
+            }
+          }
+          if (m_profile.enabled())
+          {
+            m_profile.application(rule.equation);
+          }
+
+          build(rule.rhs, variables, variable_is_a_normal_form);
+          if (arity==rule.arity)
+          {
+            rewrite_aux(result, m_rewrite_stack.top(), sigma);
+            m_rewrite_stack.decrease(arity+2);
+            return;
+          }
+
+          // There are more arguments than those in the left hand side. Apply the
+          // right hand side to the remaining arguments, following the sort of op.
+          assert(arity>rule.arity);
+          for(std::size_t i=rule.arity; i<arity; ++i)
+          {
+            m_rewrite_stack.set_element(i,arity+2,detail::get_argument_of_higher_order_term(term,i));
+          }
+          std::size_t i = rule.arity;
+          sort_expression sort = detail::residual_sort(op.sort(),i);
+          while (is_function_sort(sort) && (i < arity))
+          {
+            const function_sort& fsort = atermpp::down_cast<function_sort>(sort);
+            const std::size_t end=i+fsort.domain().size();
+            assert(end<=arity);
+            make_application(m_rewrite_stack.top(),m_rewrite_stack.top(),
+                             m_rewrite_stack.stack_iterator(i,arity+2),
+                             m_rewrite_stack.stack_iterator(i,arity+2)+(end-i));
+            i=end;
+            sort = fsort.codomain();
+          }
+          rewrite_aux(result,m_rewrite_stack.top(),sigma);
+          m_rewrite_stack.decrease(arity+2);
+          return;
+        }
+        case jittyb_opcode::cpp_code:
+        {
+          const std::function<void(data_expression&, const data_expression&)>& rewrite_cpp_code=m_cpp_functions[instruction.a];
+          if (term.head()==op)
+          {
+            // Precompiled code only works on terms with exactly the right number of arguments.
+            application rewriteable_term(op, m_rewrite_stack.stack_iterator(0,arity+1),
+                                             m_rewrite_stack.stack_iterator(0,arity+1)+arity);
+            rewrite_cpp_code(result, rewriteable_term);
+          }
+          else
+          {
+            for(std::size_t i=0; i<arity; i++)
+            {
+              if (!rewritten_defined[i])
+              {
+                rewrite_aux(m_rewrite_stack.element(i,arity+1),detail::get_argument_of_higher_order_term(term,i),sigma);
+                rewritten_defined[i]=true;
+              }
+            }
+            apply_cpp_code_to_higher_order_term(result, op, rewrite_cpp_code, arity, sigma);
+          }
+          m_rewrite_stack.decrease(arity+1);
+          return;
+        }
+        case jittyb_opcode::stop:
+        {
+          no_rule_applies=true;
+          break;
+        }
+        default:
+        {
+          assert(false);
+          no_rule_applies=true;
+        }
+      }
+    }
+  }
+
+  // No rewrite rule is applicable. Rewrite the not yet rewritten arguments.
+  for (std::size_t i=0; i<arity; i++)
+  {
+    if (!rewritten_defined[i])
+    {
+      rewrite_aux(m_rewrite_stack.element(i,arity+1),detail::get_argument_of_higher_order_term(term,i),sigma);
+    }
+  }
+
+  const function_sort& fsort=atermpp::down_cast<function_sort>(op.sort());
+  const std::size_t end=fsort.domain().size();
+  make_application(result,op,m_rewrite_stack.stack_iterator(0,arity+1), m_rewrite_stack.stack_iterator(end,arity+1));
+  std::size_t i=end;
+  const sort_expression* sort = &fsort.codomain();
+  while (i<arity && is_function_sort(*sort))
+  {
+    const function_sort& fsort=atermpp::down_cast<function_sort>(*sort);
+    const std::size_t end=i+fsort.domain().size();
+    assert(end<arity+1);
+    make_application(result,result,m_rewrite_stack.stack_iterator(i,arity+1), m_rewrite_stack.stack_iterator(end,arity+1));
+    i=end;
+    sort = &fsort.codomain();
+  }
+
+  m_rewrite_stack.decrease(arity+1);
+}
+
+// Apply precompiled code for op to the first arguments of a higher order term, and rewrite the result applied
+// to the remaining arguments. All arguments are in normal form and occupy the current frame of the rewrite stack.
+void RewriterJittyBytecode::apply_cpp_code_to_higher_order_term(
+                      data_expression& result,
+                      const function_symbol& op,
+                      const std::function<void(data_expression&, const data_expression&)>& rewrite_cpp_code,
+                      const std::size_t arity,
+                      substitution_type& sigma)
+{
+  const function_sort& fsort=atermpp::down_cast<function_sort>(op.sort());
+  std::size_t i=fsort.domain().size();
+  make_application(m_rewrite_stack.top(), op, m_rewrite_stack.stack_iterator(0,arity+1), m_rewrite_stack.stack_iterator(0,arity+1)+i);
+  rewrite_cpp_code(result, m_rewrite_stack.top());
+
+  const sort_expression* sort = &fsort.codomain();
+  while (i<arity && is_function_sort(*sort))
+  {
+    const function_sort& fsort=atermpp::down_cast<function_sort>(*sort);
+    const std::size_t end=i+fsort.domain().size();
+    m_rewrite_stack.top()=application(result,
+                                      m_rewrite_stack.stack_iterator(i,arity+1),
+                                      m_rewrite_stack.stack_iterator(i,arity+1)+(end-i),
+                                      [&](const data_expression& t){ return application(this_term_is_in_normal_form(),t); });
+    rewrite_aux(result, m_rewrite_stack.top(), sigma);
+    i=end;
+    sort = &fsort.codomain();
+  }
+}
+
+void RewriterJittyBytecode::rewrite(
+     data_expression& result,
+     const data_expression& term,
+     substitution_type& sigma)
+{
+#ifdef MCRL2_DISPLAY_REWRITE_STATISTICS
+  data::detail::increment_rewrite_count();
+#endif
+  if (rewriting_in_progress)
+  {
+    rewrite_aux(result, term, sigma);
+  }
+  else
+  {
+    assert(m_rewrite_stack.stack_size()==0);
+    rewriting_in_progress=true;
+    try
+    {
+      rewrite_aux(result, term, sigma);
+    }
+    catch (recalculate_term_as_stack_is_too_small&)
+    {
+      rewriting_in_progress=false; // Restart rewriting, due to a stack overflow.
+      m_rewrite_stack.reserve_more_space();
+      rewrite(result,term,sigma);
+      return;
+    }
+    rewriting_in_progress=false;
+    assert(m_rewrite_stack.stack_size()==0);
+  }
+
+  assert(remove_normal_form_function(result)==result);
+}
+
+data_expression RewriterJittyBytecode::rewrite(
+     const data_expression& term,
+     substitution_type& sigma)
+{
+  data_expression result;
+  rewrite(result, term, sigma);
+  return result;
+}
+
+rewrite_strategy RewriterJittyBytecode::getStrategy()
+{
+  return jitty_bytecode;
+}
+
+} // namespace detail
+} // namespace data
+} // namespace mcrl2
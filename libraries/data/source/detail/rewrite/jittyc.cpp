@@ -14,6 +14,7 @@
 
 #define NAME "rewr_jittyc"
 
+#include <filesystem>
 #include <unistd.h>
 #include <sys/stat.h>
 #include "mcrl2/utilities/basename.h"
@@ -1924,7 +1925,7 @@ class RewriterCompilingJitty::ImplementTree
              std::map<variable,std::string>& type_of_code_variables)
   {
     bool reset_current_data_parameters=false;
-    const void* func = (void*)(atermpp::detail::address(tree.function()));
+    const std::string func = m_rewriter.m_nf_cache->address(tree.function());
     m_stream << m_padding;
     brackets.bracket_nesting_level++;
     if (level == 0)
@@ -2005,7 +2006,7 @@ class RewriterCompilingJitty::ImplementTree
              std::map<variable,std::string>& type_of_code_variables)
   {
     bool reset_current_data_parameters=false;
-    const void* number = (void*)(atermpp::detail::address(tree.number()));
+    const std::string number = m_rewriter.m_nf_cache->address(tree.number());
     m_stream << m_padding;
     brackets.bracket_nesting_level++;
     if (level == 0)
@@ -2705,6 +2706,11 @@ public:
     rewr_function_signature(m_stream, index, arity, brackets);
     m_stream << m_padding << "{\n"
              << m_padding << "  mcrl2::utilities::mcrl2_unused(this_rewriter); // Suppress warning\n";
+    if (m_rewriter.m_profile.enabled())
+    {
+      m_stream << m_padding << "  const rewrite_profile::scope profile_scope(this_rewriter->m_profile, atermpp::down_cast<function_symbol>("
+               << m_rewriter.m_nf_cache->insert(func) << "));\n";
+    }
 //              << m_padding << "  std::size_t old_stack_size=this_rewriter->m_rewrite_stack.stack_size();\n";    
     m_padding.indent();
     implement_strategy(m_stream, strategy, arity, func, brackets, auxiliary_code_fragments,data_spec);
@@ -2888,6 +2894,229 @@ static std::string generate_cpp_filename(std::size_t unique)
   return filename.str();
 }
 
+static std::string read_file(const std::string& filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  std::ostringstream result;
+  result << in.rdbuf();
+  return result.str();
+}
+
+/// \brief The directory in which compiled rewriters are cached, which is empty if it cannot be determined.
+/// \details The directory is given by MCRL2_JITTYC_CACHE, and otherwise it is mcrl2/jittyc in $XDG_CACHE_HOME
+///          or in $HOME/.cache.
+static std::filesystem::path jittyc_cache_directory()
+{
+  if (const char* env_dir = std::getenv("MCRL2_JITTYC_CACHE"))
+  {
+    return std::filesystem::path(env_dir);
+  }
+  if (const char* env_dir = std::getenv("XDG_CACHE_HOME"))
+  {
+    return std::filesystem::path(env_dir) / "mcrl2" / "jittyc";
+  }
+  if (const char* env_dir = std::getenv("HOME"))
+  {
+    return std::filesystem::path(env_dir) / ".cache" / "mcrl2" / "jittyc";
+  }
+  return std::filesystem::path();
+}
+
+/// \returns The maximum number of bytes of the cache, given in megabytes by MCRL2_JITTYC_CACHE_SIZE (default 1024).
+///          The cache is disabled when the size is 0.
+static std::uintmax_t jittyc_cache_size()
+{
+  const std::uintmax_t megabyte = 1024 * 1024;
+  const char* env_size = std::getenv("MCRL2_JITTYC_CACHE_SIZE");
+  if (env_size != nullptr)
+  {
+    // std::stoull accepts a sign, so a negative size would silently become a very large one. The number of
+    // digits is bounded such that the size in bytes does not overflow.
+    const std::string size(env_size);
+    if (!size.empty() && size.find_first_not_of("0123456789") == std::string::npos
+        && size.size() < std::numeric_limits<std::uintmax_t>::digits10 - 6)
+    {
+      return std::stoull(size) * megabyte;
+    }
+    mCRL2log(warning) << "Ignoring the invalid size " << size << " of the cache of compiled rewriters, "
+                      << "which must be a number of megabytes." << std::endl;
+  }
+  return 1024 * megabyte;
+}
+
+/// \returns The name of the cached rewriter, which is a 64-bit FNV-1a hash of its material in hexadecimal.
+static std::string jittyc_cache_key(const std::string& material)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c: material)
+  {
+    hash = (hash ^ c) * 1099511628211ULL;
+  }
+  std::ostringstream result;
+  result << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return result.str();
+}
+
+/// \returns A digest of the headers in the include directories of the compile script, which the generated code
+///          includes. A header is represented by its name, size and modification time, which suffices to notice that
+///          the headers have been changed or reinstalled without a change of the toolset version.
+static std::string jittyc_header_digest(const std::string& script)
+{
+  std::vector<std::string> headers;
+  for (std::size_t position = script.find("-I"); position != std::string::npos; position = script.find("-I", position))
+  {
+    position += 2;
+    std::string directory;
+    if (position < script.size() && script[position] == '"')
+    {
+      const std::size_t end = script.find('"', position + 1);
+      directory = script.substr(position + 1, end == std::string::npos ? std::string::npos : end - position - 1);
+    }
+    else
+    {
+      const std::size_t end = script.find_first_of(" \t\n", position);
+      directory = script.substr(position, end == std::string::npos ? std::string::npos : end - position);
+    }
+
+    std::error_code error;
+    for (std::filesystem::recursive_directory_iterator i(directory, error), end; !error && i != end; i.increment(error))
+    {
+      if (i->path().extension() == ".h" && i->is_regular_file(error))
+      {
+        headers.push_back(i->path().string() + " " + std::to_string(i->file_size(error)) + " "
+                          + std::to_string(i->last_write_time(error).time_since_epoch().count()));
+      }
+    }
+  }
+
+  // The order in which the entries of a directory are visited is unspecified.
+  std::sort(headers.begin(), headers.end());
+  std::string result;
+  for (const std::string& header: headers)
+  {
+    result += header + "\n";
+  }
+  return jittyc_cache_key(result);
+}
+
+/// \brief Everything that determines the compiled rewriter: the toolset version, the compile script, which
+///        contains the compiler flags, the compiler selected by $CXX, the headers and the generated code.
+static std::string jittyc_cache_material(const std::string& compile_script, const std::string& cpp_file)
+{
+  std::string script_path = compile_script;
+  if (script_path.find('/') == std::string::npos)
+  {
+    // The script is found in the PATH.
+    const char* env_path = std::getenv("PATH");
+    std::istringstream directories(env_path == nullptr ? "" : env_path);
+    for (std::string directory; std::getline(directories, directory, ':'); )
+    {
+      if (mcrl2::utilities::file_exists(directory + "/" + compile_script))
+      {
+        script_path = directory + "/" + compile_script;
+        break;
+      }
+    }
+  }
+  const char* env_cxx = std::getenv("CXX");
+  std::ostringstream result;
+  const std::string script = read_file(script_path);
+  result << mcrl2::utilities::get_toolset_version() << "\n"
+         << (env_cxx == nullptr ? "" : env_cxx) << "\n"
+         << jittyc_header_digest(script) << "\n"
+         << script << "\n"
+         << read_file(cpp_file);
+  return result.str();
+}
+
+/// \brief Removes the least recently used rewriters from the cache until it is at most max_size bytes.
+/// \details Every rewriter consists of a library (.bin) and its material (.src), which is compared on a hit to rule
+///          out hash collisions.
+static void jittyc_cache_trim(const std::filesystem::path& directory, std::uintmax_t max_size)
+{
+  std::vector<std::pair<std::filesystem::file_time_type, std::filesystem::path>> libraries;
+  std::uintmax_t size = 0;
+  for (const std::filesystem::directory_entry& entry: std::filesystem::directory_iterator(directory))
+  {
+    if (entry.path().extension() == ".bin" || entry.path().extension() == ".src")
+    {
+      size += entry.file_size();
+      if (entry.path().extension() == ".bin")
+      {
+        libraries.emplace_back(entry.last_write_time(), entry.path());
+      }
+    }
+  }
+
+  std::sort(libraries.begin(), libraries.end());
+  for (const auto& [time, library]: libraries)
+  {
+    if (size <= max_size)
+    {
+      break;
+    }
+    std::filesystem::path material = library;
+    material.replace_extension(".src");
+    std::error_code error; // Another process may remove the same files.
+    size -= std::filesystem::file_size(library, error) + std::filesystem::file_size(material, error);
+    std::filesystem::remove(library, error);
+    std::filesystem::remove(material, error);
+    mCRL2log(debug) << "Removed " << library << " from the cache of compiled rewriters." << std::endl;
+  }
+}
+
+/// \brief Copies the library from the cache to library_file if its material equals the given material.
+/// \returns True iff the library was copied.
+static bool jittyc_cache_find(const std::filesystem::path& directory, const std::string& key, const std::string& material,
+                              const std::string& library_file)
+{
+  const std::filesystem::path library = directory / (key + ".bin");
+  const std::filesystem::path cached_material = directory / (key + ".src");
+  std::error_code error;
+  if (!std::filesystem::exists(library, error) || read_file(cached_material.string()) != material)
+  {
+    return false;
+  }
+  // A library is loaded from a unique filename, as loading the same file twice yields the same library.
+  if (!std::filesystem::copy_file(library, library_file, std::filesystem::copy_options::overwrite_existing, error))
+  {
+    return false;
+  }
+  std::filesystem::last_write_time(library, std::filesystem::file_time_type::clock::now(), error);
+  return true;
+}
+
+/// \brief Stores a copy of the compiled library in the cache.
+/// \details The files are written under a temporary name and renamed afterwards, so that other processes never
+///          observe a partially written library.
+static void jittyc_cache_insert(const std::filesystem::path& directory, const std::string& key, const std::string& material,
+                                const std::string& library_file, std::uintmax_t max_size)
+{
+  try
+  {
+    std::filesystem::create_directories(directory);
+    const std::string temporary_suffix = "." + std::to_string(getpid()) + ".tmp";
+    const std::filesystem::path material_file = directory / (key + ".src");
+    const std::filesystem::path cached_library = directory / (key + ".bin");
+    {
+      std::ofstream out(material_file.string() + temporary_suffix, std::ios::binary);
+      out << material;
+      if (!out)
+      {
+        throw std::runtime_error("could not write " + material_file.string());
+      }
+    }
+    std::filesystem::rename(material_file.string() + temporary_suffix, material_file);
+    std::filesystem::copy_file(library_file, cached_library.string() + temporary_suffix, std::filesystem::copy_options::overwrite_existing);
+    std::filesystem::rename(cached_library.string() + temporary_suffix, cached_library);
+    jittyc_cache_trim(directory, max_size);
+  }
+  catch (const std::exception& e)
+  {
+    mCRL2log(warning) << "Could not store the compiled rewriter in " << directory << ": " << e.what() << std::endl;
+  }
+}
+
 ///
 /// \brief filter_function_symbols selects the function symbols from source for which filter
 ///        returns true, and copies them to dest.
@@ -2936,6 +3165,13 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
               "#define ARITY_BOUND__ " << arity_bound << "// These values are not used anymore.\n";
   cpp_file << "#include \"mcrl2/data/detail/rewrite/jittycpreamble.h\"\n";
 
+  cpp_file << "namespace {\n"
+              "// The terms to which the code refers by index, which are set when it is loaded.\n"
+              "extern const data_expression* jittyc_terms[];\n"
+              "extern std::uintptr_t jittyc_addresses[];\n"
+              "} // namespace\n"
+              "\n";
+
   cpp_file << "namespace {\n"
                "// Anonymous namespace so the compiler uses internal linkage for the generated\n"
                "// rewrite code.\n"
@@ -2981,10 +3217,28 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
 
   cpp_file << rewr_code.str();
 
-  cpp_file << "void set_the_precompiled_rewrite_functions_in_a_lookup_table(RewriterCompilingJitty* this_rewriter)\n"
+  const std::size_t number_of_terms = m_nf_cache->size();
+  cpp_file << "namespace {\n"
+              "const data_expression* jittyc_terms[" << std::max<std::size_t>(number_of_terms, 1) << "];\n"
+              "std::uintptr_t jittyc_addresses[" << std::max<std::size_t>(number_of_terms, 1) << "];\n"
+              "} // namespace\n"
+              "\n";
+
+  cpp_file << "bool set_the_precompiled_rewrite_functions_in_a_lookup_table(RewriterCompilingJitty* this_rewriter)\n"
               "{\n";
-  cpp_file << "  assert(&this_rewriter->functions_when_arguments_are_not_in_normal_form == (void *)" << &functions_when_arguments_are_not_in_normal_form << ");  // Check that this table matches the one rewriter is actually using.\n";
-  cpp_file << "  assert(&this_rewriter->functions_when_arguments_are_in_normal_form == (void *)" << &functions_when_arguments_are_in_normal_form << ");  // Check that this table matches the one rewriter is actually using.\n";
+  cpp_file << "  // Check that the tables of the rewriter have the layout for which this code was generated.\n"
+           << "  if (this_rewriter->arity_bound != " << arity_bound << " || this_rewriter->index_bound != " << index_bound << " ||\n"
+           << "      this_rewriter->functions_when_arguments_are_not_in_normal_form.size() != " << arity_bound * index_bound << " ||\n"
+           << "      this_rewriter->functions_when_arguments_are_in_normal_form.size() != " << arity_bound * index_bound << " ||\n"
+           << "      this_rewriter->number_of_generated_terms() != " << number_of_terms << ")\n"
+           << "  {\n"
+           << "    return false;\n"
+           << "  }\n";
+  cpp_file << "  for (std::size_t i = 0; i < " << number_of_terms << "; ++i)\n"
+           << "  {\n"
+           << "    jittyc_terms[i] = &this_rewriter->generated_term(i);\n"
+           << "    jittyc_addresses[i] = uint_address(*jittyc_terms[i]);\n"
+           << "  }\n";
   cpp_file << "  for(rewriter_function& f: this_rewriter->functions_when_arguments_are_not_in_normal_form)\n"
            << "  {\n"
            << "    f = nullptr;\n"
@@ -3025,7 +3279,8 @@ void RewriterCompilingJitty::generate_code(const std::string& filename)
   }
 
 
-  cpp_file << "}\n";
+  cpp_file << "  return true;\n"
+              "}\n";
   cpp_file.close();
 }
 
@@ -3074,17 +3329,34 @@ void RewriterCompilingJitty::BuildRewriteSystem()
   mCRL2log(verbose) << "generated " << cpp_file << " in " << time.time() << "ms, compiling..." << std::endl;
   time.reset();
 
-  try
+  // The code does not depend on the addresses of this process, so the library can be reused by other processes.
+  const std::uintmax_t cache_size = jittyc_cache_size();
+  const std::filesystem::path cache_directory = cache_size == 0 ? std::filesystem::path() : jittyc_cache_directory();
+  const std::string material = cache_directory.empty() ? std::string() : jittyc_cache_material(compile_script, cpp_file);
+  const std::string key = cache_directory.empty() ? std::string() : jittyc_cache_key(material);
+  if (!cache_directory.empty() && jittyc_cache_find(cache_directory, key, material, cpp_file + ".bin"))
   {
-    rewriter_so->compile(cpp_file);
+    rewriter_so->use_compiled(cpp_file, cpp_file + ".bin");
+    mCRL2log(verbose) << "found compiled rewriter " << key << " in " << cache_directory << " in " << time.time() << "ms, loading rewriter..." << std::endl;
   }
-  catch(std::runtime_error& e)
+  else
   {
-    rewriter_so->leave_files();
-    throw mcrl2::runtime_error(std::string("Could not compile rewriter: ") + e.what());
-  }
+    try
+    {
+      rewriter_so->compile(cpp_file);
+    }
+    catch(std::runtime_error& e)
+    {
+      rewriter_so->leave_files();
+      throw mcrl2::runtime_error(std::string("Could not compile rewriter: ") + e.what());
+    }
 
-  mCRL2log(verbose) << "compiled in " << time.time() << "ms, loading rewriter..." << std::endl;
+    mCRL2log(verbose) << "compiled in " << time.time() << "ms, loading rewriter..." << std::endl;
+    if (!cache_directory.empty())
+    {
+      jittyc_cache_insert(cache_directory, key, material, rewriter_so->filename(), cache_size);
+    }
+  }
 
   bool (*init)(rewriter_interface*, RewriterCompilingJitty* this_rewriter);
   rewriter_interface interface = { mcrl2::utilities::get_toolset_version(), "Unknown error when loading rewriter.", this, nullptr, nullptr };
@@ -7,6 +7,7 @@
 // http://www.boost.org/LICENSE_1_0.txt)
 
 #include "mcrl2/data/detail/rewrite/jitty.h"
+#include "mcrl2/data/detail/rewrite/jittyb.h"
 #include "mcrl2/data/detail/rewrite/jitty_jittyc.h"
 #include "mcrl2/data/detail/enumerator_iteration_limit.h"
 
@@ -519,6 +520,8 @@ std::shared_ptr<Rewriter> createRewriter(
   {
     case jitty:
       return std::shared_ptr<Rewriter>(new RewriterJitty(data_spec,equations_selector));
+    case jitty_bytecode:
+      return std::shared_ptr<Rewriter>(new RewriterJittyBytecode(data_spec,equations_selector));
 #ifdef MCRL2_ENABLE_JITTYC
     case jitty_compiling:
       return std::shared_ptr<Rewriter>(new RewriterCompilingJitty(data_spec,equations_selector));
@@ -12,6 +12,9 @@
 #define BOOST_TEST_MODULE rewriter_test
 #include "mcrl2/data/detail/one_point_rule_preprocessor.h"
 #include "mcrl2/data/detail/parse_substitution.h"
+#include "mcrl2/data/detail/rewrite_strategies.h"
+#include "mcrl2/data/detail/rewrite/normal_form_memo.h"
+#include "mcrl2/data/detail/rewrite_statistics.h"
 #include "mcrl2/data/detail/test_rewriters.h"
 #include "mcrl2/data/print.h"
 #include "mcrl2/data/rewriter.h"
@@ -19,6 +22,12 @@
 
 #include <boost/test/included/unit_test.hpp>
 
+#ifdef MCRL2_TEST_JITTYC
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+#endif // MCRL2_TEST_JITTYC
+
 using namespace mcrl2;
 using namespace mcrl2::core;
 using namespace mcrl2::data;
@@ -244,6 +253,282 @@ void test_enumeration_of_functions()
   test_expressions(R, expr1, expr2, "", data_spec, sigma);
 }
 
+// Check that the rewriter that executes the jitty strategies as bytecode yields the same normal forms as jitty.
+// The specification contains non linear patterns, conditions, higher order functions and binders in right hand sides.
+void test_jitty_bytecode()
+{
+  std::string DATA_SPEC =
+    "sort D = struct d1 | d2 | d3;\n"
+    "map eq2: D # D -> Bool;\n"
+    "    occurrences: D # List(D) -> Nat;\n"
+    "    twice: (D -> D) -> D -> D;\n"
+    "    next: D -> D;\n"
+    "    all_d: List(D) -> Bool;\n"
+    "var x, y: D; l: List(D); f: D -> D;\n"
+    "eqn eq2(x, x) = true;\n"
+    "    x != y -> eq2(x, y) = false;\n"
+    "    occurrences(x, []) = 0;\n"
+    "    occurrences(x, y |> l) = if(eq2(x, y), 1, 0) + occurrences(x, l);\n"
+    "    twice(f)(x) = f(f(x));\n"
+    "    next(d1) = d2;\n"
+    "    next(d2) = d3;\n"
+    "    next(d3) = d1;\n"
+    "    all_d(l) = forall z: D. z in l;\n";
+  data_specification data_spec = parse_data_specification(DATA_SPEC);
+  rewriter R_jitty(data_spec, jitty);
+  rewriter R_jittyb(data_spec, jitty_bytecode);
+
+  std::vector<variable> variables;
+  parse_variables("n: Nat; e: D; l: List(D);", std::back_inserter(variables), data_spec);
+  for (const char* expr: { "eq2(d1, d1)",
+                           "eq2(d1, d2)",
+                           "eq2(e, e)",
+                           "occurrences(d1, [d1, d2, d1, d3])",
+                           "occurrences(e, [d1, e])",
+                           "twice(next)(d3)",
+                           "twice(twice(next))(d1)",
+                           "(lambda g: D -> D. g(d1))(next)",
+                           "all_d([d1, d2, d3])",
+                           "all_d([d1, d3])",
+                           "n + 3 * 2 > 5",
+                           "#([d1, d2] ++ l)",
+                           "exists m: Nat. m < 2 && m + n == 3" })
+  {
+    const data_expression d = parse_data_expression(expr, variables, data_spec);
+    BOOST_CHECK_EQUAL(R_jitty(d), R_jittyb(d));
+  }
+
+  // A copy of the rewriter has its own bytecode.
+  rewriter R_copy = R_jittyb.clone();
+  BOOST_CHECK_EQUAL(R_copy(parse_data_expression("twice(next)(d3)", data_spec)), R_jitty(parse_data_expression("d2", data_spec)));
+}
+
+// Check that normal forms of closed terms are stored and reused, and that terms with variables are not stored.
+void test_normal_form_memo()
+{
+  std::string DATA_SPEC =
+    "sort N = struct z | s(N);\n"
+    "map fib: N -> N;\n"
+    "    plus: N # N -> N;\n"
+    "var m, n: N;\n"
+    "eqn plus(m, z) = m;\n"
+    "    plus(m, s(n)) = s(plus(m, n));\n"
+    "    fib(z) = z;\n"
+    "    fib(s(z)) = s(z);\n"
+    "    fib(s(s(n))) = plus(fib(n), fib(s(n)));\n";
+  data_specification data_spec = parse_data_specification(DATA_SPEC);
+  const data_expression closed = parse_data_expression("fib(s(s(s(s(s(s(z)))))))", data_spec);
+  const data_expression closed_normal_form = parse_data_expression("s(s(s(s(s(s(s(s(z))))))))", data_spec);
+  std::vector<variable> variables;
+  parse_variables("k: N;", std::back_inserter(variables), data_spec);
+  const data_expression open = parse_data_expression("plus(fib(k), fib(s(s(s(s(z))))))", variables, data_spec);
+  const variable k = variables.front();
+
+  for (rewrite_strategy strategy: data::detail::get_test_rewrite_strategies(false))
+  {
+    rewriter R_reference(data_spec, strategy);
+    const std::size_t lookups = data::detail::normal_form_memo_lookups();
+    const std::size_t hits = data::detail::normal_form_memo_hits();
+    data::detail::set_normal_form_memo_size(1000);
+    {
+      rewriter R(data_spec, strategy);
+      BOOST_CHECK_EQUAL(R(closed), closed_normal_form);
+      BOOST_CHECK_EQUAL(R(closed), closed_normal_form);
+      for (const char* value: { "s(s(s(z)))", "s(s(s(s(z))))", "s(s(s(z)))" })
+      {
+        rewriter::substitution_type sigma;
+        sigma[k] = parse_data_expression(value, data_spec);
+        rewriter::substitution_type sigma_reference;
+        sigma_reference[k] = sigma(k);
+        BOOST_CHECK_EQUAL(R(open, sigma), R_reference(open, sigma_reference));
+      }
+    }
+    data::detail::set_normal_form_memo_size(0);
+    BOOST_CHECK(data::detail::normal_form_memo_lookups() > lookups);
+    BOOST_CHECK(data::detail::normal_form_memo_hits() > hits);
+  }
+}
+
+// Returns the profile of the rewriters destroyed since the last call as a mapping from the kind and name of
+// an entry to its counts, leaving out the times.
+std::map<std::string, std::vector<std::string> > rewrite_profile_counts()
+{
+  std::stringstream out;
+  data::detail::write_rewrite_profile(out);
+  data::detail::clear_rewrite_profile();
+
+  std::map<std::string, std::vector<std::string> > result;
+  std::string line;
+  std::getline(out, line); // Skip the header.
+  while (std::getline(out, line))
+  {
+    std::vector<std::string> columns;
+    std::stringstream line_stream(line);
+    std::string column;
+    while (std::getline(line_stream, column, '\t'))
+    {
+      columns.push_back(column);
+    }
+    BOOST_REQUIRE_EQUAL(columns.size(), 9u);
+    result[columns[0] + " " + columns[8]] = std::vector<std::string>(columns.begin() + 1, columns.begin() + 6);
+  }
+  return result;
+}
+
+// Returns the counts of the entry in profile of which the name starts with prefix.
+const std::vector<std::string>& find_rewrite_profile_entry(const std::map<std::string, std::vector<std::string> >& profile, const std::string& prefix)
+{
+  static const std::vector<std::string> not_found;
+  for (const auto& p: profile)
+  {
+    if (p.first.compare(0, prefix.size(), prefix) == 0)
+    {
+      return p.second;
+    }
+  }
+  return not_found;
+}
+
+void test_rewrite_profile()
+{
+  std::string DATA_SPEC =
+    "sort N = struct z | s(N);\n"
+    "map fib: N -> N;\n"
+    "    plus: N # N -> N;\n"
+    "    max2: Nat # Nat -> Nat;\n"
+    "var m, n: N;\n"
+    "    i, j: Nat;\n"
+    "eqn plus(m, z) = m;\n"
+    "    plus(m, s(n)) = s(plus(m, n));\n"
+    "    fib(z) = z;\n"
+    "    fib(s(z)) = s(z);\n"
+    "    fib(s(s(n))) = plus(fib(n), fib(s(n)));\n"
+    "    i < j -> max2(i, j) = j;\n"
+    "    i >= j -> max2(i, j) = i;\n";
+  data_specification data_spec = parse_data_specification(DATA_SPEC);
+  const data_expression fib6 = parse_data_expression("fib(s(s(s(s(s(s(z)))))))", data_spec);
+  const data_expression max2 = parse_data_expression("max2(4, 3)", data_spec);
+
+  data::detail::clear_rewrite_profile();
+  data::detail::set_rewrite_profile_filename("rewriter_test_profile.txt");
+  std::map<std::string, std::vector<std::string> > jitty_profile;
+  for (rewrite_strategy strategy: { jitty, jitty_bytecode })
+  {
+    {
+      rewriter R(data_spec, strategy);
+      BOOST_CHECK_EQUAL(R(fib6), parse_data_expression("s(s(s(s(s(s(s(s(z))))))))", data_spec));
+      BOOST_CHECK_EQUAL(R(max2), sort_nat::nat(4));
+    }
+    std::map<std::string, std::vector<std::string> > profile = rewrite_profile_counts();
+
+    // The counts are calls, match attempts, match failures, condition failures and applications. Computing
+    // fib(6) naively takes 25 rewrite steps with head fib, of which 12 use the third equation.
+    const std::vector<std::string>& fib_step = find_rewrite_profile_entry(profile, "equation fib(s(s(n)))");
+    BOOST_REQUIRE_EQUAL(fib_step.size(), 5u);
+    BOOST_CHECK_EQUAL(fib_step[0], "12");
+    BOOST_CHECK_EQUAL(fib_step[4], "12");
+    const std::vector<std::string>& fib = find_rewrite_profile_entry(profile, "function symbol fib:");
+    BOOST_REQUIRE_EQUAL(fib.size(), 5u);
+    BOOST_CHECK_EQUAL(fib[0], "25");
+    const std::vector<std::string>& max2_less = find_rewrite_profile_entry(profile, "equation (i < j)");
+    BOOST_REQUIRE_EQUAL(max2_less.size(), 5u);
+    BOOST_CHECK_EQUAL(max2_less[0], "1");
+    BOOST_CHECK_EQUAL(max2_less[3], "1");
+    BOOST_CHECK_EQUAL(max2_less[4], "0");
+
+    if (strategy == jitty)
+    {
+      jitty_profile = profile;
+    }
+    else
+    {
+      BOOST_CHECK(profile == jitty_profile);
+    }
+  }
+
+  {
+    rewriter R(data_spec, jitty);
+    R(max2);
+  }
+  std::stringstream out;
+  data::detail::write_rewrite_profile(out, true);
+  BOOST_CHECK(out.str().find("\"name\":\"max2: Nat # Nat -> Nat\",\"calls\":1,") != std::string::npos);
+  data::detail::clear_rewrite_profile();
+  data::detail::set_rewrite_profile_filename("");
+}
+
+#ifdef MCRL2_TEST_JITTYC
+#ifdef MCRL2_ENABLE_JITTYC
+// Checks that compiled rewriters are stored in, reused from and removed from the directory MCRL2_JITTYC_CACHE.
+void test_jittyc_cache()
+{
+  namespace fs = std::filesystem;
+  const fs::path directory = fs::temp_directory_path() / ("rewriter_test_jittyc_cache_" + std::to_string(getpid()));
+  fs::remove_all(directory);
+  setenv("MCRL2_JITTYC_CACHE", directory.string().c_str(), 1);
+
+  auto cached_libraries = [&]()
+  {
+    std::vector<fs::path> result;
+    if (fs::exists(directory))
+    {
+      for (const fs::directory_entry& entry: fs::directory_iterator(directory))
+      {
+        if (entry.path().extension() == ".bin")
+        {
+          result.push_back(entry.path());
+        }
+      }
+    }
+    return result;
+  };
+
+  auto check_rewriter = [](const std::string& function)
+  {
+    const data_specification data_spec = parse_data_specification("map " + function + ": Nat -> Nat; var n: Nat; eqn " + function + "(n) = n + 1;");
+    rewriter R(data_spec, jitty_compiling);
+    BOOST_CHECK_EQUAL(R(parse_data_expression(function + "(2) == 3", data_spec)), sort_bool::true_());
+  };
+
+  // A size of 0 disables the cache.
+  setenv("MCRL2_JITTYC_CACHE_SIZE", "0", 1);
+  check_rewriter("f");
+  BOOST_CHECK(!fs::exists(directory));
+
+  // A negative size is ignored, and the cache has its default size. The first rewriter is a miss.
+  setenv("MCRL2_JITTYC_CACHE_SIZE", "-1", 1);
+  check_rewriter("f");
+  BOOST_CHECK_EQUAL(cached_libraries().size(), 1u);
+
+  // The same specification is a hit, which marks the library as recently used.
+  const fs::path library = cached_libraries().front();
+  const fs::file_time_type last_used = fs::last_write_time(library) - std::chrono::hours(1);
+  fs::last_write_time(library, last_used);
+  check_rewriter("f");
+  BOOST_CHECK_EQUAL(cached_libraries().size(), 1u);
+  BOOST_CHECK(fs::last_write_time(library) > last_used);
+
+  // Another specification is a miss.
+  check_rewriter("g");
+  BOOST_CHECK_EQUAL(cached_libraries().size(), 2u);
+
+  // The least recently used library is removed first when the cache exceeds its size of 1MB.
+  const fs::path old_library = directory / "0000000000000000.bin";
+  std::ofstream(old_library) << std::string(2 * 1024 * 1024, ' ');
+  std::ofstream(directory / "0000000000000000.src") << " ";
+  fs::last_write_time(old_library, last_used - std::chrono::hours(1));
+  setenv("MCRL2_JITTYC_CACHE_SIZE", "1", 1);
+  check_rewriter("h");
+  BOOST_CHECK(!fs::exists(old_library));
+  BOOST_CHECK(!fs::exists(directory / "0000000000000000.src"));
+
+  unsetenv("MCRL2_JITTYC_CACHE");
+  unsetenv("MCRL2_JITTYC_CACHE_SIZE");
+  fs::remove_all(directory);
+}
+#endif // MCRL2_ENABLE_JITTYC
+#endif // MCRL2_TEST_JITTYC
+
 BOOST_AUTO_TEST_CASE(test_main)
 {
   test1();
@@ -255,4 +540,12 @@ BOOST_AUTO_TEST_CASE(test_main)
   test_lambda_expression();
   test_equality_on_functions();
   test_enumeration_of_functions();
+  test_jitty_bytecode();
+  test_normal_form_memo();
+  test_rewrite_profile();
+#ifdef MCRL2_TEST_JITTYC
+#ifdef MCRL2_ENABLE_JITTYC
+  test_jittyc_cache();
+#endif // MCRL2_ENABLE_JITTYC
+#endif // MCRL2_TEST_JITTYC
 }
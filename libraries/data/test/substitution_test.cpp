@@ -399,6 +399,18 @@ void test_mutable_indexed_substitution()
   std::string s = sigma.to_string();
   std::cout << "s = " << s << std::endl;
   BOOST_CHECK(s == "[b := true]");
+
+  // The variables occurring in right hand sides must be maintained when values are overwritten.
+  variable x = parse_variable("x: Nat");
+  variable y = parse_variable("y: Nat");
+  variable z = parse_variable("z: Nat");
+  sigma[x] = sort_nat::succ(y);
+  BOOST_CHECK(sigma.variable_occurs_in_a_rhs(y));
+  sigma[x] = sort_nat::succ(z);
+  BOOST_CHECK(!sigma.variable_occurs_in_a_rhs(y));
+  BOOST_CHECK(sigma.variable_occurs_in_a_rhs(z));
+  sigma[x] = x;
+  BOOST_CHECK(!sigma.variable_occurs_in_a_rhs(z));
 }
 
 BOOST_AUTO_TEST_CASE(test_main)
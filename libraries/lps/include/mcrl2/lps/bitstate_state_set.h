@@ -0,0 +1,279 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/bitstate_state_set.h
+/// \brief A set of states that only stores hash values of states, as in bitstate hashing and hash compaction.
+
+#ifndef MCRL2_LPS_BITSTATE_STATE_SET_H
+#define MCRL2_LPS_BITSTATE_STATE_SET_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2::lps {
+
+/// \brief A set of states of a fixed size that only stores hash values of the states.
+/// \details With bitstate hashing (supertrace) every state sets a number of bits in a bit array, and a state is
+///          considered to be in the set if all its bits are set. With hash compaction a 64 bit fingerprint of
+///          every state is stored in a hash table. In both cases two different states can be taken to be the
+///          same, such that part of the state space may not be explored. The function coverage estimates which
+///          fraction of the states has been stored.
+///
+///          The states are not stored, so they cannot be retrieved, and they do not get consecutive indices.
+///          Instead the index of a state is its fingerprint, which identifies the state in messages. The set can
+///          be used concurrently.
+class bitstate_state_set
+{
+  public:
+    typedef std::size_t size_type;
+
+    /// \brief Value returned when a state does not occur in the set.
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    /// \brief Constructor of an empty set that uses the given number of bytes.
+    /// \param number_of_hashes The number of bits set for every state in bitstate hashing.
+    /// \param hash_compaction If true, fingerprints are stored in a hash table instead of setting bits.
+    /// \param seed Selects the hash function, such that sets with different seeds omit different states.
+    bitstate_state_set(std::size_t memory, std::size_t number_of_hashes, bool hash_compaction, std::uint64_t seed = 0)
+      : m_number_of_words(std::max<std::size_t>(memory / sizeof(std::uint64_t), 1)),
+        m_words(new std::atomic<std::uint64_t>[m_number_of_words]),
+        m_number_of_hashes(number_of_hashes),
+        m_hash_compaction(hash_compaction),
+        m_seed(seed)
+    {
+      assert(number_of_hashes > 0);
+      clear();
+    }
+
+    /// \returns The fingerprint of the given state if it occurs in the set, and npos otherwise.
+    /// \details threadsafe
+    size_type index(const state& s, std::size_t /* thread_index */ = 0) const
+    {
+      const std::uint64_t f = fingerprint(s);
+      if (m_hash_compaction)
+      {
+        for (std::size_t i = f % m_number_of_words, probes = 0; probes < m_number_of_words; i = (i + 1) % m_number_of_words, ++probes)
+        {
+          const std::uint64_t value = m_words[i].load(std::memory_order_acquire);
+          if (value == f)
+          {
+            return f;
+          }
+          if (value == 0)
+          {
+            return npos;
+          }
+        }
+        return npos;
+      }
+
+      for (std::size_t i = 0; i < m_number_of_hashes; ++i)
+      {
+        const std::size_t bit = bit_position(f, i);
+        if ((m_words[bit / 64].load(std::memory_order_relaxed) & (std::uint64_t(1) << (bit % 64))) == 0)
+        {
+          return npos;
+        }
+      }
+      return f;
+    }
+
+    /// \brief Insert a state in the set.
+    /// \returns The fingerprint of the state, and true iff it did not occur in the set yet.
+    /// \details threadsafe
+    std::pair<size_type, bool> insert(const state& s, std::size_t /* thread_index */ = 0)
+    {
+      const std::uint64_t f = fingerprint(s);
+      bool inserted = false;
+      if (m_hash_compaction)
+      {
+        std::size_t i = f % m_number_of_words;
+        for (std::size_t probes = 0; ; i = (i + 1) % m_number_of_words, ++probes)
+        {
+          if (probes == m_number_of_words)
+          {
+            throw mcrl2::runtime_error("the hash table of the hash compaction is full, the memory for the states should be increased");
+          }
+          std::uint64_t value = 0;
+          if (m_words[i].compare_exchange_strong(value, f) || value == f)
+          {
+            inserted = value == 0;
+            break;
+          }
+        }
+      }
+      else
+      {
+        for (std::size_t i = 0; i < m_number_of_hashes; ++i)
+        {
+          const std::size_t bit = bit_position(f, i);
+          const std::uint64_t mask = std::uint64_t(1) << (bit % 64);
+          if ((m_words[bit / 64].fetch_or(mask) & mask) == 0)
+          {
+            inserted = true;
+          }
+        }
+      }
+
+      if (inserted)
+      {
+        m_size.fetch_add(1);
+      }
+      return std::make_pair(f, inserted);
+    }
+
+    /// \brief The states are not stored, so this throws an exception.
+    state operator[](size_type /* index */) const
+    {
+      throw mcrl2::runtime_error("the states of a bitstate search are not stored");
+    }
+
+    /// \returns The number of states in the set.
+    /// \details threadsafe
+    size_type size(std::size_t /* thread_index */ = 0) const
+    {
+      return m_size.load(std::memory_order_acquire);
+    }
+
+    /// \brief Removes all states, this is not threadsafe.
+    void clear(std::size_t /* thread_index */ = 0)
+    {
+      for (std::size_t i = 0; i < m_number_of_words; ++i)
+      {
+        m_words[i].store(0, std::memory_order_relaxed);
+      }
+      m_size = 0;
+    }
+
+    /// \returns The number of bytes used to store the states.
+    std::size_t memory() const
+    {
+      return m_number_of_words * sizeof(std::uint64_t);
+    }
+
+    /// \returns True iff fingerprints are stored instead of bits.
+    bool hash_compaction() const
+    {
+      return m_hash_compaction;
+    }
+
+    /// \returns The number of bits set for every state in bitstate hashing.
+    std::size_t number_of_hashes() const
+    {
+      return m_number_of_hashes;
+    }
+
+    /// \returns The fraction of the memory that is in use, which is the fraction of the words that holds a fingerprint
+    ///          for hash compaction, and the expected fraction of the bits that is set, 1 - e^(-kn/m), for bitstate hashing.
+    double load_factor() const
+    {
+      const double n = static_cast<double>(size());
+      if (m_hash_compaction)
+      {
+        return n / static_cast<double>(m_number_of_words);
+      }
+      const double k = static_cast<double>(m_number_of_hashes);
+      const double m = static_cast<double>(m_number_of_words) * 64.0;
+      return 1.0 - std::exp(-k * n / m);
+    }
+
+    /// \returns An estimate of the fraction of the reachable states that has been stored.
+    /// \details When j states have been stored, a new state is wrongly found in the set with probability p(j),
+    ///          so on average p(j) / (1 - p(j)) new states are omitted before the next one is stored. For bitstate
+    ///          hashing p(j) = (1 - e^(-kj/m))^k for k hash functions and m bits, and for hash compaction the
+    ///          fingerprint of the new state equals one of the j stored fingerprints with probability j / 2^64.
+    double coverage() const
+    {
+      const double n = static_cast<double>(size());
+      if (n == 0)
+      {
+        return 1.0;
+      }
+
+      double omitted = 0.0;
+      if (m_hash_compaction)
+      {
+        omitted = n * n / (2.0 * std::pow(2.0, 64));
+      }
+      else
+      {
+        // The sum over all j < n is approximated using a fixed number of steps.
+        const double k = static_cast<double>(m_number_of_hashes);
+        const double m = static_cast<double>(m_number_of_words) * 64.0;
+        const std::size_t steps = 1000;
+        for (std::size_t i = 0; i < steps; ++i)
+        {
+          const double j = n * (i + 0.5) / steps;
+          const double p = std::pow(1.0 - std::exp(-k * j / m), k);
+          omitted += (p < 1.0 ? p / (1.0 - p) : n) * n / steps;
+        }
+      }
+      return n / (n + omitted);
+    }
+
+  private:
+    // The hash of a term is derived from its address, which changes when a state that is not stored is
+    // garbage collected and generated again. Hence the hash is computed from the structure of the term.
+    static std::uint64_t structural_hash(const atermpp::aterm& t)
+    {
+      if (t.type_is_int())
+      {
+        return combine(0x2545F4914F6CDD1Dull, atermpp::down_cast<atermpp::aterm_int>(t).value());
+      }
+
+      std::uint64_t h = combine(std::hash<std::string>()(t.function().name()), t.function().arity());
+      for (const atermpp::aterm& argument: t)
+      {
+        h = combine(h, structural_hash(argument));
+      }
+      return h;
+    }
+
+    // Combines two hash values, where all 64 bits of the result depend on both values.
+    static std::uint64_t combine(std::uint64_t h, std::uint64_t x)
+    {
+      h = ((h << 5) | (h >> 59)) ^ x;
+      return h * 0x9E3779B97F4A7C15ull;
+    }
+
+    std::uint64_t fingerprint(const state& s) const
+    {
+      // The bits of the hash are mixed such that they can be used as independent hash values (splitmix64).
+      std::uint64_t h = combine(m_seed, structural_hash(s));
+      h += 0x9E3779B97F4A7C15ull;
+      h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+      h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+      h = h ^ (h >> 31);
+      return h == 0 ? 1 : h; // Zero marks an empty position in hash compaction.
+    }
+
+    // Double hashing derives the positions of the bits of a state from its fingerprint.
+    std::size_t bit_position(std::uint64_t f, std::size_t i) const
+    {
+      const std::uint64_t h2 = (f >> 32) | 1;
+      return static_cast<std::size_t>((f + i * h2) % (m_number_of_words * 64));
+    }
+
+    std::size_t m_number_of_words;
+    std::unique_ptr<std::atomic<std::uint64_t>[]> m_words;
+    std::size_t m_number_of_hashes;
+    bool m_hash_compaction;
+    std::uint64_t m_seed;
+    std::atomic<size_type> m_size = 0;
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_BITSTATE_STATE_SET_H
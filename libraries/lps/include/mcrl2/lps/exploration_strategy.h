@@ -24,7 +24,8 @@ enum exploration_strategy { es_none,
                             es_random,
                             es_value_prioritized,
                             es_value_random_prioritized,
-                            es_highway
+                            es_highway,
+                            es_external_breadth
                           };
 
 inline
@@ -54,6 +55,10 @@ exploration_strategy parse_exploration_strategy(const std::string& s)
   {
     return es_highway;
   }
+  if (s=="e" || s == "external")
+  {
+    return es_external_breadth;
+  }
   return es_none;
 }
 
@@ -74,6 +79,8 @@ std::string print_exploration_strategy(const exploration_strategy es)
       return "rprioritized";
     case es_highway:
       return "highway";
+    case es_external_breadth:
+      return "external";
     default:
       throw mcrl2::runtime_error("unknown exploration strategy");
   }
@@ -118,6 +125,8 @@ inline std::string description(const exploration_strategy strat)
       return "prioritize actions on its first argument being of sort Nat (see option --prioritized), and randomly select one of these to obtain a prioritized random simulation (option is experimental)";
     case es_highway:
       return "highway search. Only part of the state space is explored, by restricting the size of the todo list. N.B. The implementation deviates slightly from the published version.";
+    case es_external_breadth:
+      return "breadth-first search in which the discovered states are stored on disk instead of in memory. Duplicate states are detected in batches by reading all stored states, and transitions are reported once the indices of their target states are known.";
     default:
       throw mcrl2::runtime_error("unknown exploration_strategy");
   }
@@ -12,16 +12,23 @@
 #ifndef MCRL2_LPS_EXPLORER_H
 #define MCRL2_LPS_EXPLORER_H
 
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
 #include <random>
 #include <thread>
 #include <type_traits>
 #include "mcrl2/utilities/detail/io.h"
+#include "mcrl2/utilities/fixed_size_cache.h"
 #include "mcrl2/utilities/skip.h"
+#include "mcrl2/atermpp/aterm_io_binary.h"
 #include "mcrl2/atermpp/standard_containers/deque.h"
 #include "mcrl2/atermpp/standard_containers/vector.h"
 #include "mcrl2/atermpp/standard_containers/indexed_set.h"
 #include "mcrl2/atermpp/standard_containers/detail/unordered_map_implementation.h"
 #include "mcrl2/data/consistency.h"
+#include "mcrl2/data/detail/io.h"
 #include "mcrl2/data/enumerator.h"
 #include "mcrl2/data/detail/enumerator_iteration_limit.h"
 #include "mcrl2/data/substitution_utility.h"
@@ -30,9 +37,12 @@
 #include "mcrl2/lps/find_representative.h"
 #include "mcrl2/lps/one_point_rule_rewrite.h"
 #include "mcrl2/lps/order_summand_variables.h"
+#include "mcrl2/lps/partial_order_reduction.h"
 #include "mcrl2/lps/replace_constants_by_variables.h"
 #include "mcrl2/lps/resolve_name_clashes.h"
+#include "mcrl2/lps/state_store.h"
 #include "mcrl2/lps/stochastic_state.h"
+#include "mcrl2/lps/symmetry_reduction.h"
 
 namespace mcrl2::lps {
 
@@ -88,6 +98,13 @@ class todo_set
       todo.push_back(s);
     }
 
+    // Takes an element on behalf of another thread, which is the oldest element by default.
+    virtual void steal_element(state& result)
+    {
+      result = todo.front();
+      todo.pop_front();
+    }
+
     virtual void finish_state()
     { }
 
@@ -100,6 +117,12 @@ class todo_set
     {
       return todo.size();
     }
+
+    // Returns the elements, such that inserting them in this order into an empty set yields the same set.
+    virtual std::vector<state> elements() const
+    {
+      return std::vector<state>(todo.begin(), todo.end());
+    }
 };
 
 class breadth_first_todo_set : public todo_set
@@ -206,6 +229,11 @@ class highway_todo_set : public todo_set
       todo.pop_front();
     }
 
+    void steal_element(state& result) override
+    {
+      choose_element(result);
+    }
+
     void insert(const state& s) override
     {
       if (new_states.size() < N-1)
@@ -235,11 +263,177 @@ class highway_todo_set : public todo_set
       return todo.empty() && new_states.empty();
     }
 
+    std::vector<state> elements() const override
+    {
+      std::vector<state> result(todo.begin(), todo.end());
+      std::vector<state> next = new_states.elements();
+      result.insert(result.end(), next.begin(), next.end());
+      return result;
+    }
+
     void finish_state() override
     {
     }
 };
 
+/// \brief The amount of work done by one thread during the exploration.
+struct work_stealing_statistics
+{
+  std::size_t explored = 0; // The number of states of which the outgoing transitions were explored.
+  std::size_t steals = 0;   // The number of times that states were taken from another thread.
+  std::size_t stolen = 0;   // The number of states that were taken from other threads.
+};
+
+/// \brief A todo set per thread, where a thread without states takes states from the todo sets of the other threads.
+/// \details Each thread inserts and chooses states in its own todo set according to the search strategy. A thread
+///          that runs out of states becomes idle and steals half of the states of another thread, which are the
+///          oldest states unless highway search is used. Hence, breadth first search remains approximately breadth
+///          first. A thread only becomes idle when its own todo set is empty, and an idle thread stops being idle
+///          before it takes states from another thread. So when all threads are idle, all todo sets are empty and
+///          the exploration has terminated.
+class work_stealing_todo_sets
+{
+  protected:
+    struct thread_todo_set
+    {
+      std::unique_ptr<todo_set> todo;
+      mutable std::mutex mutex;
+      std::atomic<std::size_t> size = 0; // The size of todo, which can be read without obtaining the mutex.
+      std::mt19937 generator;            // Used to choose the thread from which states are stolen.
+      work_stealing_statistics statistics;
+    };
+
+    std::vector<std::unique_ptr<thread_todo_set>> m_todo_sets;
+    std::atomic<std::size_t> m_number_of_idle_threads = 0;
+
+    // Moves half of the states of thread j to thread i, and returns the number of moved states.
+    std::size_t steal(std::size_t i, std::size_t j)
+    {
+      thread_todo_set& thief = *m_todo_sets[i];
+      thread_todo_set& victim = *m_todo_sets[j];
+      std::scoped_lock guard(thief.mutex, victim.mutex);
+      const std::size_t n = (victim.todo->size() + 1) / 2;
+      state s;
+      for (std::size_t k = 0; k < n; ++k)
+      {
+        victim.todo->steal_element(s);
+        thief.todo->insert(s);
+      }
+      victim.size = victim.todo->size();
+      thief.size = thief.todo->size();
+      return n;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param make_todo_set A function that returns an empty todo set for one thread.
+    template <typename MakeTodoSet>
+    work_stealing_todo_sets(std::size_t number_of_threads, MakeTodoSet make_todo_set)
+    {
+      m_todo_sets.reserve(number_of_threads);
+      for (std::size_t i = 0; i < number_of_threads; ++i)
+      {
+        m_todo_sets.push_back(std::make_unique<thread_todo_set>());
+        m_todo_sets.back()->todo = make_todo_set();
+        m_todo_sets.back()->generator.seed(i);
+      }
+    }
+
+    void insert(std::size_t i, const state& s)
+    {
+      thread_todo_set& t = *m_todo_sets[i];
+      std::lock_guard<std::mutex> guard(t.mutex);
+      t.todo->insert(s);
+      t.size = t.todo->size();
+    }
+
+    /// \brief Chooses a state from the todo set of thread i.
+    /// \returns False iff the todo set of thread i is empty.
+    bool choose_element(std::size_t i, state& result)
+    {
+      thread_todo_set& t = *m_todo_sets[i];
+      std::lock_guard<std::mutex> guard(t.mutex);
+      if (t.todo->empty())
+      {
+        return false;
+      }
+      t.todo->choose_element(result);
+      t.size = t.todo->size();
+      t.statistics.explored++;
+      return true;
+    }
+
+    void finish_state(std::size_t i)
+    {
+      thread_todo_set& t = *m_todo_sets[i];
+      std::lock_guard<std::mutex> guard(t.mutex);
+      t.todo->finish_state();
+    }
+
+    std::size_t size(std::size_t i) const
+    {
+      return m_todo_sets[i]->size.load(std::memory_order_relaxed);
+    }
+
+    /// \brief Lets thread i, of which the todo set is empty, wait until it has stolen states from another thread.
+    /// \returns False iff all threads are idle or must_abort is set, in which case the thread must stop.
+    bool wait_for_states(std::size_t i, const volatile std::atomic<bool>& must_abort)
+    {
+      const std::size_t number_of_threads = m_todo_sets.size();
+      thread_todo_set& thief = *m_todo_sets[i];
+      m_number_of_idle_threads++;
+      while (m_number_of_idle_threads < number_of_threads && !must_abort.load(std::memory_order_relaxed))
+      {
+        const std::size_t offset = std::uniform_int_distribution<std::size_t>(0, number_of_threads - 1)(thief.generator);
+        for (std::size_t k = 0; k < number_of_threads; ++k)
+        {
+          const std::size_t j = (offset + k) % number_of_threads;
+          if (j == i || size(j) == 0)
+          {
+            continue;
+          }
+
+          // This thread must not be idle while it holds states, otherwise all threads could be idle prematurely.
+          m_number_of_idle_threads--;
+          const std::size_t n = steal(i, j);
+          if (n > 0)
+          {
+            thief.statistics.steals++;
+            thief.statistics.stolen += n;
+            return true;
+          }
+          m_number_of_idle_threads++;
+        }
+        std::this_thread::yield();
+      }
+      return false;
+    }
+
+    /// \returns The states in the todo sets of all threads.
+    std::vector<state> elements() const
+    {
+      std::vector<state> result;
+      for (const std::unique_ptr<thread_todo_set>& t: m_todo_sets)
+      {
+        std::lock_guard<std::mutex> guard(t->mutex);
+        std::vector<state> elements = t->todo->elements();
+        result.insert(result.end(), elements.begin(), elements.end());
+      }
+      return result;
+    }
+
+    /// \returns The amount of work done by every thread.
+    std::vector<work_stealing_statistics> statistics() const
+    {
+      std::vector<work_stealing_statistics> result;
+      for (const std::unique_ptr<thread_todo_set>& t: m_todo_sets)
+      {
+        result.push_back(t->statistics);
+      }
+      return result;
+    }
+};
+
 template <typename Summand>
 inline const stochastic_distribution& summand_distribution(const Summand& /* summand */)
 {
@@ -344,6 +538,217 @@ typedef atermpp::utilities::unordered_map<atermpp::aterm,
                                           true  // Thread_safe.
                                         > summand_cache_map;
 
+/// \brief The number of hits, misses and evictions of the enumeration caches of summands.
+struct summand_cache_statistics
+{
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+  std::size_t size = 0; // The number of cached enumeration results.
+
+  summand_cache_statistics& operator+=(const summand_cache_statistics& other)
+  {
+    hits += other.hits;
+    misses += other.misses;
+    evictions += other.evictions;
+    size += other.size;
+    return *this;
+  }
+};
+
+inline
+std::ostream& operator<<(std::ostream& out, const summand_cache_statistics& statistics)
+{
+  return out << statistics.hits << " hits, " << statistics.misses << " misses, "
+             << statistics.evictions << " evictions and " << statistics.size << " cached enumeration results";
+}
+
+/// \brief Caches the solutions of the condition of a summand for the values of the parameters that occur in it.
+/// \details Without a maximum size all solutions are kept in a thread safe map. Otherwise, the least recently used
+///          solutions are evicted using the CLOCK replacement policy, in which case accesses are serialised by a mutex.
+class summand_cache
+{
+  public:
+    typedef atermpp::term_list<data::data_expression_list> solutions_type;
+
+    /// \brief Constructor.
+    /// \param max_size The maximum number of cached solutions, where 0 means that it is unbounded.
+    explicit summand_cache(std::size_t max_size = 0)
+    {
+      if (max_size > 0)
+      {
+        m_bounded_cache = std::make_unique<bounded_cache_type>(max_size);
+      }
+    }
+
+    summand_cache(const summand_cache& other)
+      : m_cache(other.m_cache)
+    {
+      if (other.m_bounded_cache)
+      {
+        m_bounded_cache = std::make_unique<bounded_cache_type>(*other.m_bounded_cache);
+      }
+    }
+
+    summand_cache& operator=(const summand_cache& other)
+    {
+      m_cache = other.m_cache;
+      m_bounded_cache = other.m_bounded_cache ? std::make_unique<bounded_cache_type>(*other.m_bounded_cache) : nullptr;
+      return *this;
+    }
+
+    /// \brief Looks up the solutions for the values that sigma assigns to the variables in gamma.
+    /// \returns True iff the solutions were cached, in which case they are assigned to solutions.
+    /// \details threadsafe
+    bool find(data::mutable_indexed_substitution<>& sigma, const std::vector<data::variable>& gamma, solutions_type& solutions)
+    {
+      bool found = false;
+      if (m_bounded_cache)
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto q = m_bounded_cache->find(detail::cheap_cache_key(sigma, gamma));
+        if (q != m_bounded_cache->end())
+        {
+          solutions = q->second;
+          found = true;
+        }
+      }
+      else
+      {
+        // The cache could be resized while the result of find is used, which the lock prevents.
+        utilities::shared_guard guard = atermpp::detail::g_thread_term_pool().lock_shared();
+        auto q = m_cache.find(detail::cheap_cache_key(sigma, gamma));
+        if (q != m_cache.end())
+        {
+          solutions = q->second;
+          found = true;
+        }
+      }
+
+      (found ? m_hits : m_misses).fetch_add(1, std::memory_order_relaxed);
+      return found;
+    }
+
+    /// \brief Stores the solutions for the given key, which possibly evicts other solutions.
+    /// \details threadsafe
+    void insert(const atermpp::aterm& key, const solutions_type& solutions)
+    {
+      if (m_bounded_cache)
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        const std::size_t size = m_bounded_cache->size();
+        if (m_bounded_cache->emplace(key, solutions).second && m_bounded_cache->size() == size)
+        {
+          m_evictions.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      else
+      {
+        m_cache.insert({key, solutions});
+      }
+    }
+
+    /// \returns The number of lookups that found cached solutions and the number of lookups that did not.
+    /// \details threadsafe
+    std::pair<std::size_t, std::size_t> hits_and_misses() const
+    {
+      return { m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed) };
+    }
+
+    summand_cache_statistics statistics() const
+    {
+      summand_cache_statistics result;
+      result.hits = m_hits.load(std::memory_order_relaxed);
+      result.misses = m_misses.load(std::memory_order_relaxed);
+      result.evictions = m_evictions.load(std::memory_order_relaxed);
+      result.size = m_bounded_cache ? m_bounded_cache->size() : m_cache.size();
+      return result;
+    }
+
+  private:
+    typedef utilities::fixed_size_cache<utilities::clock_policy<summand_cache_map>> bounded_cache_type;
+
+    summand_cache_map m_cache;
+    std::unique_ptr<bounded_cache_type> m_bounded_cache;
+    std::mutex m_mutex;
+
+    std::atomic<std::size_t> m_hits{0};
+    std::atomic<std::size_t> m_misses{0};
+    std::atomic<std::size_t> m_evictions{0};
+};
+
+/// \brief The work that was done for a summand, which is only measured when metrics are enabled.
+struct explorer_summand_metrics
+{
+  std::size_t visits = 0;           // The number of states for which the summand was enumerated.
+  std::size_t transitions = 0;      // The number of transitions generated by the summand.
+  std::chrono::nanoseconds time{0}; // The time spent in the enumeration of the summand.
+};
+
+/// \brief A snapshot of the work done by all threads of the explorer.
+struct explorer_metrics
+{
+  std::size_t rewrites = 0;  // The number of calls of the rewriter outside the enumerator.
+  std::size_t cache_hits = 0;
+  std::size_t cache_misses = 0;
+  std::vector<explorer_summand_metrics> summands; // Indexed by the summand index.
+};
+
+namespace detail
+{
+
+// Adds n to a counter that is only written by the current thread, which avoids an atomic read-modify-write.
+template <typename T>
+void add_relaxed(std::atomic<T>& counter, T n)
+{
+  counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// The counters of a single thread, which are read by other threads to report intermediate metrics.
+struct alignas(64) explorer_thread_counters
+{
+  struct summand_counters
+  {
+    std::atomic<std::size_t> visits{0};
+    std::atomic<std::size_t> transitions{0};
+    std::atomic<std::chrono::nanoseconds::rep> time{0};
+  };
+
+  std::atomic<std::size_t> rewrites{0};
+  std::vector<summand_counters> summands;
+
+  explicit explorer_thread_counters(std::size_t number_of_summands)
+    : summands(number_of_summands)
+  {}
+};
+
+// The counters of the thread that is exploring, which are only set when metrics are enabled.
+inline thread_local explorer_thread_counters* current_thread_counters = nullptr;
+
+// Sets the counters of the current thread, and restores the previous ones when it goes out of scope. The
+// previous counters are those of another explorer when the callbacks of this thread use a second explorer.
+class thread_counters_guard
+{
+  public:
+    explicit thread_counters_guard(explorer_thread_counters* counters)
+      : m_previous(current_thread_counters)
+    {
+      current_thread_counters = counters;
+    }
+
+    thread_counters_guard(const thread_counters_guard&) = delete;
+    thread_counters_guard& operator=(const thread_counters_guard&) = delete;
+
+    ~thread_counters_guard()
+    {
+      current_thread_counters = m_previous;
+    }
+
+  private:
+    explorer_thread_counters* m_previous;
+};
+
+} // namespace detail
 
 struct explorer_summand
 {
@@ -358,17 +763,18 @@ struct explorer_summand
   caching cache_strategy;
   std::vector<data::variable> gamma;
   atermpp::function_symbol f_gamma;
-  mutable summand_cache_map local_cache;
+  mutable summand_cache local_cache;
 
   template <typename ActionSummand>
-  explorer_summand(const ActionSummand& summand, std::size_t summand_index, const data::variable_list& process_parameters, caching cache_strategy_)
+  explorer_summand(const ActionSummand& summand, std::size_t summand_index, const data::variable_list& process_parameters, caching cache_strategy_, std::size_t cache_size = 0)
     : variables(summand.summation_variables()),
       condition(summand.condition()),
       multi_action(summand.multi_action()),
       distribution(summand_distribution(summand)),
       next_state(make_data_expression_vector(summand.next_state(process_parameters))),
       index(summand_index),
-      cache_strategy(cache_strategy_)
+      cache_strategy(cache_strategy_),
+      local_cache(cache_size)
   {
     gamma = free_variables(summand.condition(), process_parameters);
     if (cache_strategy_ == caching::global)
@@ -452,7 +858,7 @@ class explorer: public abortable
     static constexpr bool is_stochastic = Stochastic;
     static constexpr bool is_timed = Timed;
 
-    typedef atermpp::indexed_set<state, mcrl2::utilities::detail::GlobalThreadSafe> indexed_set_for_states_type;
+    typedef state_store indexed_set_for_states_type;
 
 
     struct transition
@@ -476,8 +882,6 @@ class explorer: public abortable
     data::enumerator_identifier_generator m_global_id_generator;
 
     Specification m_global_lpsspec;
-    // Mutexes
-    std::mutex m_exclusive_state_access;
 
     std::vector<data::variable> m_process_parameters;
     std::size_t m_n; // m_n = m_process_parameters.size()
@@ -490,13 +894,42 @@ class explorer: public abortable
     volatile std::atomic<bool> m_must_abort = false;
 
     // N.B. The keys are stored in term_appl instead of data_expression_list for performance reasons.
-    summand_cache_map global_cache;
+    summand_cache global_cache;
 
     indexed_set_for_states_type m_discovered;
 
+    // The amount of work done by every thread in the last exploration.
+    std::vector<work_stealing_statistics> m_work_statistics;
+
+    // The relations between the regular summands for partial-order reduction, which is disabled if it is empty.
+    std::unique_ptr<stubborn_sets> m_stubborn_sets;
+    std::atomic<std::size_t> m_reduced_states = 0;  // The number of states of which only a stubborn set is explored.
+    std::atomic<std::size_t> m_proviso_states = 0;  // The number of states that are fully explored due to the cycle proviso.
+
+    // The groups of symmetric process parameters, symmetry reduction is disabled if it is empty.
+    std::unique_ptr<symmetry_reduction> m_symmetry;
+
+    // Write and read the state of the caller of generate_state_space to and from checkpoints.
+    std::function<void(atermpp::aterm_ostream&)> m_save_checkpoint;
+    std::function<void(atermpp::aterm_istream&)> m_load_checkpoint;
+    std::chrono::steady_clock::time_point m_next_checkpoint;
+
     // used by make_timed_state, to avoid needless creation of vectors
     mutable std::vector<data::data_expression> timed_state;
 
+    // The counters of every thread, indexed by thread index, which are only maintained when metrics are enabled.
+    const bool m_metrics_enabled;
+    std::vector<std::unique_ptr<detail::explorer_thread_counters>> m_thread_counters;
+
+    // Adds n to the number of rewriter calls of the current thread when metrics are enabled.
+    void count_rewrites(std::size_t n) const
+    {
+      if (m_metrics_enabled && detail::current_thread_counters != nullptr)
+      {
+        detail::add_relaxed(detail::current_thread_counters->rewrites, n);
+      }
+    }
+
     Specification preprocess(const Specification& lpsspec)
     {
       Specification result = lpsspec;
@@ -520,6 +953,7 @@ class explorer: public abortable
                     data::mutable_indexed_substitution<>& sigma,
                     data::rewriter& rewr) const
     {
+      count_rewrites(1);
       return rewr(data::less_equal(t0, t1),sigma) == data::sort_bool::true_();
     }
 
@@ -549,6 +983,7 @@ class explorer: public abortable
                        data::mutable_indexed_substitution<>& sigma,
                        data::rewriter& rewr) const
     {
+      count_rewrites(m_n);
       lps::make_state(result, 
                       v.begin(), 
                       m_n, 
@@ -615,7 +1050,7 @@ class explorer: public abortable
                                                                      args.end(), 
                                                                      [&](data::data_expression& result, 
                                                                          const data::data_expression& x) -> void
-                                                                                 { rewr(result, x, sigma); }));     
+                                                                                 { count_rewrites(1); rewr(result, x, sigma); }));     
             }
           ),
           a.has_time() ? rewr(time, sigma) : time
@@ -663,6 +1098,7 @@ class explorer: public abortable
       }
       if (summand.cache_strategy == caching::none)
       {
+        count_rewrites(1);
         rewr(condition, summand.condition, sigma);
         if (!data::is_false(condition))
         {
@@ -682,6 +1118,10 @@ class explorer: public abortable
               {
                 s1 = find_representative(s1, confluent_summands, sigma, rewr, enumerator, id_generator); 
               }
+              if (m_symmetry)
+              {
+                m_symmetry->canonicalize(s1);
+              }
             }
             // Check whether report transition only needs a state, and no action.
             if constexpr (utilities::is_applicable<ReportTransition,state_type,void>::value)
@@ -723,6 +1163,10 @@ class explorer: public abortable
                             {
                               s1 = find_representative(s1, confluent_summands, sigma, rewr, enumerator, id_generator);
                             }
+                            if (m_symmetry)
+                            {
+                              m_symmetry->canonicalize(s1);
+                            }
                           }
                           if (m_recursive && variables_are_assigned_to_sigma)
                           {
@@ -755,16 +1199,12 @@ class explorer: public abortable
       }
       else
       {
-        summand_cache_map& cache = summand.cache_strategy == caching::global ? global_cache : summand.local_cache;
-        // The result of find is sometimes compared with the "end()" below, where the end() belongs to 
-        // the cache which is resized in the meantime. The lock is needed to avoid this premature resizing. 
-        utilities::shared_guard g=atermpp::detail::g_thread_term_pool().lock_shared();
-        summand_cache_map::iterator q = cache.find(detail::cheap_cache_key(sigma, summand.gamma));
-        if (q == cache.end())
+        summand_cache& cache = summand.cache_strategy == caching::global ? global_cache : summand.local_cache;
+        summand_cache::solutions_type solutions;
+        if (!cache.find(sigma, summand.gamma, solutions))
         {
-          g.unlock_shared();
+          count_rewrites(1);
           rewr(condition, summand.condition, sigma);
-          atermpp::term_list<data::data_expression_list> solutions;
           if (!data::is_false(condition))
           {
             enumerator.enumerate<enumerator_element>(
@@ -780,14 +1220,10 @@ class explorer: public abortable
                       );
           }
           summand.compute_key(key, sigma);
-          q = cache.insert({key, solutions}).first;
-        }
-        else
-        {
-          g.unlock_shared();
+          cache.insert(key, solutions);
         }
 
-        for (const data::data_expression_list& e: static_cast<atermpp::term_list<data::data_expression_list>&>(q->second))
+        for (const data::data_expression_list& e: solutions)
         {
           data::add_assignments(sigma, summand.variables, e);
           variables_are_assigned_to_sigma=true;
@@ -802,6 +1238,10 @@ class explorer: public abortable
             {
               s1 = find_representative(s1, confluent_summands, sigma, rewr, enumerator, id_generator);
             }
+            if (m_symmetry)
+            {
+              m_symmetry->canonicalize(s1);
+            }
           }
           if (m_recursive && variables_are_assigned_to_sigma)
           {
@@ -971,6 +1411,33 @@ class explorer: public abortable
       }
     }
 
+    // Decides whether the occurrences of an action must be preserved by partial-order reduction.
+    bool is_visible(const multi_action& a) const
+    {
+      if (m_options.trace_actions.empty() && m_options.trace_multiactions.empty())
+      {
+        return !a.actions().empty();
+      }
+      for (const process::action& x: a.actions())
+      {
+        if (m_options.trace_actions.count(x.label().name()) > 0)
+        {
+          return true;
+        }
+        for (const multi_action& m: m_options.trace_multiactions)
+        {
+          for (const process::action& y: m.actions())
+          {
+            if (x.label() == y.label())
+            {
+              return true;
+            }
+          }
+        }
+      }
+      return false;
+    }
+
     bool is_confluent_tau(const multi_action& a)
     {
       if (a.actions().empty())
@@ -990,12 +1457,45 @@ class explorer: public abortable
         m_global_rewr(construct_rewriter(lpsspec, m_options.remove_unused_rewrite_rules)),
         m_global_enumerator(m_global_rewr, lpsspec.data(), m_global_rewr, m_global_id_generator, false),
         m_global_lpsspec(preprocess(lpsspec)),
-        m_discovered(m_options.number_of_threads)
+        global_cache(m_options.cache_size),
+        m_discovered(m_options.number_of_threads),
+        m_metrics_enabled(!m_options.metrics_filename.empty())
     {
       const data::variable_list& params = m_global_lpsspec.process().process_parameters();
       m_process_parameters = std::vector<data::variable>(params.begin(), params.end());
       m_n = m_process_parameters.size();
       timed_state.resize(m_n + 1);
+      if (m_options.tree_compression)
+      {
+        // Timed states contain the time as an additional parameter.
+        m_discovered.enable_tree_compression(Timed ? m_n + 1 : m_n);
+      }
+      else if (m_options.number_of_shards > 0)
+      {
+        m_discovered.enable_sharding(m_options.number_of_shards);
+      }
+      if (m_options.bitstate_memory > 0)
+      {
+        if (m_options.tree_compression || m_options.number_of_shards > 0 || !m_options.checkpoint_filename.empty() || m_options.search_strategy == es_external_breadth)
+        {
+          throw mcrl2::runtime_error("Bitstate hashing cannot be combined with tree compression, shards, checkpoints or external search.");
+        }
+        m_discovered.enable_bitstate_hashing(m_options.bitstate_memory, m_options.bitstate_hashes, m_options.hash_compaction, m_options.random_seed);
+      }
+      if (m_options.search_strategy == es_external_breadth)
+      {
+        if (Stochastic || m_options.number_of_threads > 1 || m_options.tree_compression || m_options.number_of_shards > 0 || !m_options.checkpoint_filename.empty())
+        {
+          throw mcrl2::runtime_error("External breadth-first search is only supported for non stochastic specifications that are explored by a single thread, "
+                                     "without tree compression, shards or checkpoints.");
+        }
+        m_discovered.enable_external_storage(m_options.external_directory.empty() ? std::filesystem::temp_directory_path()
+                                                                                  : std::filesystem::path(m_options.external_directory));
+      }
+      if (!m_options.checkpoint_filename.empty() && (Stochastic || m_options.number_of_threads > 1))
+      {
+        throw mcrl2::runtime_error("Checkpoints are only supported for non stochastic specifications that are explored by a single thread.");
+      }
       m_initial_state = m_global_lpsspec.initial_process().expressions();
       m_initial_distribution = initial_distribution(m_global_lpsspec);
 
@@ -1007,11 +1507,57 @@ class explorer: public abortable
         caching cache_strategy = m_options.cached ? (m_options.global_cache ? lps::caching::global : lps::caching::local) : lps::caching::none;
         if (is_confluent_tau(summand.multi_action()))
         {
-          m_confluent_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy);
+          m_confluent_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy, m_options.cache_size);
         }
         else
         {
-          m_regular_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy);
+          m_regular_summands.emplace_back(summand, i, m_global_lpsspec.process().process_parameters(), cache_strategy, m_options.cache_size);
+        }
+      }
+
+      if (m_options.random_seed != 0)
+      {
+        std::mt19937 generator(m_options.random_seed);
+        std::shuffle(m_regular_summands.begin(), m_regular_summands.end(), generator);
+      }
+
+      if (m_metrics_enabled)
+      {
+        // Threads are numbered from 1 when there are several, and thread 0 is used otherwise.
+        for (std::size_t i = 0; i <= m_options.number_of_threads; ++i)
+        {
+          m_thread_counters.push_back(std::make_unique<detail::explorer_thread_counters>(lpsspec_summands.size()));
+        }
+      }
+
+      if (m_options.partial_order_reduction != partial_order_reduction_mode::none)
+      {
+        if (Stochastic || Timed || !m_confluent_summands.empty() || m_options.search_strategy == es_external_breadth)
+        {
+          throw mcrl2::runtime_error("Partial-order reduction is only supported for untimed, non stochastic specifications without confluent summands, "
+                                     "and it cannot be combined with external search.");
+        }
+        m_stubborn_sets = std::make_unique<stubborn_sets>(m_regular_summands, m_process_parameters, m_options.partial_order_reduction,
+                                                          [&](const multi_action& a) { return is_visible(a); },
+                                                          [&](const data::data_expression& e) { return m_global_rewr(e, m_global_sigma); });
+      }
+
+      if (!m_options.symmetry.empty())
+      {
+        if (Stochastic || !m_confluent_summands.empty() || m_options.partial_order_reduction != partial_order_reduction_mode::none)
+        {
+          throw mcrl2::runtime_error("Symmetry reduction is only supported for non stochastic specifications without confluent summands, "
+                                     "and it cannot be combined with partial-order reduction.");
+        }
+        m_symmetry = std::make_unique<symmetry_reduction>(m_global_lpsspec, m_options.symmetry);
+        if (m_symmetry->empty())
+        {
+          mCRL2log(log::warning) << "No symmetric process parameters were found, symmetry reduction has no effect." << std::endl;
+          m_symmetry.reset();
+        }
+        else
+        {
+          mCRL2log(log::verbose) << "Symmetry reduction with the groups " << print_symmetry_groups(*m_symmetry, m_global_lpsspec.process().process_parameters()) << "." << std::endl;
         }
       }
     }
@@ -1074,6 +1620,80 @@ class explorer: public abortable
       return s;
     }
 
+    // Writes the discovered states, the states that remain to be explored and the state of the caller to the
+    // checkpoint file. The file is replaced at once, such that it always contains a complete checkpoint.
+    void save_checkpoint(const work_stealing_todo_sets& todo, const indexed_set_for_states_type& discovered)
+    {
+      const std::string temporary_filename = m_options.checkpoint_filename + ".tmp";
+      std::vector<state> frontier = todo.elements();
+      {
+        std::ofstream stream(temporary_filename, std::ios::binary);
+        if (!stream.is_open())
+        {
+          throw mcrl2::runtime_error("cannot open '" + temporary_filename + "' for writing");
+        }
+
+        atermpp::binary_aterm_ostream out(stream);
+        out << data::detail::remove_index_impl;
+        out << m_global_lpsspec.process().process_parameters();
+        out << atermpp::aterm_int(discovered.size());
+        for (std::size_t i = 0; i < discovered.size(); ++i)
+        {
+          out << discovered[i];
+        }
+        out << frontier;
+        if (m_save_checkpoint)
+        {
+          m_save_checkpoint(out);
+        }
+      }
+      std::filesystem::rename(temporary_filename, m_options.checkpoint_filename);
+      mCRL2log(log::verbose) << "Saved a checkpoint of " << discovered.size() << " states, of which " << frontier.size()
+                             << " are not explored yet, to '" << m_options.checkpoint_filename << "'.\n";
+    }
+
+    // Restores the discovered states and the states that remain to be explored from the checkpoint file, after
+    // which the state of the caller is read.
+    void load_checkpoint(work_stealing_todo_sets& todo, indexed_set_for_states_type& discovered)
+    {
+      std::ifstream stream(m_options.checkpoint_filename, std::ios::binary);
+      if (!stream.is_open())
+      {
+        throw mcrl2::runtime_error("cannot open checkpoint '" + m_options.checkpoint_filename + "' for reading");
+      }
+
+      atermpp::binary_aterm_istream in(stream);
+      in >> data::detail::add_index_impl;
+      data::variable_list parameters;
+      in >> parameters;
+      if (parameters != m_global_lpsspec.process().process_parameters())
+      {
+        throw mcrl2::runtime_error("the checkpoint '" + m_options.checkpoint_filename + "' does not belong to this specification");
+      }
+
+      atermpp::aterm_int number_of_states;
+      in >> number_of_states;
+      state s;
+      for (std::size_t i = 0; i < number_of_states.value(); ++i)
+      {
+        in >> s;
+        discovered.insert(s);
+      }
+
+      std::vector<state> frontier;
+      in >> frontier;
+      for (const state& s: frontier)
+      {
+        todo.insert(0, s);
+      }
+      if (m_load_checkpoint)
+      {
+        m_load_checkpoint(in);
+      }
+      mCRL2log(log::verbose) << "Resuming from the checkpoint '" << m_options.checkpoint_filename << "' with " << discovered.size()
+                             << " states, of which " << frontier.size() << " are not explored yet.\n";
+    }
+
     template <
       typename StateType,
       typename SummandSequence,
@@ -1084,10 +1704,8 @@ class explorer: public abortable
       typename DiscoverInitialState = utilities::skip
     >
     void generate_state_space_thread(
-      std::unique_ptr<todo_set>& todo,
+      work_stealing_todo_sets& todo,
       const std::size_t thread_index,
-      std::atomic<std::size_t>& number_of_active_processes,
-      std::atomic<std::size_t>& number_of_idle_processes,
       const SummandSequence& regular_summands,
       const SummandSequence& confluent_summands,
       indexed_set_for_states_type& discovered,
@@ -1107,152 +1725,339 @@ class explorer: public abortable
       state current_state;
       data::data_expression condition;   // The condition is used often, and it is effective not to declare it whenever it is used.
       state_type state_;                 // The same holds for state.
-      std::vector<state> dummy;
-      std::unique_ptr<todo_set> thread_todo=make_todo_set(dummy.begin(),dummy.end()); // The new states for each process are temporarily stored in this vector for each thread. 
       atermpp::aterm key;
+      const std::size_t todo_index = thread_index == 0 ? 0 : thread_index - 1; // Threads are numbered from 1 when there are several.
+
+      detail::explorer_thread_counters* const counters = m_metrics_enabled ? m_thread_counters[thread_index].get() : nullptr;
+      detail::thread_counters_guard counters_guard(counters);
 
-      if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
-      while (number_of_active_processes>0 || !todo->empty())
+      while (!m_must_abort.load(std::memory_order_relaxed))
       {
-        assert(m_must_abort || thread_todo->empty());
-          
-        if (!todo->empty())
+        if (!todo.choose_element(todo_index, current_state))
         {
-          todo->choose_element(current_state);
-          thread_todo->insert(current_state);
-          if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
-
-          while (!thread_todo->empty() && !m_must_abort.load(std::memory_order_relaxed))
-          { 
-            thread_todo->choose_element(current_state);
-            std::size_t s_index = discovered.index(current_state,thread_index);
-            start_state(thread_index, current_state, s_index);
-            data::add_assignments(thread_sigma, m_process_parameters, current_state);
-            for (const explorer_summand& summand: regular_summands)
+          if (todo.wait_for_states(todo_index, m_must_abort))
+          {
+            continue;
+          }
+          break;
+        }
+
+        std::size_t s_index = discovered.index(current_state,thread_index);
+        start_state(thread_index, current_state, s_index);
+        data::add_assignments(thread_sigma, m_process_parameters, current_state);
+        auto report_transition = [&](const explorer_summand& summand, const lps::multi_action& a, const state_type& s1)
             {   
-              generate_transitions(
-                summand,
-                confluent_summands,
-                thread_sigma,
-                thread_rewr,
-                condition,
-                state_,
-                key,
-                thread_enumerator,
-                thread_id_generator,
-                [&](const lps::multi_action& a, const state_type& s1)
-                {   
-                  if constexpr (Timed)
+              if constexpr (Timed)
+              { 
+                const data::data_expression& t = current_state[m_n];
+                if (a.has_time() && less_equal(a.time(), t, thread_sigma, thread_rewr))
+                {
+                  return;
+                }
+              } 
+              if (counters != nullptr)
+              {
+                detail::add_relaxed(counters->summands[summand.index].transitions, std::size_t(1));
+              }
+              if constexpr (Stochastic)
+              { 
+                std::list<std::size_t> s1_index;
+                const auto& S1 = s1.states;
+                // TODO: join duplicate targets
+                for (const state& s1_: S1)
+                { 
+                  std::pair<std::size_t,bool> p = discovered.insert(s1_, thread_index);
+                  if (p.second)  // Index is newly added.
                   { 
+                    todo.insert(todo_index, s1_);
+                    discover_state(thread_index, s1_, p.first);
+                  }
+                  s1_index.push_back(p.first);
+                }
+
+                examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand.index);
+              } 
+              else 
+              { 
+                std::size_t s1_index; 
+                if constexpr (Timed)
+                { 
+                  s1_index = discovered.index(s1,thread_index);
+                  if (s1_index >= discovered.size())
+                  {   
                     const data::data_expression& t = current_state[m_n];
-                    if (a.has_time() && less_equal(a.time(), t, thread_sigma, thread_rewr))
-                    {
-                      return;
-                    }
+                    const data::data_expression& t1 = a.has_time() ? a.time() : t;
+                    make_timed_state(state_, s1, t1);
+                    s1_index = discovered.insert(state_, thread_index).first;
+                    discover_state(thread_index, state_, s1_index);
+                    todo.insert(todo_index, state_);
                   } 
-                  if constexpr (Stochastic)
-                  { 
-                    std::list<std::size_t> s1_index;
-                    const auto& S1 = s1.states;
-                    // TODO: join duplicate targets
-                    for (const state& s1_: S1)
-                    { 
-                      std::size_t k = discovered.index(s1_,thread_index);
-                      if (k >= discovered.size())
-                      { 
-                        thread_todo->insert(s1_);
-                        k = discovered.insert(s1_, thread_index).first;
-                        discover_state(thread_index, s1_, k);
-                      }
-                      s1_index.push_back(k);
-                    }
-
-                    examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand.index);
-                  } 
-                  else 
-                  { 
-                    std::size_t s1_index; 
-                    if constexpr (Timed)
-                    { 
-                      s1_index = discovered.index(s1,thread_index);
-                      if (s1_index >= discovered.size())
-                      {   
-                        const data::data_expression& t = current_state[m_n];
-                        const data::data_expression& t1 = a.has_time() ? a.time() : t;
-                        make_timed_state(state_, s1, t1);
-                        s1_index = discovered.insert(state_, thread_index).first;
-                        discover_state(thread_index, state_, s1_index);
-                        thread_todo->insert(state_);
-                      } 
-                    }
-                    else
-                    { 
-                      std::pair<std::size_t,bool> p = discovered.insert(s1, thread_index);
-                      s1_index=p.first;
-                      if (p.second)  // Index is newly added. 
-                      {
-                        discover_state(thread_index, s1, s1_index);
-                        thread_todo->insert(s1); 
-                      }
-                    }
-
-                    examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand.index);
+                }
+                else
+                { 
+                  std::pair<std::size_t,bool> p = discovered.insert(s1, thread_index);
+                  s1_index=p.first;
+                  if (p.second)  // Index is newly added. 
+                  {
+                    discover_state(thread_index, s1, s1_index);
+                    todo.insert(todo_index, s1); 
                   }
                 }
-              );
-            }
 
-            if (number_of_idle_processes>0 && thread_todo->size()>1)
-            {
-              if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
+                examine_transition(thread_index, m_options.number_of_threads, current_state, s_index, a, s1, s1_index, summand.index);
+              }
+            };
 
-              if (todo->size() < m_options.number_of_threads) 
+        if (m_stubborn_sets)
+        {
+          if constexpr (!Stochastic)
+          {
+            generate_stubborn_set_transitions(regular_summands, confluent_summands, discovered, thread_index, thread_sigma, thread_rewr,
+                                              condition, state_, key, thread_enumerator, thread_id_generator, report_transition);
+          }
+        }
+        else
+        {
+          for (const explorer_summand& summand: regular_summands)
+          {
+            const auto start = counters != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            generate_transitions(
+              summand,
+              confluent_summands,
+              thread_sigma,
+              thread_rewr,
+              condition,
+              state_,
+              key,
+              thread_enumerator,
+              thread_id_generator,
+              [&](const lps::multi_action& a, const state_type& s1)
               {
-                // move 25% of the states of this thread to the global todo buffer.
-                for(std::size_t i=0; i<std::min(thread_todo->size()-1,1+(thread_todo->size()/4)); ++i)  
-                {
-                  thread_todo->choose_element(current_state);
-                  todo->insert(current_state);
-                }
+                report_transition(summand, a, s1);
               }
-
-              if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
+            );
+            if (counters != nullptr)
+            {
+              detail::explorer_thread_counters::summand_counters& summand_counters = counters->summands[summand.index];
+              detail::add_relaxed(summand_counters.visits, std::size_t(1));
+              detail::add_relaxed(summand_counters.time, (std::chrono::steady_clock::now() - start).count());
             }
+          }
+        }
+
+        finish_state(thread_index, m_options.number_of_threads, current_state, s_index, todo.size(todo_index));
+        todo.finish_state(todo_index);
+
+        if (!m_options.checkpoint_filename.empty() && std::chrono::steady_clock::now() >= m_next_checkpoint)
+        {
+          save_checkpoint(todo, discovered);
+          m_next_checkpoint = std::chrono::steady_clock::now() + std::chrono::seconds(m_options.checkpoint_interval);
+        }
+      }
+
+      // An aborted exploration, for example by an interrupt, can be resumed from the last explored state.
+      if (!m_options.checkpoint_filename.empty() && m_must_abort)
+      {
+        save_checkpoint(todo, discovered);
+      }
+      mCRL2log(log::debug) << "Stop thread " << thread_index << ".\n";
+    }  // end generate_state_space_thread.
+
+
+
+    // Generates the transitions of the enabled summands in a stubborn set of the state assigned in sigma. When
+    // the visible actions are preserved, all transitions are generated if one of the selected transitions leads
+    // to a state that has been discovered before. Otherwise a cycle of such states could ignore the other
+    // transitions forever.
+    template <typename SummandSequence, typename ReportTransition>
+    void generate_stubborn_set_transitions(
+      const SummandSequence& summands,
+      const SummandSequence& confluent_summands,
+      const indexed_set_for_states_type& discovered,
+      const std::size_t thread_index,
+      data::mutable_indexed_substitution<>& sigma,
+      data::rewriter& rewr,
+      data::data_expression& condition,
+      state_type& s1,
+      atermpp::aterm& key,
+      data::enumerator_algorithm<>& enumerator,
+      data::enumerator_identifier_generator& id_generator,
+      ReportTransition report_transition)
+    {
+      assert(summands.size() == m_stubborn_sets->size());
+      std::vector<std::vector<std::pair<lps::multi_action, state_type>>> transitions(summands.size());
+      stubborn_sets::summand_set enabled(summands.size());
+      for (std::size_t k = 0; k < summands.size(); ++k)
+      {
+        generate_transitions(summands[k], confluent_summands, sigma, rewr, condition, s1, key, enumerator, id_generator,
+                             [&](const lps::multi_action& a, const state_type& s) { transitions[k].emplace_back(a, s); });
+        enabled[k] = !transitions[k].empty();
+      }
 
-            finish_state(thread_index, m_options.number_of_threads, current_state, s_index, thread_todo->size());
-            thread_todo->finish_state();
+      stubborn_sets::summand_set T = m_stubborn_sets->enabled_stubborn_set(enabled,
+                                       [&](const data::data_expression& e) { count_rewrites(1); return data::is_false(rewr(e, sigma)); });
+      if (T != enabled)
+      {
+        if (m_options.partial_order_reduction == partial_order_reduction_mode::actions)
+        {
+          for (std::size_t k = T.find_first(); k != stubborn_sets::summand_set::npos && T != enabled; k = T.find_next(k))
+          {
+            for (const auto& [a, s]: transitions[k])
+            {
+              if (discovered.index(s, thread_index) != indexed_set_for_states_type::npos)
+              {
+                T = enabled;
+                ++m_proviso_states;
+                break;
+              }
+            }
           }
         }
-        else
+        if (T != enabled)
         {
-          if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
+          ++m_reduced_states;
         }
-        // Check whether all processes are ready. If so the number_of_active_processes becomes 0. 
-        // Otherwise, this thread becomes active again, and tries to see whether the todo buffer is
-        // not empty, to take up more work. 
-        number_of_active_processes--;
-        number_of_idle_processes++;
-        if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads > 1) m_exclusive_state_access.lock();
-        
-        assert(thread_todo->empty() || m_must_abort);
-        if (todo->empty())
+      }
+
+      for (std::size_t k = T.find_first(); k != stubborn_sets::summand_set::npos; k = T.find_next(k))
+      {
+        for (const auto& [a, s]: transitions[k])
         {
-          if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads > 1) m_exclusive_state_access.unlock();
-          std::this_thread::sleep_for(std::chrono::milliseconds(100));
-          if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.lock();
+          report_transition(summands[k], a, s);
         }
-        if (number_of_active_processes>0 || !todo->empty())
+      }
+    }
+
+    // Breadth-first search in which the discovered states are stored on disk. The targets of transitions are
+    // buffered as candidates, and duplicates are detected in batches when the buffer is full or all stored
+    // states have been explored. Only then the indices of the targets are known, so the callbacks of the
+    // explored states are postponed until their candidates have been merged with the stored states.
+    template <
+      typename SummandSequence,
+      typename DiscoverState,
+      typename ExamineTransition,
+      typename StartState,
+      typename FinishState
+    >
+    void generate_state_space_external(
+      const state& s0,
+      const SummandSequence& regular_summands,
+      const SummandSequence& confluent_summands,
+      external_state_set& discovered,
+      DiscoverState discover_state,
+      ExamineTransition examine_transition,
+      StartState start_state,
+      FinishState finish_state
+    )
+    {
+      struct delayed_transition
+      {
+        lps::multi_action action;
+        std::size_t target;        // The position of the target state among the candidates.
+        std::size_t summand_index;
+      };
+
+      struct explored_state
+      {
+        state source;
+        std::size_t index;
+        std::vector<delayed_transition> transitions;
+      };
+
+      const std::size_t thread_index = 0;
+      data::mutable_indexed_substitution<> sigma = m_global_sigma;
+      data::data_expression condition;
+      state_type state_;
+      atermpp::aterm key;
+      std::vector<explored_state> explored;
+      std::size_t number_of_delayed_transitions = 0;
+      external_state_set::reader todo(discovered);
+
+      auto merge = [&]()
+      {
+        const std::vector<std::size_t> indices = discovered.merge_candidates([&](const state& s, std::size_t s_index)
+          {
+            discover_state(thread_index, s, s_index);
+          });
+        for (const explored_state& e: explored)
         {
-          number_of_active_processes++;
+          start_state(thread_index, e.source, e.index);
+          for (const delayed_transition& t: e.transitions)
+          {
+            examine_transition(thread_index, 1, e.source, e.index, t.action, discovered.candidate(t.target), indices[t.target], t.summand_index);
+          }
+          finish_state(thread_index, 1, e.source, e.index, discovered.size() - todo.position());
         }
-        number_of_idle_processes--;
-      } 
-      mCRL2log(log::debug) << "Stop thread " << thread_index << ".\n";
-      if (mcrl2::utilities::detail::GlobalThreadSafe && m_options.number_of_threads>1) m_exclusive_state_access.unlock();
+        explored.clear();
+        number_of_delayed_transitions = 0;
+        discovered.clear_candidates();
+      };
 
-    }  // end generate_state_space_thread.
+      discovered.clear();
+      discovered.add_candidate(s0);
+      merge();
+
+      state current_state;
+      while (!m_must_abort.load(std::memory_order_relaxed))
+      {
+        if (!todo.next(current_state))
+        {
+          if (explored.empty())
+          {
+            break;
+          }
+          merge();
+          continue;
+        }
 
+        explored.push_back(explored_state{current_state, todo.position() - 1, {}});
+        data::add_assignments(sigma, m_process_parameters, current_state);
+        for (const explorer_summand& summand: regular_summands)
+        {
+          generate_transitions(
+            summand,
+            confluent_summands,
+            sigma,
+            m_global_rewr,
+            condition,
+            state_,
+            key,
+            m_global_enumerator,
+            m_global_id_generator,
+            [&](const lps::multi_action& a, const state& s1)
+            {
+              std::size_t target;
+              if constexpr (Timed)
+              {
+                const data::data_expression& t = current_state[m_n];
+                if (a.has_time() && less_equal(a.time(), t, sigma, m_global_rewr))
+                {
+                  return;
+                }
+                state s1_;
+                make_timed_state(s1_, s1, a.has_time() ? a.time() : t);
+                target = discovered.add_candidate(s1_);
+              }
+              else
+              {
+                target = discovered.add_candidate(s1);
+              }
+              explored.back().transitions.push_back(delayed_transition{a, target, summand.index});
+              number_of_delayed_transitions++;
+            }
+          );
+        }
 
+        // The explored states and their transitions are kept in memory as well, so they are bounded by the
+        // size of the buffer too.
+        if (discovered.number_of_candidates() >= m_options.external_buffer_size
+            || explored.size() >= m_options.external_buffer_size
+            || number_of_delayed_transitions >= m_options.external_buffer_size)
+        {
+          merge();
+        }
+      }
+    }
 
     // pre: s0 is in normal form
     template <
@@ -1279,43 +2084,63 @@ class explorer: public abortable
     {
       utilities::mcrl2_unused(discover_initial_state); // silence unused parameter warning
 
+      if constexpr (!Stochastic)
+      {
+        if (discovered.external_storage())
+        {
+          m_recursive = recursive;
+          generate_state_space_external(s0, regular_summands, confluent_summands, discovered.external_states(),
+                                        discover_state, examine_transition, start_state, finish_state);
+          m_must_abort = false;
+          return;
+        }
+      }
+
       const std::size_t number_of_threads=m_options.number_of_threads;
       assert(number_of_threads>0);
       const std::size_t initialisation_thread_index= (number_of_threads==1?0:1);
       m_recursive = recursive;
-      std::unique_ptr<todo_set> todo;
+      m_next_checkpoint = std::chrono::steady_clock::now() + std::chrono::seconds(m_options.checkpoint_interval);
+      work_stealing_todo_sets todo(number_of_threads, [&]()
+        {
+          std::vector<state> empty;
+          return make_todo_set(empty.begin(), empty.end());
+        });
       discovered.clear(initialisation_thread_index);
 
       if constexpr (Stochastic)
       {
         state_type s0_ = make_state(s0);
         const auto& S = s0_.states;
-        todo = make_todo_set(S.begin(), S.end());
+        for (const state& s: S)
+        {
+          todo.insert(0, s);
+        }
         discovered.clear(initialisation_thread_index);
         std::list<std::size_t> s0_index;
         for (const state& s: S)
         {
           // TODO: join duplicate targets
-          std::size_t s_index = discovered.index(s, initialisation_thread_index);
-          if (s_index >= discovered.size())
+          std::pair<std::size_t,bool> p = discovered.insert(s, initialisation_thread_index);
+          if (p.second)
           {
-            s_index = discovered.insert(s, initialisation_thread_index).first;
-            discover_state(initialisation_thread_index, s, s_index);
+            discover_state(initialisation_thread_index, s, p.first);
           }
-          s0_index.push_back(s_index);
+          s0_index.push_back(p.first);
         }
         discover_initial_state(s0_, s0_index);
       }
+      else if (m_options.resume)
+      {
+        load_checkpoint(todo, discovered);
+      }
       else
       {
-        todo = make_todo_set(s0);
+        todo.insert(0, s0);
         std::size_t s0_index = discovered.insert(s0, initialisation_thread_index).first;
         discover_state(initialisation_thread_index, s0, s0_index);
       }
 
-      std::atomic<std::size_t> number_of_active_processes=number_of_threads;
-      std::atomic<std::size_t> number_of_idle_processes=0;
-
       if (number_of_threads>1)
       {
         std::vector<std::thread> threads;
@@ -1328,8 +2153,7 @@ class explorer: public abortable
                                                          DiscoverState, ExamineTransition,
                                                          StartState, FinishState,
                                                          DiscoverInitialState >
-                                       (todo, 
-                                        i, number_of_active_processes, number_of_idle_processes,
+                                       (todo, i,
                                         regular_summands,confluent_summands,discovered, discover_state,
                                         examine_transition, start_state, finish_state, 
                                         m_global_rewr.clone(), m_global_sigma); } );  // It is essential that the rewriter is cloned as
@@ -1350,12 +2174,13 @@ class explorer: public abortable
                                                 DiscoverState, ExamineTransition,
                                                 StartState, FinishState,
                                                 DiscoverInitialState >
-                                  (todo,single_thread_index,number_of_active_processes, number_of_idle_processes,
+                                  (todo,single_thread_index,
                                    regular_summands,confluent_summands,discovered, discover_state,
                                    examine_transition, start_state, finish_state, 
                                    m_global_rewr, m_global_sigma);  
       }
 
+      m_work_statistics = todo.statistics();
       m_must_abort = false;
     }
 
@@ -1393,6 +2218,10 @@ class explorer: public abortable
         {
           s0 = find_representative(s0, m_confluent_summands, m_global_sigma, m_global_rewr, m_global_enumerator, m_global_id_generator);
         }
+        if (m_symmetry)
+        {
+          m_symmetry->canonicalize(s0);
+        }
         if constexpr (Timed)
         {
           make_timed_state(s0, s0, data::sort_real::real_zero());
@@ -1603,6 +2432,10 @@ class explorer: public abortable
       {
         s0 = find_representative(s0, m_confluent_summands, m_global_sigma, m_global_rewr, m_global_enumerator, m_global_id_generator);
       }
+      if (m_symmetry)
+      {
+        m_symmetry->canonicalize(s0);
+      }
       if constexpr (Timed)
       {
         s0 = make_timed_state(s0, data::sort_real::real_zero());
@@ -1730,6 +2563,10 @@ class explorer: public abortable
       {
         s0 = find_representative(s0, m_confluent_summands, m_global_sigma, m_global_rewr, m_global_enumerator, m_global_id_generator);
       }
+      if (m_symmetry)
+      {
+        m_symmetry->canonicalize(s0);
+      }
       if constexpr (Timed)
       {
         s0 = make_timed_state(s0, data::sort_real::real_zero());
@@ -1744,6 +2581,91 @@ class explorer: public abortable
       m_must_abort = true;
     }
 
+    /// \brief Sets the functions that write and read the state of the caller, such as an LTS builder, to and from
+    ///        checkpoints. They are invoked after the state of the explorer has been written or read.
+    void set_checkpoint_functions(std::function<void(atermpp::aterm_ostream&)> save, std::function<void(atermpp::aterm_istream&)> load)
+    {
+      m_save_checkpoint = std::move(save);
+      m_load_checkpoint = std::move(load);
+    }
+
+    /// \returns The amount of work done by every thread in the last call to generate_state_space.
+    const std::vector<work_stealing_statistics>& work_statistics() const
+    {
+      return m_work_statistics;
+    }
+
+    /// \returns The relations between the summands used for partial-order reduction, or nullptr if it is disabled.
+    const stubborn_sets* partial_order_reduction() const
+    {
+      return m_stubborn_sets.get();
+    }
+
+    /// \returns The groups of symmetric process parameters used for symmetry reduction, or nullptr if it is disabled.
+    const symmetry_reduction* symmetry() const
+    {
+      return m_symmetry.get();
+    }
+
+    /// \returns The number of states of which only a stubborn set was explored, and the number of states that
+    ///          were fully explored because of the cycle proviso.
+    std::pair<std::size_t, std::size_t> partial_order_reduction_statistics() const
+    {
+      return std::make_pair(m_reduced_states.load(), m_proviso_states.load());
+    }
+
+    /// \returns The statistics of the enumeration caches of all summands combined.
+    /// \returns The work done by all threads so far, which is only measured when metrics are enabled in the options.
+    /// \details The number of visits and the time per summand are not measured with partial-order reduction, in
+    ///          which case only the transitions are counted. This function is threadsafe.
+    explorer_metrics metrics() const
+    {
+      explorer_metrics result;
+      result.summands.resize(m_global_lpsspec.process().action_summands().size());
+      for (const std::unique_ptr<detail::explorer_thread_counters>& counters: m_thread_counters)
+      {
+        result.rewrites += counters->rewrites.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < result.summands.size(); ++i)
+        {
+          const detail::explorer_thread_counters::summand_counters& summand = counters->summands[i];
+          result.summands[i].visits += summand.visits.load(std::memory_order_relaxed);
+          result.summands[i].transitions += summand.transitions.load(std::memory_order_relaxed);
+          result.summands[i].time += std::chrono::nanoseconds(summand.time.load(std::memory_order_relaxed));
+        }
+      }
+
+      auto add_cache = [&](const summand_cache& cache)
+      {
+        const auto [hits, misses] = cache.hits_and_misses();
+        result.cache_hits += hits;
+        result.cache_misses += misses;
+      };
+      add_cache(global_cache);
+      for (const explorer_summand& summand: m_regular_summands)
+      {
+        add_cache(summand.local_cache);
+      }
+      for (const explorer_summand& summand: m_confluent_summands)
+      {
+        add_cache(summand.local_cache);
+      }
+      return result;
+    }
+
+    summand_cache_statistics cache_statistics() const
+    {
+      summand_cache_statistics result = global_cache.statistics();
+      for (const explorer_summand& summand: m_regular_summands)
+      {
+        result += summand.local_cache.statistics();
+      }
+      for (const explorer_summand& summand: m_confluent_summands)
+      {
+        result += summand.local_cache.statistics();
+      }
+      return result;
+    }
+
     /// \brief Returns a mapping containing all discovered states.
     const indexed_set_for_states_type& state_map() const
     {
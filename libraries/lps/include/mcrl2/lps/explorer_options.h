@@ -17,6 +17,7 @@
 #include "mcrl2/data/rewrite_strategy.h"
 #include "mcrl2/lps/multi_action.h"
 #include "mcrl2/lps/exploration_strategy.h"
+#include "mcrl2/lps/partial_order_reduction.h"
 
 
 namespace mcrl2 {
@@ -27,6 +28,7 @@ struct explorer_options
 {
   data::rewrite_strategy rewrite_strategy = data::jitty;
   exploration_strategy search_strategy;
+  partial_order_reduction_mode partial_order_reduction = partial_order_reduction_mode::none;
   bool one_point_rule_rewrite = false;
   bool replace_constants_by_variables = false;
   bool remove_unused_rewrite_rules = false;
@@ -44,14 +46,29 @@ struct explorer_options
   bool save_at_end = false;
   bool dfs_recursive = false;
   bool discard_lts_state_labels = false;
+  bool tree_compression = false;
+  bool resume = false;            // Continue from the checkpoint in checkpoint_filename.
+  bool hash_compaction = false;   // Store fingerprints instead of bits when bitstate_memory is not 0.
   bool rewrite_actions = true;    // If false, this option prevents rewriting actions.
                                   // Rewriting actions is only needed if they occur in the
                                   // generated lts, or in traces. 
   std::size_t max_states = std::numeric_limits<std::size_t>::max();
+  std::size_t cache_size = 0;     // The maximum number of enumeration results per cache, 0 means unbounded.
   std::size_t max_traces = 0;
   std::size_t highway_todo_max = std::numeric_limits<std::size_t>::max();
   std::size_t number_of_threads = 1;
+  std::size_t number_of_shards = 0; // The number of shards of the discovered states, 0 means that they are not sharded.
+  std::size_t checkpoint_interval = 1800; // The number of seconds between checkpoints.
+  std::size_t external_buffer_size = 1000000; // The number of candidate states buffered by external breadth-first search.
+  std::size_t bitstate_memory = 0;  // The number of bytes for bitstate hashing, 0 means that the states are stored.
+  std::size_t bitstate_hashes = 3;  // The number of bits that is set for every state in bitstate hashing.
+  std::size_t random_seed = 0;      // If nonzero, the summands are explored in a random order and bitstate hashing uses a random hash function.
+  std::size_t metrics_interval = 1; // The number of seconds between two lines of metrics.
   std::string trace_prefix;
+  std::string checkpoint_filename; // The file to which checkpoints are written, no checkpoints are made if it is empty.
+  std::string external_directory;  // The directory in which external breadth-first search stores the states.
+  std::string symmetry;            // The groups of symmetric process parameters, "auto" or empty for no symmetry reduction.
+  std::string metrics_filename;    // The file to which metrics are written as JSON lines, no metrics are measured if it is empty.
   std::set<core::identifier_string> trace_actions;
   std::set<lps::multi_action> trace_multiactions;
   std::set<core::identifier_string> actions_internal_for_divergencies;
@@ -78,8 +95,11 @@ std::ostream& operator<<(std::ostream& out, const explorer_options& options)
   out << "search-strategy = " << options.search_strategy << std::endl;
   out << "cached = " << std::boolalpha << options.cached << std::endl;
   out << "global-cache = " << std::boolalpha << options.global_cache << std::endl;
+  out << "cache-size = " << options.cache_size << std::endl;
   out << "confluence = " << std::boolalpha << options.confluence << std::endl;
   out << "confluence-action = " << options.confluence << std::endl;
+  out << "partial-order-reduction = " << options.partial_order_reduction << std::endl;
+  out << "symmetry = " << options.symmetry << std::endl;
   out << "one-point-rule-rewrite = " << std::boolalpha << options.one_point_rule_rewrite << std::endl;
   out << "replace-constants-by-variables = " << std::boolalpha << options.replace_constants_by_variables << std::endl;
   out << "remove-unused-rewrite-rules = " << std::boolalpha << options.remove_unused_rewrite_rules << std::endl;
@@ -94,6 +114,19 @@ std::ostream& operator<<(std::ostream& out, const explorer_options& options)
   out << "suppress-progress-messages = " << std::boolalpha << options.suppress_progress_messages << std::endl;
   out << "save-aut-at-end = " << std::boolalpha << options.save_at_end << std::endl;
   out << "dfs-recursive = " << std::boolalpha << options.dfs_recursive << std::endl;
+  out << "tree-compression = " << std::boolalpha << options.tree_compression << std::endl;
+  out << "shards = " << options.number_of_shards << std::endl;
+  out << "checkpoint = " << options.checkpoint_filename << std::endl;
+  out << "checkpoint-interval = " << options.checkpoint_interval << std::endl;
+  out << "resume = " << std::boolalpha << options.resume << std::endl;
+  out << "external-directory = " << options.external_directory << std::endl;
+  out << "external-buffer-size = " << options.external_buffer_size << std::endl;
+  out << "bitstate-memory = " << options.bitstate_memory << std::endl;
+  out << "bitstate-hashes = " << options.bitstate_hashes << std::endl;
+  out << "hash-compaction = " << std::boolalpha << options.hash_compaction << std::endl;
+  out << "random-seed = " << options.random_seed << std::endl;
+  out << "metrics = " << options.metrics_filename << std::endl;
+  out << "metrics-interval = " << options.metrics_interval << std::endl;
   out << "max-states = " << options.max_states << std::endl;
   out << "max-traces = " << options.max_traces << std::endl;
   out << "todo-max = " << options.highway_todo_max << std::endl;
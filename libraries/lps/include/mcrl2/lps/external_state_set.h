@@ -0,0 +1,266 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/external_state_set.h
+/// \brief A set of states that is stored on disk, in which duplicates are detected in batches.
+
+#ifndef MCRL2_LPS_EXTERNAL_STATE_SET_H
+#define MCRL2_LPS_EXTERNAL_STATE_SET_H
+
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "mcrl2/atermpp/aterm_io_binary.h"
+#include "mcrl2/atermpp/standard_containers/indexed_set.h"
+#include "mcrl2/data/detail/io.h"
+#include "mcrl2/lps/state.h"
+
+namespace mcrl2::lps {
+
+/// \brief A set of states that is stored on disk, following the external memory search of Stern and Dill.
+/// \details States are not inserted directly, but added as candidates to a buffer in memory. The function
+///          merge_candidates detects which candidates are already stored by reading all stored states once,
+///          and appends the others to the disk, assigning them the next available indices. The states are
+///          kept in segments, one for every merge, such that the stored states can be read in the order of
+///          their indices while new segments are being added. This order is the breadth-first order in which
+///          the states are discovered, so a reader also serves as the queue of a breadth-first search.
+class external_state_set
+{
+  public:
+    typedef std::size_t size_type;
+
+    /// \brief Value returned when a candidate does not occur in the set.
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    /// \brief Reads the stored states in the order of their indices, including states stored after it was created.
+    class reader
+    {
+      public:
+        explicit reader(const external_state_set& states)
+          : m_states(states)
+        {}
+
+        /// \brief Assigns the next stored state to s.
+        /// \returns False iff all stored states have been read.
+        bool next(state& s)
+        {
+          while (m_remaining == 0)
+          {
+            if (m_segment == m_states.m_segment_sizes.size())
+            {
+              return false;
+            }
+            open(m_segment++);
+          }
+          *m_stream >> s;
+          --m_remaining;
+          ++m_position;
+          return true;
+        }
+
+        /// \returns The index of the state that will be read next.
+        size_type position() const
+        {
+          return m_position;
+        }
+
+      private:
+        void open(std::size_t segment)
+        {
+          m_stream.reset();
+          m_file.close();
+          m_file.open(m_states.segment_filename(segment), std::ios::binary);
+          if (!m_file.is_open())
+          {
+            throw mcrl2::runtime_error("cannot open '" + m_states.segment_filename(segment).string() + "' for reading");
+          }
+          m_stream = std::make_unique<atermpp::binary_aterm_istream>(m_file);
+          *m_stream >> data::detail::add_index_impl;
+          m_remaining = m_states.m_segment_sizes[segment];
+        }
+
+        const external_state_set& m_states;
+        std::ifstream m_file;
+        std::unique_ptr<atermpp::binary_aterm_istream> m_stream;
+        std::size_t m_segment = 0;
+        size_type m_remaining = 0;
+        size_type m_position = 0;
+    };
+
+    /// \brief Constructor of an empty set, which stores its states in a fresh subdirectory of the given directory.
+    explicit external_state_set(const std::filesystem::path& directory)
+    {
+      std::random_device device;
+      m_directory = directory / ("mcrl2_states_" + std::to_string(device()));
+      std::filesystem::create_directories(m_directory);
+    }
+
+    external_state_set(const external_state_set&) = delete;
+    external_state_set& operator=(const external_state_set&) = delete;
+
+    ~external_state_set()
+    {
+      m_access.reset();
+      std::error_code ec;
+      std::filesystem::remove_all(m_directory, ec);
+    }
+
+    /// \brief Adds a state to the buffer of candidates.
+    /// \returns The position of the state among the candidates.
+    size_type add_candidate(const state& s)
+    {
+      return m_candidates.insert(s).first;
+    }
+
+    /// \returns The candidate at the given position.
+    const state& candidate(size_type position) const
+    {
+      return m_candidates[position];
+    }
+
+    /// \returns The number of candidates in the buffer.
+    size_type number_of_candidates() const
+    {
+      return m_candidates.size();
+    }
+
+    /// \brief Stores the candidates that do not occur in the set yet, and reports each of them via discover_state
+    ///        together with its new index.
+    /// \returns The index of every candidate. The candidates remain in the buffer until clear_candidates is called.
+    template <typename DiscoverState>
+    std::vector<size_type> merge_candidates(DiscoverState discover_state)
+    {
+      std::vector<size_type> result(m_candidates.size(), npos);
+
+      // Detect the duplicates in a single pass over the stored states.
+      size_type found = 0;
+      reader stored(*this);
+      state s;
+      while (found < m_candidates.size() && stored.next(s))
+      {
+        const size_type position = m_candidates.index(s);
+        if (position != atermpp::indexed_set<state>::npos)
+        {
+          result[position] = stored.position() - 1;
+          ++found;
+        }
+      }
+      m_states_read += stored.position();
+      ++m_number_of_merges;
+
+      if (found < m_candidates.size())
+      {
+        const std::size_t segment = m_segment_sizes.size();
+        {
+          std::ofstream file(segment_filename(segment), std::ios::binary);
+          if (!file.is_open())
+          {
+            throw mcrl2::runtime_error("cannot open '" + segment_filename(segment).string() + "' for writing");
+          }
+          atermpp::binary_aterm_ostream out(file);
+          out << data::detail::remove_index_impl;
+          for (size_type i = 0; i < m_candidates.size(); ++i)
+          {
+            if (result[i] == npos)
+            {
+              out << m_candidates[i];
+            }
+          }
+        }
+        m_segment_sizes.push_back(m_candidates.size() - found);
+
+        for (size_type i = 0; i < m_candidates.size(); ++i)
+        {
+          if (result[i] == npos)
+          {
+            result[i] = m_size++;
+            discover_state(m_candidates[i], result[i]);
+          }
+        }
+      }
+      return result;
+    }
+
+    /// \brief Removes all candidates from the buffer.
+    void clear_candidates()
+    {
+      m_candidates.clear();
+    }
+
+    /// \returns The state with the given index.
+    /// \details This reads the stored states from disk, which is only efficient when the indices are increasing.
+    state operator[](size_type index) const
+    {
+      assert(index < m_size);
+      if (m_access == nullptr || m_access->position() > index + 1)
+      {
+        m_access = std::make_unique<reader>(*this);
+      }
+      while (m_access->position() <= index)
+      {
+        m_access->next(m_access_state);
+      }
+      return m_access_state;
+    }
+
+    /// \returns The number of stored states.
+    size_type size() const
+    {
+      return m_size;
+    }
+
+    /// \returns The number of times that the candidates have been merged with the stored states.
+    std::size_t number_of_merges() const
+    {
+      return m_number_of_merges;
+    }
+
+    /// \returns The number of states read from disk to detect duplicates.
+    std::size_t states_read() const
+    {
+      return m_states_read;
+    }
+
+    /// \brief Removes all states and candidates.
+    void clear()
+    {
+      m_access.reset();
+      for (std::size_t i = 0; i < m_segment_sizes.size(); ++i)
+      {
+        std::filesystem::remove(segment_filename(i));
+      }
+      m_segment_sizes.clear();
+      m_candidates.clear();
+      m_size = 0;
+    }
+
+  private:
+    std::filesystem::path segment_filename(std::size_t segment) const
+    {
+      return m_directory / ("segment" + std::to_string(segment) + ".bin");
+    }
+
+    std::filesystem::path m_directory;
+    std::vector<size_type> m_segment_sizes; // The number of states in every segment.
+    atermpp::indexed_set<state> m_candidates;
+    size_type m_size = 0;
+    std::size_t m_number_of_merges = 0;
+    std::size_t m_states_read = 0;
+
+    // Used by operator[] to continue reading where the previous access stopped.
+    mutable std::unique_ptr<reader> m_access;
+    mutable state m_access_state;
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_EXTERNAL_STATE_SET_H
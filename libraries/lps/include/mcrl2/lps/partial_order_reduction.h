@@ -0,0 +1,375 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/partial_order_reduction.h
+/// \brief Stubborn sets of summands, which are used for partial-order reduction during state space exploration.
+
+#ifndef MCRL2_LPS_PARTIAL_ORDER_REDUCTION_H
+#define MCRL2_LPS_PARTIAL_ORDER_REDUCTION_H
+
+#include <algorithm>
+#include <boost/dynamic_bitset.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mcrl2/data/find.h"
+#include "mcrl2/data/join.h"
+#include "mcrl2/data/standard.h"
+#include "mcrl2/lps/multi_action.h"
+#include "mcrl2/utilities/exception.h"
+
+namespace mcrl2::lps {
+
+enum class partial_order_reduction_mode
+{
+  none,     // All transitions are explored.
+  deadlock, // The reduction preserves the deadlocks.
+  actions   // The reduction preserves the deadlocks and the occurrences of the visible actions.
+};
+
+inline
+partial_order_reduction_mode parse_partial_order_reduction_mode(const std::string& s)
+{
+  if (s == "none")
+  {
+    return partial_order_reduction_mode::none;
+  }
+  if (s == "deadlock")
+  {
+    return partial_order_reduction_mode::deadlock;
+  }
+  if (s == "actions")
+  {
+    return partial_order_reduction_mode::actions;
+  }
+  throw mcrl2::runtime_error("unknown partial-order reduction mode " + s);
+}
+
+inline
+std::string print_partial_order_reduction_mode(const partial_order_reduction_mode mode)
+{
+  switch (mode)
+  {
+    case partial_order_reduction_mode::none: return "none";
+    case partial_order_reduction_mode::deadlock: return "deadlock";
+    case partial_order_reduction_mode::actions: return "actions";
+    default: throw mcrl2::runtime_error("unknown partial-order reduction mode");
+  }
+}
+
+inline
+std::istream& operator>>(std::istream& is, partial_order_reduction_mode& mode)
+{
+  try
+  {
+    std::string s;
+    is >> s;
+    mode = parse_partial_order_reduction_mode(s);
+  }
+  catch (mcrl2::runtime_error&)
+  {
+    is.setstate(std::ios_base::failbit);
+  }
+  return is;
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, const partial_order_reduction_mode mode)
+{
+  os << print_partial_order_reduction_mode(mode);
+  return os;
+}
+
+inline
+std::string description(const partial_order_reduction_mode mode)
+{
+  switch (mode)
+  {
+    case partial_order_reduction_mode::none: return "explore all transitions";
+    case partial_order_reduction_mode::deadlock: return "explore stubborn sets that preserve the deadlocks";
+    case partial_order_reduction_mode::actions: return "explore stubborn sets that preserve the deadlocks and the traces of the visible actions, "
+                                                       "i.e. the actions given by --action and --multiaction, or all actions except tau if these options are absent";
+    default: throw mcrl2::runtime_error("unknown partial-order reduction mode");
+  }
+}
+
+/// \brief The relations between the summands of a linear process that are needed to compute stubborn sets.
+/// \details The relations are computed statically, from the parameters that summands test in their condition
+///          (Ts), write in their next state (Ws) and read in their actions and next state (Rs). Two summands
+///          accord if they commute when both are enabled, which holds if neither writes a parameter that the
+///          other one reads or writes. Two summands are independent if they accord, and neither writes a
+///          parameter that the other one tests, such that they can also not enable or disable each other.
+///
+///          A stubborn set in a state is closed under the following rules. For an enabled summand it contains
+///          all summands that are not independent of it, and for a disabled summand it contains a necessary
+///          enabling set: the summands that write a parameter of a conjunct of its condition that is false in
+///          the state. A summand that assigns a value to the parameter x of a conjunct x == c that is known to
+///          differ from c cannot make the conjunct true, and is therefore left out of its necessary enabling set,
+///          which is essential for the program counters of a linearised process. When visible actions are preserved, a stubborn set that contains an enabled visible
+///          summand contains all visible summands. Exploring only the enabled summands of a stubborn set
+///          preserves the deadlocks. The caller must fully explore a state when the reduction ignores
+///          transitions forever in order to preserve the visible actions as well (the cycle proviso).
+class stubborn_sets
+{
+  public:
+    typedef boost::dynamic_bitset<> summand_set;
+
+  protected:
+    struct conjunct
+    {
+      data::data_expression expression;
+      summand_set NES; // The summands that may make the expression true by writing one of its parameters.
+    };
+
+    partial_order_reduction_mode m_mode;
+    std::vector<summand_set> m_dependent; // The summands that are not independent of a summand, including itself.
+    std::vector<summand_set> m_NES;       // The summands that write a parameter tested by a summand.
+    std::vector<std::vector<conjunct>> m_conjuncts; // The conjuncts of a condition without summation variables.
+    summand_set m_visible;
+    std::size_t m_accordant_pairs = 0;
+    std::size_t m_independent_pairs = 0;
+
+    typedef boost::dynamic_bitset<> parameter_set;
+
+    template <typename T>
+    static parameter_set parameters(const T& x, const std::vector<data::variable>& process_parameters)
+    {
+      const std::set<data::variable> FV = data::find_free_variables(x);
+      parameter_set result(process_parameters.size());
+      for (std::size_t i = 0; i < process_parameters.size(); ++i)
+      {
+        result[i] = FV.find(process_parameters[i]) != FV.end();
+      }
+      return result;
+    }
+
+    // Returns true if the expression contains none of the given variables.
+    template <typename VariableSet>
+    static bool is_closed(const data::data_expression& x, const VariableSet& V)
+    {
+      const std::set<data::variable> FV = data::find_free_variables(x);
+      return std::none_of(FV.begin(), FV.end(), [&](const data::variable& v) { return V.count(v) > 0; });
+    }
+
+    // The summands that write a parameter in the given set.
+    summand_set writers(const parameter_set& V, const std::vector<parameter_set>& Ws) const
+    {
+      summand_set result(Ws.size());
+      for (std::size_t l = 0; l < Ws.size(); ++l)
+      {
+        result[l] = Ws[l].intersects(V);
+      }
+      return result;
+    }
+
+    // Removes the summands from NES that cannot make the conjunct x == c true, because they assign a value to
+    // the process parameter x that differs from c.
+    template <typename SummandSequence, typename Rewrite>
+    static void restrict_to_enabling_writers(const data::data_expression& e,
+                                             summand_set& NES,
+                                             const SummandSequence& summands,
+                                             const std::vector<data::variable>& process_parameters,
+                                             Rewrite rewrite)
+    {
+      if (!data::is_equal_to_application(e))
+      {
+        return;
+      }
+      const std::set<data::variable> parameters(process_parameters.begin(), process_parameters.end());
+      data::data_expression x = data::binary_left(atermpp::down_cast<data::application>(e));
+      data::data_expression c = data::binary_right(atermpp::down_cast<data::application>(e));
+      if (!data::is_variable(x) || parameters.count(atermpp::down_cast<data::variable>(x)) == 0)
+      {
+        std::swap(x, c);
+      }
+      if (!data::is_variable(x) || parameters.count(atermpp::down_cast<data::variable>(x)) == 0 || !is_closed(c, parameters))
+      {
+        return;
+      }
+
+      const std::size_t i = std::find(process_parameters.begin(), process_parameters.end(), x) - process_parameters.begin();
+      for (std::size_t l = NES.find_first(); l != summand_set::npos; l = NES.find_next(l))
+      {
+        const data::data_expression& value = summands[l].next_state[i];
+        const std::set<data::variable> summation_variables(summands[l].variables.begin(), summands[l].variables.end());
+        if (value != x && is_closed(value, parameters) && is_closed(value, summation_variables)
+            && data::is_false(rewrite(data::equal_to(value, c))))
+        {
+          NES.reset(l);
+        }
+      }
+    }
+
+    // Returns the necessary enabling set for the disabled summand k, where is_false(e) decides whether the
+    // conjunct e is false in the current state. A set with the fewest summands outside T is chosen.
+    template <typename IsFalse>
+    const summand_set& necessary_enabling_set(std::size_t k, const summand_set& T, IsFalse is_false) const
+    {
+      const summand_set* result = &m_NES[k];
+      std::size_t best = (m_NES[k] - T).count();
+      for (const conjunct& c: m_conjuncts[k])
+      {
+        const std::size_t n = (c.NES - T).count();
+        if (n < best && is_false(c.expression))
+        {
+          result = &c.NES;
+          best = n;
+        }
+      }
+      return *result;
+    }
+
+    // Computes the smallest set that contains the summand k and is closed under the rules of stubborn sets.
+    template <typename IsFalse>
+    summand_set closure(std::size_t k, const summand_set& enabled, IsFalse is_false) const
+    {
+      summand_set T(enabled.size());
+      summand_set work(enabled.size());
+      T.set(k);
+      work.set(k);
+      while ((k = work.find_first()) != summand_set::npos)
+      {
+        work.reset(k);
+        if (enabled[k])
+        {
+          work |= m_dependent[k] - T;
+          T |= m_dependent[k];
+          if (m_mode == partial_order_reduction_mode::actions && m_visible[k])
+          {
+            work |= m_visible - T;
+            T |= m_visible;
+          }
+        }
+        else
+        {
+          const summand_set& NES = necessary_enabling_set(k, T, is_false);
+          work |= NES - T;
+          T |= NES;
+        }
+      }
+      return T;
+    }
+
+  public:
+    /// \brief Computes the relations between the given summands.
+    /// \param is_visible Decides whether the multi-action of a summand is visible.
+    /// \param rewrite Rewrites an expression without process parameters and summation variables.
+    template <typename SummandSequence, typename IsVisible, typename Rewrite>
+    stubborn_sets(const SummandSequence& summands,
+                  const std::vector<data::variable>& process_parameters,
+                  partial_order_reduction_mode mode,
+                  IsVisible is_visible,
+                  Rewrite rewrite)
+      : m_mode(mode)
+    {
+      const std::size_t N = summands.size();
+      std::vector<parameter_set> Ts;
+      std::vector<parameter_set> Ws;
+      std::vector<parameter_set> Rs;
+      m_visible.resize(N);
+      for (const auto& summand: summands)
+      {
+        Ts.push_back(parameters(summand.condition, process_parameters));
+        parameter_set W(process_parameters.size());
+        parameter_set R = parameters(summand.multi_action, process_parameters);
+        for (std::size_t i = 0; i < process_parameters.size(); ++i)
+        {
+          if (summand.next_state[i] != process_parameters[i])
+          {
+            W[i] = true;
+            R |= parameters(summand.next_state[i], process_parameters);
+          }
+        }
+        Ws.push_back(W);
+        Rs.push_back(R);
+        m_visible[Ws.size() - 1] = is_visible(summand.multi_action);
+      }
+
+      for (std::size_t k = 0; k < N; ++k)
+      {
+        m_dependent.emplace_back(N);
+        for (std::size_t l = 0; l < N; ++l)
+        {
+          const bool accords = !Ws[k].intersects(Rs[l] | Ws[l]) && !Ws[l].intersects(Rs[k]);
+          const bool independent = accords && !Ws[k].intersects(Ts[l]) && !Ws[l].intersects(Ts[k]);
+          m_dependent[k][l] = k == l || !independent;
+          if (k < l)
+          {
+            m_accordant_pairs += accords ? 1 : 0;
+            m_independent_pairs += independent ? 1 : 0;
+          }
+        }
+
+        m_NES.push_back(writers(Ts[k], Ws));
+        m_conjuncts.emplace_back();
+        const std::set<data::variable> summation_variables(summands[k].variables.begin(), summands[k].variables.end());
+        for (const data::data_expression& e: data::split_and(summands[k].condition))
+        {
+          if (is_closed(e, summation_variables))
+          {
+            summand_set NES = writers(parameters(e, process_parameters), Ws);
+            restrict_to_enabling_writers(e, NES, summands, process_parameters, rewrite);
+            m_conjuncts.back().push_back(conjunct{e, NES});
+          }
+        }
+      }
+    }
+
+    /// \brief Computes a stubborn set in a state, and returns the enabled summands in it.
+    /// \param enabled The summands that are enabled in the state.
+    /// \param is_false Decides whether an expression without summation variables is false in the state.
+    /// \details Every enabled summand is tried as the start of a stubborn set, and the set with the fewest
+    ///          enabled summands is chosen. This function is thread safe.
+    template <typename IsFalse>
+    summand_set enabled_stubborn_set(const summand_set& enabled, IsFalse is_false) const
+    {
+      summand_set result = enabled;
+      std::size_t best = enabled.count();
+      for (std::size_t k = enabled.find_first(); k != summand_set::npos && best > 1; k = enabled.find_next(k))
+      {
+        summand_set T = closure(k, enabled, is_false);
+        T &= enabled;
+        const std::size_t n = T.count();
+        if (n < best)
+        {
+          result = T;
+          best = n;
+        }
+      }
+      return result;
+    }
+
+    /// \returns The number of summands.
+    std::size_t size() const
+    {
+      return m_dependent.size();
+    }
+
+    /// \returns The number of pairs of different summands that accord.
+    std::size_t accordant_pairs() const
+    {
+      return m_accordant_pairs;
+    }
+
+    /// \returns The number of pairs of different summands that are independent.
+    std::size_t independent_pairs() const
+    {
+      return m_independent_pairs;
+    }
+
+    /// \returns The summands with a visible multi-action.
+    const summand_set& visible() const
+    {
+      return m_visible;
+    }
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_PARTIAL_ORDER_REDUCTION_H
@@ -0,0 +1,299 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/sharded_state_set.h
+/// \brief A set of states that is split into shards by the hash of the states.
+
+#ifndef MCRL2_LPS_SHARDED_STATE_SET_H
+#define MCRL2_LPS_SHARDED_STATE_SET_H
+
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "mcrl2/atermpp/standard_containers/indexed_set.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/concurrent_indexed_set.h"
+
+namespace mcrl2::lps {
+
+namespace detail {
+
+/// \brief An array of indices that grows without moving its elements, such that it can be used concurrently.
+/// \details Positions that have not been assigned contain npos.
+class concurrent_index_array
+{
+  public:
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    concurrent_index_array()
+    {
+      for (std::atomic<std::atomic<std::size_t>*>& segment: m_segments)
+      {
+        segment.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    concurrent_index_array(const concurrent_index_array&) = delete;
+    concurrent_index_array& operator=(const concurrent_index_array&) = delete;
+
+    ~concurrent_index_array()
+    {
+      clear();
+    }
+
+    /// \returns The value at the given position, or npos if it has not been assigned.
+    /// \details threadsafe
+    std::size_t load(std::size_t position) const
+    {
+      std::size_t segment;
+      std::size_t offset;
+      utilities::detail::concurrent_segment_position(position, segment, offset);
+      const std::atomic<std::size_t>* values = m_segments[segment].load(std::memory_order_acquire);
+      return values == nullptr ? npos : values[offset].load(std::memory_order_acquire);
+    }
+
+    /// \brief Assigns the value to the given position, allocating its segment when necessary.
+    /// \details threadsafe
+    void store(std::size_t position, std::size_t value)
+    {
+      std::size_t segment;
+      std::size_t offset;
+      utilities::detail::concurrent_segment_position(position, segment, offset);
+      assert(segment < number_of_segments);
+
+      std::atomic<std::size_t>* values = m_segments[segment].load(std::memory_order_acquire);
+      if (values == nullptr)
+      {
+        // Only one of the threads that allocate a segment concurrently succeeds in installing it.
+        const std::size_t size = utilities::detail::concurrent_first_segment_size << segment;
+        std::atomic<std::size_t>* fresh = new std::atomic<std::size_t>[size];
+        for (std::size_t i = 0; i < size; ++i)
+        {
+          fresh[i].store(npos, std::memory_order_relaxed);
+        }
+
+        if (m_segments[segment].compare_exchange_strong(values, fresh))
+        {
+          values = fresh;
+        }
+        else
+        {
+          delete[] fresh;
+        }
+      }
+      values[offset].store(value, std::memory_order_release);
+    }
+
+    /// \brief Removes all values, this is not threadsafe.
+    void clear()
+    {
+      for (std::atomic<std::atomic<std::size_t>*>& segment: m_segments)
+      {
+        delete[] segment.exchange(nullptr);
+      }
+    }
+
+  private:
+    static constexpr std::size_t number_of_segments = 48;
+
+    std::atomic<std::atomic<std::size_t>*> m_segments[number_of_segments];
+};
+
+} // namespace detail
+
+/// \brief The number of insertions into the shard owned by the group of the inserting thread, and into other shards.
+struct sharded_state_set_statistics
+{
+  std::size_t local_inserts = 0;
+  std::size_t remote_inserts = 0;
+};
+
+/// \brief A set of states that assigns each state an unique index, where the states are divided over shards.
+/// \details The hash of a state determines the shard in which it is stored, and every shard has its own hash
+///          table, such that every hash table is resized and written by fewer threads at a time. The threads
+///          are divided into as many consecutive groups as there are shards, and the statistics record whether
+///          a thread inserts into the shard with the number of its group. The memory of a shard is not placed
+///          near the threads of its group.
+///
+///          The indices of states are global, and there are no holes in the numbering as for an indexed set.
+///          A global index is assigned when a state is newly inserted in its shard, and every shard maps the
+///          indices of its states to the global indices. The interface corresponds to that of an indexed set
+///          of states, and it can be used concurrently. The size only counts states of which the state, and
+///          the states with smaller indices, can be obtained with operator[].
+class sharded_state_set
+{
+  public:
+    typedef std::size_t size_type;
+
+    /// \brief Value returned when a state does not occur in the set.
+    static constexpr size_type npos = detail::concurrent_index_array::npos;
+
+    /// \brief Constructor of an empty set of states.
+    /// \param number_of_threads The threads are numbered from 0 up to and including number_of_threads.
+    sharded_state_set(std::size_t number_of_shards, std::size_t number_of_threads = 1)
+      : m_number_of_threads(number_of_threads),
+        m_statistics(number_of_threads + 1)
+    {
+      assert(number_of_shards > 0);
+      for (std::size_t i = 0; i < number_of_shards; ++i)
+      {
+        m_shards.push_back(std::make_unique<shard>(number_of_threads));
+      }
+    }
+
+    /// \returns The index of the given state, or npos if the state does not occur in the set.
+    /// \details threadsafe
+    size_type index(const state& s, std::size_t thread_index = 0) const
+    {
+      const std::size_t k = shard_of(s);
+      const std::size_t local = m_shards[k]->states.index(s, thread_index);
+      if (local == npos)
+      {
+        return npos;
+      }
+      return global_index(k, local);
+    }
+
+    /// \brief Insert a state in the set and return its index.
+    /// \details If the state was already in the set, the resulting bool is false, and the existing index is returned.
+    ///          Otherwise, the state is inserted in the set, and the next available index is assigned to it.
+    /// \details threadsafe
+    std::pair<size_type, bool> insert(const state& s, std::size_t thread_index = 0)
+    {
+      const std::size_t k = shard_of(s);
+      if (k == group_of(thread_index))
+      {
+        m_statistics[thread_index].local_inserts++;
+      }
+      else
+      {
+        m_statistics[thread_index].remote_inserts++;
+      }
+
+      shard& sh = *m_shards[k];
+      const std::pair<size_type, bool> p = sh.states.insert(s, thread_index);
+      if (!p.second)
+      {
+        return std::make_pair(global_index(k, p.first), false);
+      }
+
+      const size_type index = m_next_index.fetch_add(1);
+      m_locations.store(index, p.first * m_shards.size() + k);
+      sh.global_indices.store(p.first, index);
+
+      // The size is increased in the order of the indices, after the locations of the states are stored.
+      while (m_size.load(std::memory_order_acquire) != index)
+      {
+        std::this_thread::yield();
+      }
+      m_size.store(index + 1, std::memory_order_release);
+      return std::make_pair(index, true);
+    }
+
+    /// \returns The state with the given index.
+    /// \details threadsafe
+    state operator[](size_type index) const
+    {
+      const std::size_t location = m_locations.load(index);
+      assert(location != npos);
+      return m_shards[location % m_shards.size()]->states[location / m_shards.size()];
+    }
+
+    /// \returns The number of states in the set.
+    /// \details threadsafe
+    size_type size(std::size_t /* thread_index */ = 0) const
+    {
+      return m_size.load(std::memory_order_acquire);
+    }
+
+    /// \brief Removes all states, this is not threadsafe.
+    void clear(std::size_t thread_index = 0)
+    {
+      for (std::unique_ptr<shard>& sh: m_shards)
+      {
+        sh->states.clear(thread_index);
+        sh->global_indices.clear();
+      }
+      m_locations.clear();
+      m_next_index = 0;
+      m_size = 0;
+    }
+
+    /// \returns The number of shards.
+    std::size_t number_of_shards() const
+    {
+      return m_shards.size();
+    }
+
+    /// \returns The number of local and remote insertions of all threads together.
+    sharded_state_set_statistics statistics() const
+    {
+      sharded_state_set_statistics result;
+      for (const thread_statistics& s: m_statistics)
+      {
+        result.local_inserts += s.local_inserts;
+        result.remote_inserts += s.remote_inserts;
+      }
+      return result;
+    }
+
+  private:
+    struct shard
+    {
+      atermpp::indexed_set<state, mcrl2::utilities::detail::GlobalThreadSafe> states;
+      detail::concurrent_index_array global_indices; // The global index of every state in this shard.
+
+      explicit shard(std::size_t number_of_threads)
+        : states(number_of_threads)
+      {}
+    };
+
+    // Every thread only updates its own counters, which are kept in separate cache lines.
+    struct alignas(64) thread_statistics: public sharded_state_set_statistics
+    {};
+
+    std::size_t shard_of(const state& s) const
+    {
+      // The lower bits of the hash also determine the bucket within a shard, so they are mixed first.
+      const std::size_t h = std::hash<state>()(s) * 0x9E3779B97F4A7C15ull;
+      return (h >> 32) % m_shards.size();
+    }
+
+    // Threads are numbered from 1 when there are several, and thread 0 is the only thread otherwise.
+    std::size_t group_of(std::size_t thread_index) const
+    {
+      return thread_index == 0 ? 0 : ((thread_index - 1) * m_shards.size()) / m_number_of_threads;
+    }
+
+    // Waits until the thread that inserted the state with the given local index has assigned its global index.
+    size_type global_index(std::size_t k, size_type local) const
+    {
+      size_type result = m_shards[k]->global_indices.load(local);
+      while (result == npos)
+      {
+        std::this_thread::yield();
+        result = m_shards[k]->global_indices.load(local);
+      }
+      return result;
+    }
+
+    std::size_t m_number_of_threads;
+    std::vector<std::unique_ptr<shard>> m_shards;
+    detail::concurrent_index_array m_locations; // The shard and its local index for every global index.
+    std::atomic<size_type> m_next_index = 0; // The next global index that is claimed by an insertion.
+    std::atomic<size_type> m_size = 0;       // The number of global indices of which the location has been stored.
+    std::vector<thread_statistics> m_statistics;
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_SHARDED_STATE_SET_H
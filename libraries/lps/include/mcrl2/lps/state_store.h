@@ -0,0 +1,261 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/state_store.h
+/// \brief The set in which the explorer stores its discovered states.
+
+#ifndef MCRL2_LPS_STATE_STORE_H
+#define MCRL2_LPS_STATE_STORE_H
+
+#include "mcrl2/atermpp/standard_containers/indexed_set.h"
+#include "mcrl2/lps/bitstate_state_set.h"
+#include "mcrl2/lps/external_state_set.h"
+#include "mcrl2/lps/sharded_state_set.h"
+#include "mcrl2/lps/tree_compressed_state_set.h"
+
+namespace mcrl2::lps {
+
+/// \brief Assigns an unique index to every discovered state.
+/// \details By default the states are stored as terms in an indexed set. After enable_tree_compression
+///          the states are stored in a tree_compressed_state_set instead, which uses less memory for
+///          states with many parameters at the cost of (de)composing the state on every access. After
+///          enable_sharding the states are stored in a sharded_state_set, which divides them over several
+///          hash tables. After enable_external_storage the states are stored on disk in an external_state_set,
+///          which can only be filled through its own interface, as duplicates are detected in batches. After
+///          enable_bitstate_hashing only hash values of the states are stored in a bitstate_state_set, which
+///          may omit states, and in which the index of a state is its fingerprint.
+class state_store
+{
+  public:
+    typedef std::size_t size_type;
+
+    /// \brief Value returned by index when a state does not occur in the store, which all storage methods share.
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    /// \brief Constructor of an empty store.
+    /// \param number_of_threads The number of threads, with the same conventions as for atermpp::indexed_set.
+    state_store(std::size_t number_of_threads = 1)
+      : m_states(number_of_threads),
+        m_number_of_threads(number_of_threads)
+    {}
+
+    /// \brief Stores states with the given number of parameters using tree compression from now on.
+    /// \details The store must be empty.
+    void enable_tree_compression(std::size_t arity)
+    {
+      assert(size() == 0 && !sharding());
+      m_tree = std::make_unique<tree_compressed_state_set>(arity, m_number_of_threads);
+    }
+
+    /// \brief Stores states in the given number of shards from now on.
+    /// \details The store must be empty.
+    void enable_sharding(std::size_t number_of_shards)
+    {
+      assert(size() == 0 && !tree_compression());
+      m_shards = std::make_unique<sharded_state_set>(number_of_shards, m_number_of_threads);
+    }
+
+    /// \brief Stores the states on disk, in a subdirectory of the given directory, from now on.
+    /// \details The store must be empty.
+    void enable_external_storage(const std::filesystem::path& directory)
+    {
+      assert(size() == 0 && !tree_compression() && !sharding());
+      m_external = std::make_unique<external_state_set>(directory);
+    }
+
+    /// \brief Only stores hash values of the states, using the given number of bytes, from now on.
+    /// \details The store must be empty.
+    void enable_bitstate_hashing(std::size_t memory, std::size_t number_of_hashes, bool hash_compaction, std::uint64_t seed = 0)
+    {
+      assert(size() == 0 && !tree_compression() && !sharding() && !external_storage());
+      m_bitstate = std::make_unique<bitstate_state_set>(memory, number_of_hashes, hash_compaction, seed);
+    }
+
+    /// \returns True iff only hash values of the states are stored.
+    bool bitstate_hashing() const
+    {
+      return m_bitstate != nullptr;
+    }
+
+    /// \returns The set of hash values of the states, only valid if bitstate_hashing() holds.
+    const bitstate_state_set& bitstate_states() const
+    {
+      assert(bitstate_hashing());
+      return *m_bitstate;
+    }
+
+    /// \returns True iff the states are stored on disk.
+    bool external_storage() const
+    {
+      return m_external != nullptr;
+    }
+
+    /// \returns The set on disk in which the states are stored, only valid if external_storage() holds.
+    external_state_set& external_states()
+    {
+      assert(external_storage());
+      return *m_external;
+    }
+
+    /// \returns The set on disk in which the states are stored, only valid if external_storage() holds.
+    const external_state_set& external_states() const
+    {
+      assert(external_storage());
+      return *m_external;
+    }
+
+    /// \returns True iff the states are stored in shards.
+    bool sharding() const
+    {
+      return m_shards != nullptr;
+    }
+
+    /// \returns The sharded set in which the states are stored, only valid if sharding() holds.
+    const sharded_state_set& sharded_states() const
+    {
+      assert(sharding());
+      return *m_shards;
+    }
+
+    /// \returns True iff the states are stored using tree compression.
+    bool tree_compression() const
+    {
+      return m_tree != nullptr;
+    }
+
+    /// \returns The tree compressed set in which the states are stored, only valid if tree_compression() holds.
+    const tree_compressed_state_set& tree_compressed_states() const
+    {
+      assert(tree_compression());
+      return *m_tree;
+    }
+
+    /// \returns The index of the given state, which is at least size() when the state has not been stored.
+    /// \details threadsafe
+    size_type index(const state& s, std::size_t thread_index = 0) const
+    {
+      assert(!external_storage());
+      if (m_bitstate)
+      {
+        return m_bitstate->index(s, thread_index);
+      }
+      if (m_shards)
+      {
+        return m_shards->index(s, thread_index);
+      }
+      return m_tree ? m_tree->index(s, thread_index) : m_states.index(s, thread_index);
+    }
+
+    /// \brief Stores the given state, and returns its index and whether it was newly stored.
+    /// \details threadsafe
+    std::pair<size_type, bool> insert(const state& s, std::size_t thread_index = 0)
+    {
+      assert(!external_storage());
+      if (m_bitstate)
+      {
+        return m_bitstate->insert(s, thread_index);
+      }
+      if (m_shards)
+      {
+        return m_shards->insert(s, thread_index);
+      }
+      return m_tree ? m_tree->insert(s, thread_index) : m_states.insert(s, thread_index);
+    }
+
+    /// \returns The state with the given index.
+    /// \details threadsafe, except when the states are stored on disk.
+    state operator[](size_type index) const
+    {
+      if (m_external)
+      {
+        return (*m_external)[index];
+      }
+      if (m_bitstate)
+      {
+        return (*m_bitstate)[index];
+      }
+      if (m_shards)
+      {
+        return (*m_shards)[index];
+      }
+      return m_tree ? (*m_tree)[index] : m_states[index];
+    }
+
+    /// \returns The number of stored states.
+    /// \details threadsafe
+    size_type size(std::size_t thread_index = 0) const
+    {
+      if (m_external)
+      {
+        return m_external->size();
+      }
+      if (m_bitstate)
+      {
+        return m_bitstate->size(thread_index);
+      }
+      if (m_shards)
+      {
+        return m_shards->size(thread_index);
+      }
+      return m_tree ? m_tree->size(thread_index) : m_states.size(thread_index);
+    }
+
+    /// \returns The fraction of the hash table or bitstate memory that is in use, or 0 for the tree compressed,
+    ///          sharded and external stores that have no single table.
+    /// \details threadsafe
+    double load_factor(std::size_t thread_index = 0) const
+    {
+      if (m_bitstate)
+      {
+        return m_bitstate->load_factor();
+      }
+      if (m_external || m_shards || m_tree)
+      {
+        return 0.0;
+      }
+      const size_type capacity = m_states.capacity(thread_index);
+      return capacity == 0 ? 0.0 : static_cast<double>(m_states.size(thread_index)) / static_cast<double>(capacity);
+    }
+
+    /// \brief Removes all states, this is not threadsafe.
+    void clear(std::size_t thread_index = 0)
+    {
+      if (m_external)
+      {
+        m_external->clear();
+      }
+      else if (m_bitstate)
+      {
+        m_bitstate->clear(thread_index);
+      }
+      else if (m_shards)
+      {
+        m_shards->clear(thread_index);
+      }
+      else if (m_tree)
+      {
+        m_tree->clear(thread_index);
+      }
+      else
+      {
+        m_states.clear(thread_index);
+      }
+    }
+
+  private:
+    atermpp::indexed_set<state, mcrl2::utilities::detail::GlobalThreadSafe> m_states;
+    std::unique_ptr<tree_compressed_state_set> m_tree;
+    std::unique_ptr<sharded_state_set> m_shards;
+    std::unique_ptr<external_state_set> m_external;
+    std::unique_ptr<bitstate_state_set> m_bitstate;
+    std::size_t m_number_of_threads;
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_STATE_STORE_H
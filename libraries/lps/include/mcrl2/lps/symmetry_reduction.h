@@ -0,0 +1,380 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/symmetry_reduction.h
+/// \brief Symmetry reduction, in which states that are equal up to a permutation of process parameters are identified.
+
+#ifndef MCRL2_LPS_SYMMETRY_REDUCTION_H
+#define MCRL2_LPS_SYMMETRY_REDUCTION_H
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "mcrl2/atermpp/aterm_int.h"
+#include "mcrl2/data/join.h"
+#include "mcrl2/data/substitutions/mutable_map_substitution.h"
+#include "mcrl2/lps/replace.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/text_utility.h"
+
+namespace mcrl2::lps {
+
+/// \brief Groups of blocks of process parameters that can be permuted, and the computation of a canonical
+///        representative of a state under these permutations.
+/// \details A group consists of blocks of process parameters with the same sorts, for instance the program
+///          counter and the local variables of identical components. A permutation of the blocks of a group is
+///          a symmetry if it maps the summands of the linear process to summands, where summands are compared
+///          syntactically up to the order of the conjuncts of their conditions. In that case every state is
+///          bisimilar to the state obtained by permuting its values accordingly, so only a representative of
+///          every class of symmetric states has to be explored. This preserves deadlocks and the occurrences
+///          of actions. The representative is obtained by sorting the blocks of every group with respect to
+///          a structural order on terms, which does not depend on the addresses of terms.
+///
+///          The groups are given as text of the form "x1:y1,x2:y2;z1,z2,z3", where groups are separated by
+///          semicolons, the blocks of a group by commas and the parameters of a block by colons. The text
+///          "auto" detects groups of single parameters, for which every transposition of two parameters of a
+///          group is a symmetry.
+class symmetry_reduction
+{
+  public:
+    typedef std::vector<std::size_t> block; // The indices of the process parameters of a block.
+    typedef std::vector<block> group;
+
+  protected:
+    std::vector<group> m_groups;
+
+    // A summand in which the next state is given for every parameter and the condition is split into conjuncts,
+    // such that summands can be compared syntactically. The summation variables are named after their position,
+    // and the global variables after their sort, as the linearisation of identical components uses different
+    // names for them.
+    typedef std::tuple<data::variable_list, std::set<data::data_expression>, process::action_list, data::data_expression, std::vector<data::data_expression>> summand_key;
+
+    // Returns the summands of the specification, where the parameters are renamed according to the permutation pi
+    // of their indices.
+    template <typename Specification>
+    static std::set<summand_key> summand_keys(const Specification& lpsspec, const std::vector<std::size_t>& pi)
+    {
+      const auto& process = lpsspec.process();
+      const std::vector<data::variable> parameters(process.process_parameters().begin(), process.process_parameters().end());
+      data::mutable_map_substitution<> rho;
+      for (std::size_t i = 0; i < parameters.size(); ++i)
+      {
+        if (pi[i] != i)
+        {
+          rho[parameters[i]] = parameters[pi[i]];
+        }
+      }
+      for (const data::variable& v: lpsspec.global_variables())
+      {
+        rho[v] = data::variable("@global", v.sort());
+      }
+
+      const auto rename_summation_variables = [&](const data::variable_list& variables)
+      {
+        std::vector<data::variable> result;
+        for (const data::variable& v: variables)
+        {
+          result.emplace_back("@sum" + std::to_string(result.size()), v.sort());
+          rho[v] = result.back();
+        }
+        return data::variable_list(result.begin(), result.end());
+      };
+
+      const auto conjuncts = [&](const data::data_expression& condition)
+      {
+        const std::set<data::data_expression> result = data::split_and(data::replace_variables(condition, rho));
+        return result;
+      };
+
+      std::set<summand_key> result;
+      for (const auto& summand: process.action_summands())
+      {
+        const data::variable_list summation_variables = rename_summation_variables(summand.summation_variables());
+        std::vector<data::data_expression> next_state(parameters.begin(), parameters.end());
+        for (const data::assignment& a: summand.assignments())
+        {
+          const std::size_t i = std::find(parameters.begin(), parameters.end(), a.lhs()) - parameters.begin();
+          next_state[i] = a.rhs();
+        }
+        std::vector<data::data_expression> renamed_next_state(parameters.size());
+        for (std::size_t i = 0; i < parameters.size(); ++i)
+        {
+          renamed_next_state[pi[i]] = data::replace_variables(next_state[i], rho);
+        }
+        const lps::multi_action a = lps::replace_variables(summand.multi_action(), rho);
+        result.insert(summand_key(summation_variables, conjuncts(summand.condition()), a.actions(), a.time(), renamed_next_state));
+        for (const data::variable& v: summand.summation_variables())
+        {
+          rho[v] = v;
+        }
+      }
+      for (const auto& summand: process.deadlock_summands())
+      {
+        const data::variable_list summation_variables = rename_summation_variables(summand.summation_variables());
+        const data::data_expression time = summand.deadlock().has_time() ? data::replace_variables(summand.deadlock().time(), rho) : data::data_expression();
+        result.insert(summand_key(summation_variables, conjuncts(summand.condition()), process::action_list(), time, {}));
+        for (const data::variable& v: summand.summation_variables())
+        {
+          rho[v] = v;
+        }
+      }
+      return result;
+    }
+
+    // Returns true if swapping the blocks b1 and b2 is a symmetry of the process.
+    template <typename Specification>
+    static bool is_symmetry(const Specification& lpsspec, const std::set<summand_key>& summands, const block& b1, const block& b2)
+    {
+      std::vector<std::size_t> pi(lpsspec.process().process_parameters().size());
+      std::iota(pi.begin(), pi.end(), 0);
+      for (std::size_t i = 0; i < b1.size(); ++i)
+      {
+        std::swap(pi[b1[i]], pi[b2[i]]);
+      }
+      return summand_keys(lpsspec, pi) == summands;
+    }
+
+    template <typename Specification>
+    void detect_groups(const Specification& lpsspec, const std::set<summand_key>& summands)
+    {
+      const data::variable_list& process_parameters = lpsspec.process().process_parameters();
+      const std::vector<data::variable> parameters(process_parameters.begin(), process_parameters.end());
+      std::vector<std::size_t> representative(parameters.size());
+      std::iota(representative.begin(), representative.end(), 0);
+
+      // The transpositions that are symmetries generate the full permutation group on each class of the
+      // equivalence that they induce, so the parameters are partitioned into these classes.
+      for (std::size_t i = 0; i < parameters.size(); ++i)
+      {
+        for (std::size_t j = i + 1; j < parameters.size(); ++j)
+        {
+          if (representative[j] == j && parameters[i].sort() == parameters[j].sort() && is_symmetry(lpsspec, summands, {i}, {j}))
+          {
+            representative[j] = representative[i];
+          }
+        }
+      }
+
+      std::map<std::size_t, group> classes;
+      for (std::size_t i = 0; i < parameters.size(); ++i)
+      {
+        classes[representative[i]].push_back({i});
+      }
+      for (const auto& [i, g]: classes)
+      {
+        if (g.size() > 1)
+        {
+          m_groups.push_back(g);
+        }
+      }
+    }
+
+    template <typename Specification>
+    void parse_groups(const Specification& lpsspec, const std::set<summand_key>& summands, const std::string& text)
+    {
+      const data::variable_list& process_parameters = lpsspec.process().process_parameters();
+      const std::vector<data::variable> parameters(process_parameters.begin(), process_parameters.end());
+      std::set<std::size_t> used;
+      for (const std::string& group_text: utilities::split(text, ";"))
+      {
+        group g;
+        for (const std::string& block_text: utilities::split(group_text, ","))
+        {
+          block b;
+          for (const std::string& name: utilities::split(block_text, ":"))
+          {
+            const std::string id = utilities::trim_copy(name);
+            auto i = std::find_if(parameters.begin(), parameters.end(), [&](const data::variable& v) { return std::string(v.name()) == id; });
+            if (i == parameters.end())
+            {
+              throw mcrl2::runtime_error("the symmetry refers to '" + id + "', which is not a process parameter");
+            }
+            if (!used.insert(i - parameters.begin()).second)
+            {
+              throw mcrl2::runtime_error("the process parameter '" + id + "' occurs more than once in the symmetry");
+            }
+            b.push_back(i - parameters.begin());
+          }
+          if (!g.empty())
+          {
+            if (b.size() != g.front().size())
+            {
+              throw mcrl2::runtime_error("the blocks of the symmetry group '" + group_text + "' have different sizes");
+            }
+            for (std::size_t i = 0; i < b.size(); ++i)
+            {
+              if (parameters[b[i]].sort() != parameters[g.front()[i]].sort())
+              {
+                throw mcrl2::runtime_error("the parameters of the blocks of the symmetry group '" + group_text + "' have different sorts");
+              }
+            }
+          }
+          g.push_back(b);
+        }
+
+        // The transpositions of adjacent blocks generate all permutations of the blocks.
+        for (std::size_t i = 0; i + 1 < g.size(); ++i)
+        {
+          if (!is_symmetry(lpsspec, summands, g[i], g[i + 1]))
+          {
+            throw mcrl2::runtime_error("the symmetry group '" + group_text + "' is not a symmetry of the linear process");
+          }
+        }
+        if (g.size() > 1)
+        {
+          m_groups.push_back(g);
+        }
+      }
+    }
+
+    // A total order on terms that only depends on their structure.
+    static int compare(const atermpp::aterm& t1, const atermpp::aterm& t2)
+    {
+      if (t1 == t2)
+      {
+        return 0;
+      }
+      if (t1.type_is_int() || t2.type_is_int())
+      {
+        if (t1.type_is_int() && t2.type_is_int())
+        {
+          const std::size_t n1 = atermpp::down_cast<atermpp::aterm_int>(t1).value();
+          const std::size_t n2 = atermpp::down_cast<atermpp::aterm_int>(t2).value();
+          return n1 < n2 ? -1 : 1;
+        }
+        return t1.type_is_int() ? -1 : 1;
+      }
+      if (t1.function() != t2.function())
+      {
+        if (t1.function().arity() != t2.function().arity())
+        {
+          return t1.function().arity() < t2.function().arity() ? -1 : 1;
+        }
+        const int result = t1.function().name().compare(t2.function().name());
+        if (result != 0)
+        {
+          return result;
+        }
+      }
+      for (std::size_t i = 0; i < t1.function().arity(); ++i)
+      {
+        const int result = compare(t1[i], t2[i]);
+        if (result != 0)
+        {
+          return result;
+        }
+      }
+      return 0;
+    }
+
+  public:
+    /// \brief Constructor that detects or parses the groups of the process of a linear specification.
+    /// \param text Either "auto" or a description of the groups as explained above.
+    template <typename Specification>
+    symmetry_reduction(const Specification& lpsspec, const std::string& text)
+    {
+      std::vector<std::size_t> identity(lpsspec.process().process_parameters().size());
+      std::iota(identity.begin(), identity.end(), 0);
+      const std::set<summand_key> summands = summand_keys(lpsspec, identity);
+      if (text == "auto")
+      {
+        detect_groups(lpsspec, summands);
+      }
+      else
+      {
+        parse_groups(lpsspec, summands, text);
+      }
+    }
+
+    /// \brief Replaces s by the representative of its class of symmetric states.
+    /// \details This function is thread safe.
+    void canonicalize(state& s) const
+    {
+      std::vector<data::data_expression> v(s.begin(), s.end());
+      bool changed = false;
+      for (const group& g: m_groups)
+      {
+        const auto less = [&](const block& b1, const block& b2)
+        {
+          for (std::size_t i = 0; i < b1.size(); ++i)
+          {
+            const int result = compare(v[b1[i]], v[b2[i]]);
+            if (result != 0)
+            {
+              return result < 0;
+            }
+          }
+          return false;
+        };
+
+        std::vector<block> sorted = g;
+        std::stable_sort(sorted.begin(), sorted.end(), less);
+        if (sorted != g)
+        {
+          const std::vector<data::data_expression> values = v;
+          for (std::size_t k = 0; k < g.size(); ++k)
+          {
+            for (std::size_t i = 0; i < g[k].size(); ++i)
+            {
+              v[g[k][i]] = values[sorted[k][i]];
+            }
+          }
+          changed = true;
+        }
+      }
+      if (changed)
+      {
+        make_state(s, v.begin(), v.size());
+      }
+    }
+
+    /// \returns The groups of blocks of process parameters.
+    const std::vector<group>& groups() const
+    {
+      return m_groups;
+    }
+
+    /// \returns True iff there is a group, such that the reduction has an effect.
+    bool empty() const
+    {
+      return m_groups.empty();
+    }
+};
+
+/// \brief Prints the groups of a symmetry reduction in the format in which they are given by the user.
+inline
+std::string print_symmetry_groups(const symmetry_reduction& symmetry, const data::variable_list& process_parameters)
+{
+  const std::vector<data::variable> parameters(process_parameters.begin(), process_parameters.end());
+  std::vector<std::string> groups;
+  for (const symmetry_reduction::group& g: symmetry.groups())
+  {
+    std::vector<std::string> blocks;
+    for (const symmetry_reduction::block& b: g)
+    {
+      std::vector<std::string> names;
+      for (std::size_t i: b)
+      {
+        names.push_back(parameters[i].name());
+      }
+      blocks.push_back(utilities::string_join(names, ":"));
+    }
+    groups.push_back(utilities::string_join(blocks, ","));
+  }
+  return utilities::string_join(groups, ";");
+}
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_SYMMETRY_REDUCTION_H
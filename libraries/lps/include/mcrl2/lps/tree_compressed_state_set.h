@@ -0,0 +1,304 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file mcrl2/lps/tree_compressed_state_set.h
+/// \brief A set of states that stores states using recursive tree compression.
+
+#ifndef MCRL2_LPS_TREE_COMPRESSED_STATE_SET_H
+#define MCRL2_LPS_TREE_COMPRESSED_STATE_SET_H
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "mcrl2/atermpp/standard_containers/concurrent_indexed_set.h"
+#include "mcrl2/lps/state.h"
+#include "mcrl2/utilities/exception.h"
+#include "mcrl2/utilities/hash_utility.h"
+
+namespace mcrl2::lps {
+
+namespace detail {
+
+/// \brief Hash function for a tree node, which consists of two 32 bit indices packed into one number.
+struct tree_node_hash
+{
+  std::size_t operator()(std::uint64_t node) const
+  {
+    return utilities::detail::hash_combine(static_cast<std::size_t>(node >> 32), static_cast<std::size_t>(node & 0xffffffff));
+  }
+};
+
+} // namespace detail
+
+/// \brief A set of states of a fixed length that assigns each state an unique index.
+/// \details The state vector is split recursively into two halves. Every parameter has a table with its
+///          values, and every split has a table with pairs of indices of its left and right half. The
+///          index of a state is the index of its pair in the table of the top most split. As states
+///          typically differ in only a few parameters, a new state only adds a few pairs to the tables,
+///          which makes this representation considerably more compact than storing the states as terms.
+///          This is the tree compression technique of LTSmin.
+///
+///          The interface corresponds to that of an indexed set of states, and it can be used concurrently.
+class tree_compressed_state_set
+{
+  public:
+    typedef std::size_t size_type;
+
+    /// \brief Value returned when a state does not occur in the set.
+    static constexpr size_type npos = utilities::concurrent_indexed_set<std::uint64_t>::npos;
+
+    /// \brief Constructor of an empty set of states with the given number of parameters.
+    /// \param number_of_threads The threads are numbered from 0 up to and including number_of_threads.
+    tree_compressed_state_set(std::size_t arity, std::size_t number_of_threads = 1)
+      : m_arity(arity),
+        m_values(arity),
+        m_scratch(number_of_threads + 1)
+    {
+      for (std::unique_ptr<value_table>& table: m_values)
+      {
+        table = std::make_unique<value_table>(number_of_threads);
+      }
+
+      if (arity >= 2)
+      {
+        make_nodes(0, arity);
+      }
+      else
+      {
+        // The tree has a single node, of which the left child is the only parameter, if there is one.
+        m_nodes.emplace_back(arity == 1 ? child{true, 0} : child{false, no_child}, child{false, no_child});
+      }
+
+      m_tables.resize(m_nodes.size());
+      for (std::unique_ptr<node_table>& table: m_tables)
+      {
+        table = std::make_unique<node_table>(number_of_threads);
+      }
+
+      for (scratch& s: m_scratch)
+      {
+        s.values.resize(m_arity);
+        s.nodes.resize(m_nodes.size());
+      }
+    }
+
+    /// \returns The index of the given state, or npos if the state does not occur in the set.
+    /// \details A state with a different number of parameters never occurs in the set. threadsafe
+    size_type index(const state& s, std::size_t thread_index = 0) const
+    {
+      if (s.size() != m_arity)
+      {
+        return npos;
+      }
+      scratch& current = m_scratch[thread_index];
+
+      std::size_t i = 0;
+      for (const data::data_expression& value: s)
+      {
+        current.values[i] = m_values[i]->index(value, thread_index);
+        if (current.values[i] == npos)
+        {
+          return npos;
+        }
+        ++i;
+      }
+
+      for (std::size_t n = 0; n < m_nodes.size(); ++n)
+      {
+        current.nodes[n] = m_tables[n]->index(pack(current, n), thread_index);
+        if (current.nodes[n] == npos)
+        {
+          return npos;
+        }
+      }
+
+      return current.nodes.back();
+    }
+
+    /// \brief Insert a state in the set and return its index.
+    /// \details If the state was already in the set, the resulting bool is false, and the existing index is returned.
+    ///          Otherwise, the state is inserted in the set, and the next available index is assigned to it.
+    /// \details threadsafe
+    std::pair<size_type, bool> insert(const state& s, std::size_t thread_index = 0)
+    {
+      assert(s.size() == m_arity);
+      scratch& current = m_scratch[thread_index];
+
+      std::size_t i = 0;
+      for (const data::data_expression& value: s)
+      {
+        current.values[i] = m_values[i]->insert(value, thread_index).first;
+        ++i;
+      }
+
+      for (std::size_t n = 0; n + 1 < m_nodes.size(); ++n)
+      {
+        current.nodes[n] = m_tables[n]->insert(pack(current, n), thread_index).first;
+      }
+
+      return m_tables.back()->insert(pack(current, m_nodes.size() - 1), thread_index);
+    }
+
+    /// \returns The state with the given index.
+    /// \details threadsafe
+    state operator[](size_type index) const
+    {
+      std::vector<std::size_t> nodes(m_nodes.size());
+      std::vector<data::data_expression> values(m_arity);
+
+      // The parents precede their children in the reverse order of the nodes.
+      nodes.back() = index;
+      for (std::size_t n = m_nodes.size(); n-- > 0; )
+      {
+        const std::uint64_t pair = (*m_tables[n])[nodes[n]];
+        unpack(m_nodes[n].first, static_cast<std::size_t>(pair >> 32), nodes, values);
+        unpack(m_nodes[n].second, static_cast<std::size_t>(pair & 0xffffffff), nodes, values);
+      }
+
+      state result;
+      make_state(result, values.begin(), m_arity);
+      return result;
+    }
+
+    /// \returns The number of states in the set.
+    /// \details threadsafe
+    size_type size(std::size_t thread_index = 0) const
+    {
+      return m_tables.back()->size(thread_index);
+    }
+
+    /// \brief Removes all states, this is not threadsafe.
+    void clear(std::size_t thread_index = 0)
+    {
+      for (std::unique_ptr<value_table>& table: m_values)
+      {
+        table->clear(thread_index);
+      }
+
+      for (std::unique_ptr<node_table>& table: m_tables)
+      {
+        table->clear(thread_index);
+      }
+    }
+
+    /// \returns The number of parameters of the stored states.
+    std::size_t arity() const
+    {
+      return m_arity;
+    }
+
+    /// \returns The total number of pairs stored for all splits of the state vector, including the states themselves.
+    std::size_t number_of_nodes() const
+    {
+      std::size_t result = 0;
+      for (const std::unique_ptr<node_table>& table: m_tables)
+      {
+        result += table->size();
+      }
+      return result;
+    }
+
+    /// \returns The total number of distinct values stored for all parameters.
+    std::size_t number_of_values() const
+    {
+      std::size_t result = 0;
+      for (const std::unique_ptr<value_table>& table: m_values)
+      {
+        result += table->size();
+      }
+      return result;
+    }
+
+  private:
+    typedef atermpp::concurrent_indexed_set<data::data_expression> value_table;
+    typedef utilities::concurrent_indexed_set<std::uint64_t, detail::tree_node_hash> node_table;
+
+    /// \brief A child of a node is either a parameter or another node, given by its position.
+    struct child
+    {
+      bool is_parameter;
+      std::size_t position;
+    };
+
+    /// \brief Indicates that a node has no child, its index is then always zero.
+    static constexpr std::size_t no_child = std::numeric_limits<std::size_t>::max();
+
+    /// \brief Buffers for the indices of the parameters and nodes of a state, one for each thread.
+    struct scratch
+    {
+      std::vector<std::size_t> values;
+      std::vector<std::size_t> nodes;
+    };
+
+    /// \brief Adds the nodes for the parameters [first, last) such that children precede their parents.
+    /// \returns The child that refers to the tree of these parameters.
+    child make_nodes(std::size_t first, std::size_t last)
+    {
+      if (last - first == 1)
+      {
+        return child{true, first};
+      }
+
+      const std::size_t middle = first + (last - first) / 2;
+      const child left = make_nodes(first, middle);
+      const child right = make_nodes(middle, last);
+      m_nodes.emplace_back(left, right);
+      return child{false, m_nodes.size() - 1};
+    }
+
+    /// \returns The index of the given child, which must have been computed already.
+    static std::size_t index_of(const scratch& current, const child& c)
+    {
+      if (c.position == no_child)
+      {
+        return 0;
+      }
+      return c.is_parameter ? current.values[c.position] : current.nodes[c.position];
+    }
+
+    /// \returns The pair of indices of the children of node n.
+    std::uint64_t pack(const scratch& current, std::size_t n) const
+    {
+      const std::size_t left = index_of(current, m_nodes[n].first);
+      const std::size_t right = index_of(current, m_nodes[n].second);
+      if (left > 0xffffffff || right > 0xffffffff)
+      {
+        throw mcrl2::runtime_error("The tree compressed state set can store at most 2^32 distinct values for each part of the state.");
+      }
+      return (static_cast<std::uint64_t>(left) << 32) | right;
+    }
+
+    /// \brief Assigns the index to the given child, where the value of a parameter is retrieved immediately.
+    void unpack(const child& c, std::size_t index, std::vector<std::size_t>& nodes, std::vector<data::data_expression>& values) const
+    {
+      if (c.position == no_child)
+      {
+        return;
+      }
+      else if (c.is_parameter)
+      {
+        values[c.position] = (*m_values[c.position])[index];
+      }
+      else
+      {
+        nodes[c.position] = index;
+      }
+    }
+
+    std::size_t m_arity;
+    std::vector<std::pair<child, child>> m_nodes; // The children of every node, the last node is the root.
+    std::vector<std::unique_ptr<value_table>> m_values; // The values of every parameter.
+    std::vector<std::unique_ptr<node_table>> m_tables; // The pairs of every node.
+    mutable std::vector<scratch> m_scratch;
+};
+
+} // namespace mcrl2::lps
+
+#endif // MCRL2_LPS_TREE_COMPRESSED_STATE_SET_H
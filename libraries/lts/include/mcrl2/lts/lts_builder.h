@@ -12,6 +12,10 @@
 #ifndef MCRL2_LTS_BUILDER_H
 #define MCRL2_LTS_BUILDER_H
 
+#include <chrono>
+#include <filesystem>
+
+#include "mcrl2/atermpp/standard_containers/vector.h"
 #include "mcrl2/lps/explorer.h"
 #include "mcrl2/lts/detail/lts_convert.h"
 #include "mcrl2/lts/lts_io.h"
@@ -20,6 +24,25 @@ namespace mcrl2 {
 
 namespace lts {
 
+namespace detail {
+
+/// \brief Measures the number of transitions written per second, from its construction onwards.
+class transition_throughput
+{
+  protected:
+    std::chrono::steady_clock::time_point m_start = std::chrono::steady_clock::now();
+
+  public:
+    void report(std::size_t number_of_transitions) const
+    {
+      const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+      mCRL2log(log::verbose) << "Wrote " << number_of_transitions << " transitions in " << seconds << " seconds ("
+                             << static_cast<std::size_t>(seconds > 0 ? number_of_transitions / seconds : 0) << " transitions per second).\n";
+    }
+};
+
+} // namespace detail
+
 /// \brief Removes the last element from state s
 inline
 lps::state remove_time_stamp(const lps::state& s)
@@ -29,7 +52,7 @@ lps::state remove_time_stamp(const lps::state& s)
 
 struct lts_builder
 {
-  typedef atermpp::indexed_set<lps::state, mcrl2::utilities::detail::GlobalThreadSafe> indexed_set_for_states_type;
+  typedef lps::state_store indexed_set_for_states_type;
   // All LTS classes use integers to represent actions in transitions. A mapping from actions to integers
   // is needed to avoid duplicates.
   utilities::unordered_map_large<lps::multi_action, std::size_t> m_actions;
@@ -51,8 +74,8 @@ struct lts_builder
     return i->second;
   }
 
-  // Add a transition to the LTS
-  virtual void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads = 0) = 0;
+  // Add a transition to the LTS. The thread index is that of the explorer, where 0 means a single thread.
+  virtual void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads = 0, const std::size_t thread_index = 0) = 0;
 
   // Add actions and states to the LTS
   virtual void finalize(const indexed_set_for_states_type& state_map, bool timed) = 0;
@@ -60,13 +83,67 @@ struct lts_builder
   // Save the LTS to a file
   virtual void save(const std::string& filename) = 0;
 
+  // Write the state of the builder to a checkpoint, such that generation can be resumed from it
+  virtual void save_checkpoint(atermpp::aterm_ostream& /* stream */)
+  {
+    throw mcrl2::runtime_error("checkpoints are not supported for this output format");
+  }
+
+  // Restore the state of the builder from a checkpoint
+  virtual void load_checkpoint(atermpp::aterm_istream& /* stream */)
+  {
+    throw mcrl2::runtime_error("checkpoints are not supported for this output format");
+  }
+
   virtual ~lts_builder() = default;
+
+protected:
+  void save_actions(atermpp::aterm_ostream& stream) const
+  {
+    stream << atermpp::aterm_int(m_actions.size());
+    for (const auto& p: m_actions)
+    {
+      stream << p.first.actions() << p.first.time() << atermpp::aterm_int(p.second);
+    }
+  }
+
+  void load_actions(atermpp::aterm_istream& stream)
+  {
+    m_actions.clear();
+    atermpp::aterm_int number_of_actions;
+    stream >> number_of_actions;
+    for (std::size_t i = 0; i < number_of_actions.value(); ++i)
+    {
+      process::action_list actions;
+      data::data_expression time;
+      atermpp::aterm_int index;
+      stream >> actions >> time >> index;
+      m_actions.emplace(std::make_pair(lps::multi_action(actions, time), index.value()));
+    }
+  }
+
+  // Truncates the file to the given size, and opens it for writing at its end.
+  template <typename FileStream>
+  static void reopen_at(FileStream& stream, const std::string& filename, std::size_t size, std::ios::openmode mode)
+  {
+    if (stream.is_open())
+    {
+      stream.close();
+    }
+    std::filesystem::resize_file(filename, size);
+    stream.open(filename, mode | std::ios::in | std::ios::out);
+    if (!stream.is_open())
+    {
+      throw mcrl2::runtime_error("cannot open '" + filename + "' for writing");
+    }
+    stream.seekp(size);
+  }
 };
 
 class lts_none_builder: public lts_builder
 {
   public:
-    void add_transition(std::size_t /* from */, const lps::multi_action& /* a */, std::size_t /* to */, const std::size_t /* number_of_threads */) override
+    void add_transition(std::size_t /* from */, const lps::multi_action& /* a */, std::size_t /* to */, const std::size_t /* number_of_threads */, const std::size_t /* thread_index */) override
     {}
 
     void finalize(const indexed_set_for_states_type& /* state_map */, bool /* timed */) override
@@ -74,6 +151,12 @@ class lts_none_builder: public lts_builder
 
     void save(const std::string& /* filename */) override
     {}
+
+    void save_checkpoint(atermpp::aterm_ostream& /* stream */) override
+    {}
+
+    void load_checkpoint(atermpp::aterm_istream& /* stream */) override
+    {}
 };
 
 class lts_aut_builder: public lts_builder
@@ -85,7 +168,7 @@ class lts_aut_builder: public lts_builder
   public:
     lts_aut_builder() = default;
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t /* thread_index */) override
     {
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
       std::size_t label = add_action(a);
@@ -116,14 +199,43 @@ class lts_aut_builder: public lts_builder
 class lts_aut_disk_builder: public lts_builder
 {
   protected:
+    // With several threads every thread prints its transitions in its own buffer, which is written to
+    // the file when it is full. So the file is only locked once per buffer instead of per transition.
+    struct alignas(64) thread_buffer
+    {
+      std::string text;
+      std::size_t transition_count = 0;
+    };
+    static constexpr std::size_t buffer_size = 1 << 16;
+
     std::ofstream out;
+    std::string m_filename;
     std::size_t m_transition_count = 0;
     std::mutex m_exclusive_transition_access;
+    std::vector<thread_buffer> m_buffers;
+    detail::transition_throughput m_throughput;
+
+    void write_buffer(thread_buffer& buffer)
+    {
+      std::lock_guard<std::mutex> guard(m_exclusive_transition_access);
+      out.write(buffer.text.data(), buffer.text.size());
+      m_transition_count += buffer.transition_count;
+      buffer.text.clear();
+      buffer.transition_count = 0;
+    }
 
   public:
-    explicit lts_aut_disk_builder(const std::string& filename)
+    /// \param resume If true, the transitions are appended to the existing file after load_checkpoint is called.
+    /// \param number_of_threads The number of threads of the explorer, which determines the number of buffers.
+    explicit lts_aut_disk_builder(const std::string& filename, bool resume = false, std::size_t number_of_threads = 1)
+      : m_filename(filename),
+        m_buffers(number_of_threads > 1 ? number_of_threads + 1 : 0)
     {
       mCRL2log(log::verbose) << "writing state space in AUT format to '" << filename << "'." << std::endl;
+      if (resume)
+      {
+        return;
+      }
       out.open(filename.c_str());
       if (!out.is_open())
       {
@@ -132,8 +244,20 @@ class lts_aut_disk_builder: public lts_builder
       out << "des                                                \n"; // write a dummy header that will be overwritten
     }
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
     {
+      if (thread_index < m_buffers.size())
+      {
+        thread_buffer& buffer = m_buffers[thread_index];
+        buffer.text += "(" + std::to_string(from) + ",\"" + lps::pp(a) + "\"," + std::to_string(to) + ")\n";
+        buffer.transition_count++;
+        if (buffer.text.size() >= buffer_size)
+        {
+          write_buffer(buffer);
+        }
+        return;
+      }
+
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
       m_transition_count++;
       out << "(" << from << ",\"" << lps::pp(a) << "\"," << to << ")\n";
@@ -143,6 +267,12 @@ class lts_aut_disk_builder: public lts_builder
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool /* timed */) override
     {
+      for (thread_buffer& buffer: m_buffers)
+      {
+        write_buffer(buffer);
+      }
+      m_throughput.report(m_transition_count);
+
       assert(!out.fail());
       out.flush();
       out.seekp(0);
@@ -156,6 +286,22 @@ class lts_aut_disk_builder: public lts_builder
 
     void save(const std::string& /* filename */) override
     { }
+
+    // The transitions written after the checkpoint are removed when resuming, as they will be generated again.
+    void save_checkpoint(atermpp::aterm_ostream& stream) override
+    {
+      out.flush();
+      stream << atermpp::aterm_int(static_cast<std::size_t>(out.tellp())) << atermpp::aterm_int(m_transition_count);
+    }
+
+    void load_checkpoint(atermpp::aterm_istream& stream) override
+    {
+      atermpp::aterm_int offset;
+      atermpp::aterm_int transition_count;
+      stream >> offset >> transition_count;
+      reopen_at(out, m_filename, offset.value(), std::ios::out);
+      m_transition_count = transition_count.value();
+    }
 };
 
 class lts_lts_builder: public lts_builder
@@ -179,7 +325,7 @@ class lts_lts_builder: public lts_builder
       m_lts.set_action_label_declarations(action_labels);
     }
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t /* thread_index */) override
     {
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
       std::size_t label = add_action(a);
@@ -229,47 +375,162 @@ class lts_lts_builder: public lts_builder
 class lts_lts_disk_builder: public lts_builder
 {
   protected:
+    // With several threads every thread collects its transitions in its own buffer, which is written to
+    // the stream when it is full. So the stream is only locked once per buffer instead of per transition.
+    // The actions are kept in an atermpp::vector, which is protected by the thread that constructed the
+    // builder. A standard container would only be protected by the worker thread, which may have ended
+    // when the remaining buffers are written in finalize.
+    struct alignas(64) thread_buffer
+    {
+      std::vector<std::pair<std::size_t, std::size_t>> states;
+      atermpp::vector<lps::multi_action> actions;
+    };
+    static constexpr std::size_t buffer_size = 4096;
+
     std::fstream fstream;
     std::unique_ptr<atermpp::binary_aterm_ostream> stream;
     bool m_discard_state_labels = false;
     std::mutex m_exclusive_transition_access;
+    std::vector<thread_buffer> m_buffers;
+    std::size_t m_transition_count = 0;
+    detail::transition_throughput m_throughput;
+
+    // With checkpoints the transitions are first written to a separate file, because a binary aterm stream cannot
+    // be continued from an arbitrary position. They are copied into the LTS when the state space is finalized.
+    std::string m_filename;
+    std::string m_transitions_filename;
+    std::fstream m_transitions;
+    data::data_specification m_dataspec;
+    process::action_label_list m_action_labels;
+    data::variable_list m_process_parameters;
+
+    void open_output()
+    {
+      bool to_stdout = m_filename.empty() || m_filename == "-";
+      if (!to_stdout)
+      {
+        fstream.open(m_filename, std::ofstream::out | std::ofstream::binary);
+        if (fstream.fail())
+        {
+          throw mcrl2::runtime_error("Fail to open file " + m_filename + " for writing.");
+        }
+
+        mCRL2log(log::verbose) << "writing state space in LTS format to '" << m_filename << "'." << std::endl;
+      }
+      stream = std::make_unique<atermpp::binary_aterm_ostream>(to_stdout ? std::cout : fstream);
+
+      mcrl2::lts::write_lts_header(*stream, m_dataspec, m_process_parameters, m_action_labels);
+    }
+
+    void write_buffer(thread_buffer& buffer)
+    {
+      std::lock_guard<std::mutex> guard(m_exclusive_transition_access);
+      for (std::size_t i = 0; i < buffer.states.size(); ++i)
+      {
+        write_transition(*stream, buffer.states[i].first, buffer.actions[i], buffer.states[i].second);
+      }
+      m_transition_count += buffer.states.size();
+      buffer.states.clear();
+      buffer.actions.clear();
+    }
+
+    // Copies the transitions from the separate file into the LTS.
+    void copy_transitions()
+    {
+      std::vector<lps::multi_action> labels(m_actions.size());
+      for (const auto& p: m_actions)
+      {
+        labels[p.second] = p.first;
+      }
+
+      m_transitions.close();
+      std::ifstream transitions(m_transitions_filename, std::ios::binary);
+      std::size_t record[3];
+      while (transitions.read(reinterpret_cast<char*>(record), sizeof(record)))
+      {
+        write_transition(*stream, record[0], labels[record[1]], record[2]);
+      }
+    }
 
   public:
+    /// \param transitions_filename If not empty, the transitions are written to this file until finalize is called,
+    ///        such that save_checkpoint and load_checkpoint can be used.
+    /// \param resume If true, the transitions are appended to the existing file after load_checkpoint is called.
+    /// \param number_of_threads The number of threads of the explorer, which determines the number of buffers.
     lts_lts_disk_builder(
       const std::string& filename,
       const data::data_specification& dataspec,
       const process::action_label_list& action_labels,
       const data::variable_list& process_parameters,
-      bool discard_state_labels = false
+      bool discard_state_labels = false,
+      const std::string& transitions_filename = "",
+      bool resume = false,
+      std::size_t number_of_threads = 1
     )
-     : m_discard_state_labels(discard_state_labels)
+     : m_discard_state_labels(discard_state_labels),
+       m_buffers(number_of_threads > 1 ? number_of_threads + 1 : 0),
+       m_filename(filename),
+       m_transitions_filename(transitions_filename),
+       m_dataspec(dataspec),
+       m_action_labels(action_labels),
+       m_process_parameters(process_parameters)
     {
-      bool to_stdout = filename.empty() || filename == "-";
-      if (!to_stdout)
+      if (m_transitions_filename.empty())
       {
-        fstream.open(filename, std::ofstream::out | std::ofstream::binary);
-        if (fstream.fail())
+        open_output();
+      }
+      else if (!resume)
+      {
+        m_transitions.open(m_transitions_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_transitions.is_open())
         {
-          throw mcrl2::runtime_error("Fail to open file " + filename + " for writing.");
+          throw mcrl2::runtime_error("cannot open '" + m_transitions_filename + "' for writing");
         }
-
-        mCRL2log(log::verbose) << "writing state space in LTS format to '" << filename << "'." << std::endl;
       }
-      stream = std::make_unique<atermpp::binary_aterm_ostream>(to_stdout ? std::cout : fstream);
-
-      mcrl2::lts::write_lts_header(*stream, dataspec, process_parameters, action_labels);
     }
 
-    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads) override
+    void add_transition(std::size_t from, const lps::multi_action& a, std::size_t to, const std::size_t number_of_threads, const std::size_t thread_index) override
     {
+      if (thread_index < m_buffers.size() && m_transitions_filename.empty())
+      {
+        thread_buffer& buffer = m_buffers[thread_index];
+        buffer.states.emplace_back(from, to);
+        buffer.actions.push_back(a);
+        if (buffer.states.size() >= buffer_size)
+        {
+          write_buffer(buffer);
+        }
+        return;
+      }
+
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
-      write_transition(*stream, from, a, to);
+      m_transition_count++;
+      if (m_transitions_filename.empty())
+      {
+        write_transition(*stream, from, a, to);
+      }
+      else
+      {
+        const std::size_t record[3] = { from, add_action(a), to };
+        m_transitions.write(reinterpret_cast<const char*>(record), sizeof(record));
+      }
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
     }
 
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool timed) override
     {
+      if (!m_transitions_filename.empty())
+      {
+        open_output();
+        copy_transitions();
+      }
+      for (thread_buffer& buffer: m_buffers)
+      {
+        write_buffer(buffer);
+      }
+      m_throughput.report(m_transition_count);
+
       if (!m_discard_state_labels)
       {
         // Write the state labels in the order of their indices.
@@ -294,6 +555,24 @@ class lts_lts_disk_builder: public lts_builder
     }
 
     void save(const std::string&) override {}
+
+    // The transitions written after the checkpoint are removed when resuming, as they will be generated again.
+    void save_checkpoint(atermpp::aterm_ostream& checkpoint) override
+    {
+      assert(!m_transitions_filename.empty());
+      m_transitions.flush();
+      checkpoint << atermpp::aterm_int(static_cast<std::size_t>(m_transitions.tellp()));
+      save_actions(checkpoint);
+    }
+
+    void load_checkpoint(atermpp::aterm_istream& checkpoint) override
+    {
+      assert(!m_transitions_filename.empty());
+      atermpp::aterm_int offset;
+      checkpoint >> offset;
+      reopen_at(m_transitions, m_transitions_filename, offset.value(), std::ios::out | std::ios::binary);
+      load_actions(checkpoint);
+    }
 };
 
 class lts_dot_builder: public lts_lts_builder
@@ -341,7 +620,7 @@ std::unique_ptr<lts_builder> create_lts_builder(const lps::specification& lpsspe
       }
       else
       {
-        return std::make_unique<lts_aut_disk_builder>(output_filename);
+        return std::make_unique<lts_aut_disk_builder>(output_filename, options.resume, options.number_of_threads);
       }
     }
     case lts_dot: return std::make_unique<lts_dot_builder>(lpsspec.data(), lpsspec.action_labels(), lpsspec.process().process_parameters());
@@ -354,7 +633,9 @@ std::unique_ptr<lts_builder> create_lts_builder(const lps::specification& lpsspe
       }
       else
       {
-        return std::make_unique<lts_lts_disk_builder>(output_filename, lpsspec.data(), lpsspec.action_labels(), lpsspec.process().process_parameters(), options.discard_lts_state_labels);
+        const std::string transitions_filename = options.checkpoint_filename.empty() ? "" : options.checkpoint_filename + ".transitions";
+        return std::make_unique<lts_lts_disk_builder>(output_filename, lpsspec.data(), lpsspec.action_labels(), lpsspec.process().process_parameters(),
+                                                      options.discard_lts_state_labels, transitions_filename, options.resume, options.number_of_threads);
       }
     }
     default: return std::make_unique<lts_none_builder>();
@@ -396,8 +396,11 @@ class lts_lts_t : public lts< state_label_lts, action_label_lts, detail::lts_lts
     /** \brief Save the labelled transition system to file.
      *  \details If the filename is empty, the result is read from stdin.
      *  \param[in] filename Name of the file from which this lts is read.
+     *  \param[in] terms_per_section If positive, the file is written in the indexed binary aterm format with
+     *             sections of this number of terms, which can be decoded in parallel. The header is stored in
+     *             its own section. This format cannot be written to stdout.
      */
-    void save(const std::string& filename) const;
+    void save(const std::string& filename, std::size_t terms_per_section = 0) const;
 };
 
 /** \brief This class contains probabilistic labelled transition systems in .lts format.
@@ -424,8 +427,11 @@ class probabilistic_lts_lts_t :
     /** \brief Save the labelled transition system to file.
      *  \details If the filename is empty, the result is read from stdin.
      *  \param[in] filename Name of the file from which this lts is read.
+     *  \param[in] terms_per_section If positive, the file is written in the indexed binary aterm format with
+     *             sections of this number of terms, which can be decoded in parallel. The header is stored in
+     *             its own section. This format cannot be written to stdout.
      */
-    void save(const std::string& filename) const;
+    void save(const std::string& filename, std::size_t terms_per_section = 0) const;
 };
 } // namespace lts
 } // namespace mcrl2
@@ -13,6 +13,7 @@
 #define MCRL2_LTS_STATE_SPACE_GENERATOR_H
 
 #include "mcrl2/lps/explorer.h"
+#include "mcrl2/lts/lts_builder.h"
 #include "mcrl2/lts/trace.h"
 
 namespace mcrl2::lts 
@@ -86,6 +87,112 @@ class trace_constructor
     Explorer& m_explorer;
     std::map<lps::state, lps::state> m_backpointers;
 
+    // For every state index, the index of the state from which it was discovered, or npos for an initial
+    // state. This replaces the back pointers for states that are stored by the explorer, as the states on
+    // a trace can be obtained from the state map.
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> m_parents;
+
+    // With bitstate hashing the discovered states are not stored, and traces are constructed by re-execution
+    // starting in the initial states.
+    bool m_reexecution = false;
+    std::vector<lps::state> m_initial_states;
+
+    // The outgoing transitions of s, where a probabilistic transition is split into one per target state.
+    std::vector<std::pair<lps::multi_action, lps::state>> successors(const lps::state& s)
+    {
+      std::vector<std::pair<lps::multi_action, lps::state>> result;
+      for (const auto& t: m_explorer.generate_transitions(s))
+      {
+        if constexpr (Explorer::is_stochastic)
+        {
+          for (const lps::state& s1: t.second.states)
+          {
+            result.emplace_back(t.first, s1);
+          }
+        }
+        else
+        {
+          result.emplace_back(t.first, t.second);
+        }
+      }
+      return result;
+    }
+
+    // Constructs a trace ending in s by depth first searches from the initial states, with increasing bounds on the
+    // length of the trace, such that a shortest trace is found. Only the current path is stored, and a table with the
+    // smallest depth at which a state was visited, in which a state may be replaced by another one with the same
+    // position, prevents exploring states again at the same or a larger depth.
+    class trace reexecute_trace(const lps::state& s)
+    {
+      struct path_element
+      {
+        lps::state state;
+        std::vector<std::pair<lps::multi_action, lps::state>> successors;
+        std::size_t next;
+      };
+
+      // The path is followed by taking the last chosen transition of each element.
+      const auto make_trace = [](const std::vector<path_element>& path, const lps::state& s1)
+      {
+        class trace tr;
+        for (const path_element& e: path)
+        {
+          tr.set_state(e.state);
+          tr.add_action(e.successors[e.next - 1].first);
+        }
+        tr.set_state(s1);
+        return tr;
+      };
+
+      for (const lps::state& s0: m_initial_states)
+      {
+        if (s0 == s)
+        {
+          class trace tr;
+          tr.set_state(s);
+          return tr;
+        }
+      }
+
+      std::vector<std::pair<lps::state, std::size_t>> depths(1 << 18);
+      for (std::size_t bound = 1; bound <= m_explorer.state_map().size(); ++bound)
+      {
+        std::fill(depths.begin(), depths.end(), std::make_pair(lps::state(), std::numeric_limits<std::size_t>::max()));
+        for (const lps::state& s0: m_initial_states)
+        {
+          std::vector<path_element> path{ path_element{s0, successors(s0), 0} };
+          while (!path.empty())
+          {
+            path_element& top = path.back();
+            if (top.next == top.successors.size())
+            {
+              path.pop_back();
+              continue;
+            }
+            const lps::state s1 = top.successors[top.next++].second;
+            if (s1 == s)
+            {
+              return make_trace(path, s1);
+            }
+
+            const std::size_t depth = path.size();
+            std::pair<lps::state, std::size_t>& visited = depths[std::hash<lps::state>()(s1) % depths.size()];
+            if (visited.first == s1 && visited.second <= depth)
+            {
+              continue;
+            }
+            visited = std::make_pair(s1, depth);
+            if (depth < bound)
+            {
+              path.push_back(path_element{s1, successors(s1), 0});
+            }
+          }
+        }
+      }
+      throw mcrl2::runtime_error("the trace to a state could not be reconstructed");
+    }
+
     // Finds a transition s0 --a--> s1, and returns a.
     lps::multi_action find_action(const lps::state& s0, 
                                   const lps::state& s1)
@@ -116,6 +223,18 @@ class trace_constructor
       throw mcrl2::runtime_error("no transition found in find_action");
     }
 
+    static class trace make_trace(const std::deque<lps::state>& states, const std::deque<lps::multi_action>& actions)
+    {
+      class trace tr;
+      for (std::size_t i = 0; i < actions.size(); i++)
+      {
+        tr.set_state(states[i]);
+        tr.add_action(actions[i]);
+      }
+      tr.set_state(states.back());
+      return tr;
+    }
+
   public:
     explicit trace_constructor(Explorer& explorer_)
       : m_explorer(explorer_)
@@ -124,6 +243,11 @@ class trace_constructor
     // Constructs a trace ending in s, using the backpointers map.
     class trace construct_trace(const lps::state& s)
     {
+      if (m_reexecution)
+      {
+        return reexecute_trace(s);
+      }
+
       std::deque<lps::state> states{ s };
       std::deque<lps::multi_action> actions;
       while (true)
@@ -138,26 +262,71 @@ class trace_constructor
         states.push_front(s0);
         actions.push_front(find_action(s0, s1));
       }
+      return make_trace(states, actions);
+    }
 
-      class trace tr;
-      for (std::size_t i = 0; i < actions.size(); i++)
+    // Constructs a trace ending in s with index s_index, using the parent indices. Only the transitions
+    // of the states on the trace are generated again to find the actions.
+    class trace construct_trace(const lps::state& s, std::size_t s_index)
+    {
+      if (m_reexecution)
       {
-        tr.set_state(states[i]);
-        tr.add_action(actions[i]);
+        return reexecute_trace(s);
       }
-      tr.set_state(states.back());
-      return tr;
+
+      std::deque<lps::state> states{ s };
+      std::deque<lps::multi_action> actions;
+      for (std::size_t i = s_index; i < m_parents.size() && m_parents[i] != npos; i = m_parents[i])
+      {
+        const lps::state s0 = m_explorer.state_map()[m_parents[i]];
+        actions.push_front(find_action(s0, states.front()));
+        states.push_front(s0);
+      }
+      return make_trace(states, actions);
     }
 
     // Adds a back pointer for the given edge
     void add_edge(const lps::state& s0, const lps::state& s1)
     {
-      m_backpointers[s1] = s0;
+      if (!m_reexecution)
+      {
+        m_backpointers[s1] = s0;
+      }
+    }
+
+    // Records that the state with index s1_index was discovered from the state with index s0_index.
+    void add_edge(std::size_t s0_index, std::size_t s1_index)
+    {
+      if (!m_reexecution)
+      {
+        if (s1_index >= m_parents.size())
+        {
+          m_parents.resize(std::max(s1_index + 1, 2 * m_parents.size()), npos);
+        }
+        m_parents[s1_index] = s0_index;
+      }
+    }
+
+    // Constructs traces by re-execution from the initial states from now on, instead of storing back pointers.
+    void enable_reexecution()
+    {
+      m_reexecution = true;
+    }
+
+    // Adds an initial state, which is only needed for re-execution
+    void add_initial_state(const lps::state& s)
+    {
+      if (m_reexecution)
+      {
+        m_initial_states.push_back(s);
+      }
     }
 
     void clear()
     {
       m_backpointers.clear();
+      m_parents.clear();
+      m_initial_states.clear();
     }
 
     // Providing access to the explorer should perhaps be avoided.
@@ -178,6 +347,7 @@ class action_detector
     std::vector<bool> summand_matches;
     std::size_t m_trace_count = 0;
     std::size_t m_max_trace_count;
+    std::size_t m_detection_count = 0;
 
     bool match_action(const lps::action_summand& summand) const
     {
@@ -249,11 +419,12 @@ class action_detector
         return false;
       }
       bool result = false;
+      ++m_detection_count;
 
       mCRL2log(log::info) << "Action '" + lps::pp(a) + "' found (state index: " + std::to_string(s0_index) + ")";
       if (m_trace_count < m_max_trace_count)
       {
-        class trace tr = m_trace_constructor.construct_trace(s0);
+        class trace tr = m_trace_constructor.construct_trace(s0, s0_index);
         tr.add_action(a);
         tr.set_state(s1);
         std::string filename = create_filename(a);
@@ -267,6 +438,12 @@ class action_detector
       }
       return result;
     }
+
+    /// \returns The number of occurrences of the actions that have been found.
+    std::size_t detection_count() const
+    {
+      return m_detection_count;
+    }
 };
 
 template <typename Explorer>
@@ -277,6 +454,7 @@ class deadlock_detector
     const std::string& filename_prefix;
     std::size_t m_trace_count = 0;
     std::size_t m_max_trace_count;
+    std::size_t m_detection_count = 0;
 
   public:
     deadlock_detector(
@@ -291,10 +469,11 @@ class deadlock_detector
 
     void detect_deadlock(const lps::state& s, std::size_t s_index)
     {
+      ++m_detection_count;
       mCRL2log(log::info) << "Deadlock found (state index: " + std::to_string(s_index) + ")";
       if (m_trace_count < m_max_trace_count)
       {
-        class trace tr = m_trace_constructor.construct_trace(s);
+        class trace tr = m_trace_constructor.construct_trace(s, s_index);
         std::string filename = filename_prefix + "_dlk_" + std::to_string(m_trace_count++) + ".trc";
         save_trace(tr, filename);
       }
@@ -304,6 +483,43 @@ class deadlock_detector
       }
       mCRL2log(log::info) << ".\n";
     }
+
+    /// \returns The number of deadlocks that have been found.
+    std::size_t detection_count() const
+    {
+      return m_detection_count;
+    }
+};
+
+// Shared by the explorers of a swarm, such that all of them stop when one of them finds a deadlock or an action,
+// or when the swarm is aborted.
+class swarm_status: public lps::abortable
+{
+  protected:
+    std::atomic<bool> m_aborted = false;
+    std::atomic<bool> m_detected = false;
+
+  public:
+    void abort() override
+    {
+      m_aborted.store(true, std::memory_order_relaxed);
+    }
+
+    bool aborted() const
+    {
+      return m_aborted.load(std::memory_order_relaxed);
+    }
+
+    void detected()
+    {
+      m_detected = true;
+      abort();
+    }
+
+    bool has_detection() const
+    {
+      return m_detected.load();
+    }
 };
 
 template <typename Explorer>
@@ -351,7 +567,7 @@ class nondeterminism_detector
         mCRL2log(log::info) << "Nondeterministic state found (state index: " + std::to_string(s0_index) + ")";
         if (m_trace_count < m_max_trace_count)
         {
-          class trace tr = m_trace_constructor.construct_trace(s0);
+          class trace tr = m_trace_constructor.construct_trace(s0, s0_index);
           tr.add_action(a);
           tr.set_state(s1);
           std::string filename = filename_prefix + "_nondeterministic_" + std::to_string(m_trace_count++) + ".trc";
@@ -473,7 +689,7 @@ class divergence_detector
             mCRL2log(log::info) << "Divergent state found (state index: " + std::to_string(s_index) + ")";
             if (m_trace_count < m_max_trace_count)
             {
-              class trace tr = global_trace_constructor.construct_trace(s);
+              class trace tr = global_trace_constructor.construct_trace(s, s_index);
               class trace tr_loop = m_local_trace_constructor.construct_trace(s0);
               for (const lps::state& u: tr_loop.states())
               {
@@ -509,7 +725,7 @@ class divergence_detector
             mCRL2log(log::info) << "Divergent state found (state index: " + std::to_string(s_index) + ")";
             if (m_trace_count < m_max_trace_count)
             {
-              class trace tr = global_trace_constructor.construct_trace(s);
+              class trace tr = global_trace_constructor.construct_trace(s, s_index);
               class trace tr_loop = m_local_trace_constructor.construct_trace(s0);
               for (const lps::state& u: tr_loop.states())
               {
@@ -623,6 +839,30 @@ class progress_monitor
       }
     }
 
+    // Writes the counters to a checkpoint, such that a resumed exploration reports the same totals.
+    void save_checkpoint(atermpp::aterm_ostream& stream) const
+    {
+      for (std::size_t n: { level, level_up, count.load(), transition_count.load(), last_state_count, last_transition_count })
+      {
+        stream << atermpp::aterm_int(n);
+      }
+    }
+
+    void load_checkpoint(atermpp::aterm_istream& stream)
+    {
+      atermpp::aterm_int n[6];
+      for (atermpp::aterm_int& n_i: n)
+      {
+        stream >> n_i;
+      }
+      level = n[0].value();
+      level_up = n[1].value();
+      count = n[2].value();
+      transition_count = n[3].value();
+      last_state_count = n[4].value();
+      last_transition_count = n[5].value();
+    }
+
     void finish_exploration(std::size_t state_count, std::size_t number_of_threads)
     {
       if (search_strategy == lps::es_breadth)
@@ -644,6 +884,133 @@ class progress_monitor
     }
 };
 
+/// \brief Writes metrics of the exploration to a file as JSON lines, at most once per interval and once at the end.
+/// \details Every line is an object with the elapsed time in seconds, the numbers of states and transitions and their
+///          rates since the previous line, the todo list size of the reporting thread, the load factor of the
+///          discovered states, the number of rewriter calls, the hits and misses of the enumeration caches, the number
+///          and total duration of garbage collections and, per summand index, the number of states for which it was
+///          enumerated, its transitions and its enumeration time. The last line has "final" set to true.
+template <typename Explorer>
+class metrics_monitor
+{
+  protected:
+    struct aligned_counter
+    {
+      alignas(64) std::atomic<std::size_t> value{0};
+    };
+
+    const Explorer& m_explorer;
+    std::ofstream m_out;
+    const std::chrono::steady_clock::duration m_interval;
+    const std::chrono::steady_clock::time_point m_start;
+    std::atomic<std::chrono::steady_clock::rep> m_next; // The time after m_start at which the next line is written.
+    std::vector<aligned_counter> m_transitions;        // The number of transitions per thread.
+
+    // The values written in the previous line, which are protected by the mutex.
+    std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_last_time;
+    std::size_t m_last_states = 0;
+    std::size_t m_last_transitions = 0;
+
+    std::size_t transition_count() const
+    {
+      std::size_t result = 0;
+      for (const aligned_counter& counter: m_transitions)
+      {
+        result += counter.value.load(std::memory_order_relaxed);
+      }
+      return result;
+    }
+
+    static double seconds(std::chrono::steady_clock::duration d)
+    {
+      return std::chrono::duration<double>(d).count();
+    }
+
+    void write(std::chrono::steady_clock::time_point now, std::size_t thread_index, std::size_t todo_list_size, bool final)
+    {
+      const std::size_t states = m_explorer.state_map().size(thread_index);
+      const std::size_t transitions = transition_count();
+      const double elapsed = seconds(now - m_last_time);
+      const lps::explorer_metrics metrics = m_explorer.metrics();
+      const atermpp::detail::aterm_pool& pool = atermpp::detail::g_term_pool();
+      const std::size_t lookups = metrics.cache_hits + metrics.cache_misses;
+
+      m_out << "{\"time\":" << seconds(now - m_start)
+            << ",\"states\":" << states
+            << ",\"transitions\":" << transitions
+            << ",\"states_per_second\":" << (elapsed > 0 ? (states - m_last_states) / elapsed : 0.0)
+            << ",\"transitions_per_second\":" << (elapsed > 0 ? (transitions - m_last_transitions) / elapsed : 0.0)
+            << ",\"todo\":" << todo_list_size
+            << ",\"load_factor\":" << m_explorer.state_map().load_factor(thread_index)
+            << ",\"rewrites\":" << metrics.rewrites
+            << ",\"cache_hits\":" << metrics.cache_hits
+            << ",\"cache_misses\":" << metrics.cache_misses
+            << ",\"cache_hit_rate\":" << (lookups > 0 ? static_cast<double>(metrics.cache_hits) / lookups : 0.0)
+            << ",\"gc_collections\":" << pool.number_of_collections()
+            << ",\"gc_time\":" << std::chrono::duration<double>(pool.collection_time()).count()
+            << ",\"summands\":[";
+      for (std::size_t i = 0; i < metrics.summands.size(); ++i)
+      {
+        const lps::explorer_summand_metrics& summand = metrics.summands[i];
+        m_out << (i == 0 ? "" : ",") << "{\"visits\":" << summand.visits << ",\"transitions\":" << summand.transitions
+              << ",\"time\":" << std::chrono::duration<double>(summand.time).count() << "}";
+      }
+      m_out << "],\"final\":" << std::boolalpha << final << "}" << std::endl;
+
+      m_last_time = now;
+      m_last_states = states;
+      m_last_transitions = transitions;
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param interval The number of seconds between two lines.
+    metrics_monitor(const Explorer& explorer, const std::string& filename, std::size_t interval, std::size_t number_of_threads)
+      : m_explorer(explorer),
+        m_out(filename),
+        m_interval(std::chrono::seconds(interval)),
+        m_start(std::chrono::steady_clock::now()),
+        m_next(m_interval.count()),
+        m_transitions(number_of_threads + 1), // Threads are numbered from 1 when there are several.
+        m_last_time(m_start)
+    {
+      if (!m_out)
+      {
+        throw mcrl2::runtime_error("Could not open " + filename + " to write the metrics of the exploration.");
+      }
+    }
+
+    /// \details threadsafe
+    void examine_transition(std::size_t thread_index)
+    {
+      lps::detail::add_relaxed(m_transitions[thread_index].value, std::size_t(1));
+    }
+
+    /// \brief Writes a line if the interval has passed since the previous line.
+    /// \details threadsafe, and a thread that finds another thread writing does not wait for it.
+    void finish_state(std::size_t thread_index, std::size_t todo_list_size)
+    {
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if ((now - m_start).count() >= m_next.load(std::memory_order_relaxed))
+      {
+        std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+        if (lock.owns_lock() && (now - m_start).count() >= m_next.load(std::memory_order_relaxed))
+        {
+          m_next.store((now - m_start + m_interval).count(), std::memory_order_relaxed);
+          write(now, thread_index, todo_list_size, false);
+        }
+      }
+    }
+
+    /// \brief Writes the final line.
+    void finish_exploration()
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      write(std::chrono::steady_clock::now(), 0, 0, true);
+    }
+};
+
 } // namespace detail
 
 template <bool Stochastic, bool Timed, typename Specification>
@@ -661,6 +1028,10 @@ struct state_space_generator
   detail::nondeterminism_detector<explorer_type> m_nondeterminism_detector;
   std::unique_ptr<detail::divergence_detector<explorer_type>> m_divergence_detector;
   detail::progress_monitor m_progress_monitor;
+  std::unique_ptr<detail::metrics_monitor<explorer_type>> m_metrics_monitor;
+
+  // If set, the exploration stops when the swarm is aborted, and the swarm is aborted when a deadlock or an action is found.
+  detail::swarm_status* m_swarm = nullptr;
 
   state_space_generator(const Specification& lpsspec, const lps::explorer_options& options_)
     : options(options_),
@@ -671,6 +1042,10 @@ struct state_space_generator
       m_nondeterminism_detector(m_trace_constructor, options.trace_prefix, options.number_of_threads, options.max_traces),
       m_progress_monitor(options.search_strategy)
   {
+    if (options.bitstate_memory > 0)
+    {
+      m_trace_constructor.enable_reexecution();
+    }
     if (options.detect_divergence)
     {
       m_divergence_detector = 
@@ -680,6 +1055,11 @@ struct state_space_generator
                                                                        options.trace_prefix, 
                                                                        options.max_traces));
     }
+    if (!options.metrics_filename.empty())
+    {
+      m_metrics_monitor = std::make_unique<detail::metrics_monitor<explorer_type>>(explorer, options.metrics_filename,
+                                                                                 options.metrics_interval, options.number_of_threads);
+    }
   }
 
   bool max_states_exceeded(const std::size_t thread_index)
@@ -698,6 +1078,18 @@ struct state_space_generator
   {
     std::vector<aligned_bool> has_outgoing_transitions(options.number_of_threads+1); // thread indices start at 1. 
     const lps::state* source = nullptr;
+    std::size_t source_index = 0;
+
+    if constexpr (!Stochastic)
+    {
+      if (!options.checkpoint_filename.empty())
+      {
+        explorer.set_checkpoint_functions(
+          [&](atermpp::aterm_ostream& stream) { m_progress_monitor.save_checkpoint(stream); builder.save_checkpoint(stream); },
+          [&](atermpp::aterm_istream& stream) { m_progress_monitor.load_checkpoint(stream); builder.load_checkpoint(stream); }
+        );
+      }
+    }
 
     try
     {
@@ -707,9 +1099,17 @@ struct state_space_generator
         // discover_state
         [&](const std::size_t thread_index, const lps::state& s, std::size_t s_index)
         {
+          if (m_swarm != nullptr && m_swarm->aborted())
+          {
+            static_cast<lps::abortable&>(explorer).abort();
+          }
           if (options.generate_traces && source)
           {
-            m_trace_constructor.add_edge(*source, s);
+            m_trace_constructor.add_edge(source_index, s_index);
+          }
+          else if (options.generate_traces)
+          {
+            m_trace_constructor.add_initial_state(s);
           }
           if (options.detect_divergence)
           {
@@ -746,13 +1146,17 @@ struct state_space_generator
           }
           else
           {
-            builder.add_transition(s0_index, a, s1_index, number_of_threads);
+            builder.add_transition(s0_index, a, s1_index, number_of_threads, thread_index);
           }
           assert(thread_index<has_outgoing_transitions.size());
           has_outgoing_transitions[thread_index].m_bool = true;
           if (options.detect_action)
           {
             m_action_detector.detect_action(s0, s0_index, a, first_state(s1), summand_index);
+            if (m_swarm != nullptr && m_action_detector.detection_count() > 0)
+            {
+              m_swarm->detected();
+            }
           }
           if (options.detect_nondeterminism)
           {
@@ -762,13 +1166,18 @@ struct state_space_generator
           {
             m_progress_monitor.examine_transition();
           }
+          if (m_metrics_monitor)
+          {
+            m_metrics_monitor->examine_transition(thread_index);
+          }
         },
 
         // start_state
-        [&](const std::size_t thread_index, const lps::state& s, std::size_t /* s_index */)
+        [&](const std::size_t thread_index, const lps::state& s, std::size_t s_index)
         {
           if (options.number_of_threads == 1) {
             source = &s;
+            source_index = s_index;
           }
 
           assert(thread_index<has_outgoing_transitions.size());
@@ -787,11 +1196,19 @@ struct state_space_generator
           if (options.detect_deadlock && !has_outgoing_transitions[thread_index].m_bool)
           {
             m_deadlock_detector.detect_deadlock(s, s_index);
+            if (m_swarm != nullptr)
+            {
+              m_swarm->detected();
+            }
           }
           if (!options.suppress_progress_messages)
           {
             m_progress_monitor.finish_state(explorer.state_map().size(thread_index), todo_list_size, number_of_threads);
           }
+          if (m_metrics_monitor)
+          {
+            m_metrics_monitor->finish_state(thread_index, todo_list_size);
+          }
         },
 
         // discover_initial_state
@@ -804,6 +1221,66 @@ struct state_space_generator
         }
       );
       m_progress_monitor.finish_exploration(explorer.state_map().size(), options.number_of_threads);
+      if (m_metrics_monitor)
+      {
+        m_metrics_monitor->finish_exploration();
+      }
+      if (options.number_of_threads > 1)
+      {
+        const std::vector<lps::work_stealing_statistics>& work = explorer.work_statistics();
+        for (std::size_t i = 0; i < work.size(); ++i)
+        {
+          mCRL2log(log::verbose) << "Thread " << i + 1 << " explored " << work[i].explored << " states, of which it stole "
+                                 << work[i].stolen << " from other threads in " << work[i].steals << " steals.\n";
+        }
+      }
+      if (options.cached)
+      {
+        mCRL2log(log::verbose) << "Enumeration caches: " << explorer.cache_statistics() << ".\n";
+      }
+      if (const lps::stubborn_sets* por = explorer.partial_order_reduction())
+      {
+        const std::size_t N = por->size();
+        const auto [reduced, proviso] = explorer.partial_order_reduction_statistics();
+        mCRL2log(log::verbose) << "Partial-order reduction: " << por->independent_pairs() << " of the " << N * (N - 1) / 2
+                               << " pairs of summands are independent and " << por->accordant_pairs() << " accord. Only a stubborn set was explored in "
+                               << reduced << " states, and " << proviso << " states were fully explored due to the cycle proviso.\n";
+      }
+      if (explorer.state_map().sharding())
+      {
+        const lps::sharded_state_set& states = explorer.state_map().sharded_states();
+        const lps::sharded_state_set_statistics statistics = states.statistics();
+        mCRL2log(log::verbose) << "The states were stored in " << states.number_of_shards() << " shards with "
+                               << statistics.local_inserts << " local and " << statistics.remote_inserts << " remote insertions.\n";
+      }
+      if (explorer.state_map().bitstate_hashing())
+      {
+        const lps::bitstate_state_set& states = explorer.state_map().bitstate_states();
+        if (states.hash_compaction())
+        {
+          mCRL2log(log::verbose) << "Hash compaction stored fingerprints of " << states.size() << " states in " << states.memory() << " bytes";
+        }
+        else
+        {
+          mCRL2log(log::verbose) << "Bitstate hashing stored " << states.size() << " states in " << states.memory() * 8 << " bits using "
+                                 << states.number_of_hashes() << " hash functions";
+        }
+        mCRL2log(log::verbose) << ", the estimated coverage of the state space is " << std::setprecision(6) << 100.0 * states.coverage() << "%.\n";
+      }
+      if (explorer.state_map().external_storage())
+      {
+        const lps::external_state_set& states = explorer.state_map().external_states();
+        mCRL2log(log::verbose) << "The states were stored on disk, and compared to the new states in " << states.number_of_merges()
+                               << " passes that read " << states.states_read() << " states in total.\n";
+      }
+      if (explorer.state_map().tree_compression())
+      {
+        const lps::tree_compressed_state_set& states = explorer.state_map().tree_compressed_states();
+        mCRL2log(log::verbose) << "Tree compression stored " << states.size() << " states of " << states.arity() << " parameters using "
+                               << states.number_of_nodes() << " pairs of indices ("
+                               << static_cast<double>(states.number_of_nodes()) / std::max<std::size_t>(states.size(), 1) << " per state) and "
+                               << states.number_of_values() << " distinct parameter values.\n";
+      }
       builder.finalize(explorer.state_map(), Timed);
     }
     catch (const data::enumerator_error& e)
@@ -812,7 +1289,7 @@ struct state_space_generator
       if (options.save_error_trace)
       {
         const lps::state& s = *source;
-        class trace tr = m_trace_constructor.construct_trace(s);
+        class trace tr = m_trace_constructor.construct_trace(s, source_index);
         std::string filename = options.trace_prefix + "_error.trc";
         detail::save_trace(tr, filename);
       }
@@ -821,6 +1298,126 @@ struct state_space_generator
 
     return true;
   }
+
+  /// \returns The number of deadlocks and actions that have been found.
+  std::size_t detection_count() const
+  {
+    return m_deadlock_detector.detection_count() + m_action_detector.detection_count();
+  }
+};
+
+/// \brief Swarm verification, in which a number of independent explorers race to find a deadlock or an action.
+/// \details Every member of the swarm explores the state space using bitstate hashing with its share of the memory,
+///          a random order of the summands and a random hash function, and alternately depth-first search and
+///          highway search with different bounds on the todo list. As the members omit different states and reach
+///          them in a different order, the swarm covers more of a state space that is too large for a complete
+///          exploration than a single explorer. The members run in parallel when the toolset is built with thread
+///          support, and all of them stop as soon as one of them finds a deadlock or an action.
+template <bool Timed, typename Specification>
+class state_space_swarm: public lps::abortable
+{
+  protected:
+    const Specification& m_lpsspec;
+    const lps::explorer_options& m_options;
+    std::size_t m_size;
+    detail::swarm_status m_status;
+    std::mutex m_construction_mutex; // The construction of rewriters is not thread safe.
+
+    lps::explorer_options member_options(std::size_t i) const
+    {
+      lps::explorer_options result = m_options;
+      result.number_of_threads = 1;
+      result.random_seed = m_options.random_seed * m_size + i + 1;
+      result.bitstate_memory = std::max<std::size_t>(m_options.bitstate_memory / m_size, 1024);
+      if (i % 2 == 0)
+      {
+        result.search_strategy = lps::es_depth;
+      }
+      else
+      {
+        result.search_strategy = lps::es_highway;
+        result.highway_todo_max = std::size_t(1000) << (i / 2 % 10);
+      }
+      result.trace_prefix = m_options.trace_prefix + "_swarm" + std::to_string(i);
+      result.metrics_filename.clear(); // The members would write to the same file.
+      return result;
+    }
+
+    void explore_member(std::size_t i)
+    {
+      const lps::explorer_options options = member_options(i);
+      std::unique_lock<std::mutex> lock(m_construction_mutex);
+      state_space_generator<false, Timed, Specification> generator(m_lpsspec, options);
+      lock.unlock();
+      generator.m_swarm = &m_status;
+      lts_none_builder builder;
+      generator.explore(builder);
+      mCRL2log(log::verbose) << "Member " << i << " of the swarm (" << options.search_strategy << " search with seed " << options.random_seed
+                             << ") explored " << generator.explorer.state_map().size() << " states and found " << generator.detection_count()
+                             << " deadlocks and actions.\n";
+    }
+
+  public:
+    /// \brief Constructor.
+    /// \param size The number of members of the swarm.
+    state_space_swarm(const Specification& lpsspec, const lps::explorer_options& options, std::size_t size)
+      : m_lpsspec(lpsspec),
+        m_options(options),
+        m_size(size)
+    {
+      assert(size > 0 && options.bitstate_memory > 0);
+    }
+
+    void abort() override
+    {
+      m_status.abort();
+    }
+
+    /// \brief Explores the state space with all members of the swarm.
+    /// \returns True iff a deadlock or an action was found.
+    bool explore()
+    {
+      if constexpr (mcrl2::utilities::detail::GlobalThreadSafe)
+      {
+        // Every member is explored by its own thread, in which all its terms are created and destroyed.
+        std::vector<std::thread> threads;
+        std::vector<std::exception_ptr> errors(m_size);
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+          threads.emplace_back([&, i]()
+          {
+            try
+            {
+              explore_member(i);
+            }
+            catch (...)
+            {
+              errors[i] = std::current_exception();
+              m_status.abort();
+            }
+          });
+        }
+        for (std::thread& thread: threads)
+        {
+          thread.join();
+        }
+        for (const std::exception_ptr& error: errors)
+        {
+          if (error)
+          {
+            std::rethrow_exception(error);
+          }
+        }
+      }
+      else
+      {
+        for (std::size_t i = 0; i < m_size && !m_status.aborted(); ++i)
+        {
+          explore_member(i);
+        }
+      }
+      return m_status.has_detection();
+    }
 };
 
 } // namespace mcrl2::lts
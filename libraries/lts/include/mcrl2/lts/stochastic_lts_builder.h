@@ -12,6 +12,7 @@
 #ifndef MCRL2_LTS_STOCHASTIC_LTS_BUILDER_H
 #define MCRL2_LTS_STOCHASTIC_LTS_BUILDER_H
 
+#include "mcrl2/atermpp/standard_containers/deque.h"
 #include "mcrl2/lts/lts_builder.h"
 
 namespace mcrl2 {
@@ -20,7 +21,7 @@ namespace lts {
 
 struct stochastic_lts_builder
 {
-  typedef atermpp::indexed_set<lps::state, mcrl2::utilities::detail::GlobalThreadSafe> indexed_set_for_states_type;
+  typedef lps::state_store indexed_set_for_states_type;
   // All LTS classes use integers to represent actions in transitions. A mapping from actions to integers
   // is needed to avoid duplicates.
   utilities::unordered_map_large<lps::multi_action, std::size_t> m_actions;
@@ -72,21 +73,21 @@ class stochastic_lts_none_builder: public stochastic_lts_builder
     {}
 };
 
+// A term in a standard container is only protected by the thread that created it. With several threads
+// transitions are added by different threads, so the probabilities are kept in a term container instead.
 class stochastic_lts_aut_builder: public stochastic_lts_builder
 {
   protected:
     struct stochastic_state
     {
       std::list<std::size_t> targets;
-      std::vector<data::data_expression> probabilities;
+      std::size_t probabilities; // The index of the probabilities in m_probabilities.
 
-      stochastic_state() = default;
-
-      stochastic_state(std::list<std::size_t>  targets_, std::vector<data::data_expression>  probabilities_)
-        : targets(std::move(targets_)), probabilities(std::move(probabilities_))
+      stochastic_state(std::list<std::size_t> targets_, std::size_t probabilities_)
+        : targets(std::move(targets_)), probabilities(probabilities_)
       {}
 
-      void save_to_aut(std::ostream& out) const
+      void save_to_aut(std::ostream& out, const data::data_expression_list& probabilities) const
       {
         auto j = targets.begin();
         out << *j++;
@@ -117,26 +118,39 @@ class stochastic_lts_aut_builder: public stochastic_lts_builder
     };
 
     std::vector<stochastic_state> m_stochastic_states;
+    atermpp::deque<data::data_expression_list> m_probabilities;
     std::vector<transition> m_transitions;
     std::size_t m_number_of_states = 0;
     std::mutex m_exclusive_transition_access;
 
+    void add_stochastic_state(const std::list<std::size_t>& targets, const data::data_expression_list& probabilities)
+    {
+      m_stochastic_states.emplace_back(targets, m_probabilities.size());
+      m_probabilities.push_back(probabilities);
+    }
+
+    void save_to_aut(std::ostream& out, const stochastic_state& s) const
+    {
+      s.save_to_aut(out, m_probabilities[s.probabilities]);
+    }
+
   public:
     stochastic_lts_aut_builder() = default;
 
     // Set the initial (stochastic) state of the LTS
     void set_initial_state(const std::list<std::size_t>& targets, const std::vector<data::data_expression>& probabilities) override
     {
-      m_stochastic_states.emplace_back(targets, probabilities);
+      add_stochastic_state(targets, data::data_expression_list(probabilities.begin(), probabilities.end()));
     }
 
     // Add a transition to the LTS
     void add_transition(std::size_t from, const lps::multi_action& a, const std::list<std::size_t>& targets, const std::vector<data::data_expression>& probabilities, const std::size_t number_of_threads) override
     {
+      const data::data_expression_list probabilities_(probabilities.begin(), probabilities.end());
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
       std::size_t to = m_stochastic_states.size();
       std::size_t label = add_action(a);
-      m_stochastic_states.emplace_back(targets, probabilities);
+      add_stochastic_state(targets, probabilities_);
       m_transitions.emplace_back(from, label, to);
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
     }
@@ -156,13 +170,13 @@ class stochastic_lts_aut_builder: public stochastic_lts_builder
       }
 
       out << "des (";
-      m_stochastic_states[0].save_to_aut(out);
+      save_to_aut(out, m_stochastic_states[0]);
       out << "," << m_transitions.size() << "," << m_number_of_states << ")" << "\n";
 
       for (const transition& t: m_transitions)
       {
         out << "(" << t.from << ",\"" << lps::pp(actions[t.label]) << "\",";
-        m_stochastic_states[t.to].save_to_aut(out);
+        save_to_aut(out, m_stochastic_states[t.to]);
         out << ")" << "\n";
       }
     }
@@ -187,12 +201,16 @@ class stochastic_lts_aut_builder: public stochastic_lts_builder
     }
 };
 
+// The probabilistic states are constructed in finalize, as their probabilities can only be stored in a term
+// container while transitions are added by several threads. See also stochastic_lts_aut_builder.
 class stochastic_lts_lts_builder: public stochastic_lts_builder
 {
   protected:
     probabilistic_lts_lts_t m_lts;
     bool m_discard_state_labels = false;
     probabilistic_state<std::size_t, lps::probabilistic_data_expression> m_initial_state;
+    std::vector<std::list<std::size_t>> m_targets;
+    atermpp::deque<data::data_expression_list> m_probabilities;
     std::mutex m_exclusive_transition_access;
 
   public:
@@ -210,7 +228,7 @@ class stochastic_lts_lts_builder: public stochastic_lts_builder
     }
 
     static probabilistic_state<std::size_t, lps::probabilistic_data_expression> 
-             make_probabilistic_state(const std::list<std::size_t>& targets, const std::vector<data::data_expression>& probabilities)
+             make_probabilistic_state(const std::list<std::size_t>& targets, const data::data_expression_list& probabilities)
     {
       probabilistic_state<std::size_t, lps::probabilistic_data_expression> result;
       assert(targets.size()>0);
@@ -221,7 +239,7 @@ class stochastic_lts_lts_builder: public stochastic_lts_builder
       else 
       {
         std::list<std::size_t>::const_iterator ti = targets.begin();
-        std::vector<data::data_expression>::const_iterator pi = probabilities.begin();
+        data::data_expression_list::const_iterator pi = probabilities.begin();
         for (; ti != targets.end(); ++pi, ++ti)
         {
           result.add(*ti, lps::probabilistic_data_expression(*pi));
@@ -233,24 +251,33 @@ class stochastic_lts_lts_builder: public stochastic_lts_builder
     // Set the initial (stochastic) state of the LTS
     void set_initial_state(const std::list<std::size_t>& targets, const std::vector<data::data_expression>& probabilities) override
     {
-      m_initial_state = make_probabilistic_state(targets, probabilities);
+      m_initial_state = make_probabilistic_state(targets, data::data_expression_list(probabilities.begin(), probabilities.end()));
     }
 
     // Add a transition to the LTS
     void add_transition(std::size_t from, const lps::multi_action& a, const std::list<std::size_t>& targets, const std::vector<data::data_expression>& probabilities, const std::size_t number_of_threads) override
     {
+      const data::data_expression_list probabilities_(probabilities.begin(), probabilities.end());
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.lock();
-      auto s1 = make_probabilistic_state(targets, probabilities);
       std::size_t label = add_action(a);
-      std::size_t to = m_lts.add_probabilistic_state(s1);
+      std::size_t to = m_targets.size();
+      m_targets.push_back(targets);
+      m_probabilities.push_back(probabilities_);
       m_lts.add_transition(transition(from, label, to));
       if (mcrl2::utilities::detail::GlobalThreadSafe && number_of_threads>1) m_exclusive_transition_access.unlock();
-
     }
 
     // Add actions and states to the LTS
     void finalize(const indexed_set_for_states_type& state_map, bool timed) override
     {
+      // add the probabilistic target states of the transitions
+      for (std::size_t i = 0; i < m_targets.size(); ++i)
+      {
+        m_lts.add_probabilistic_state(make_probabilistic_state(m_targets[i], m_probabilities[i]));
+      }
+      m_targets.clear();
+      m_probabilities.clear();
+
       // add actions
       m_lts.set_num_action_labels(m_actions.size());
       for (const auto& p: m_actions)
@@ -321,8 +321,18 @@ static void read_from_lts(LTS_TRANSITION_SYSTEM& lts, const std::string& filenam
 
   try
   {
-    atermpp::binary_aterm_istream stream(filename.empty() ? std::cin : fstream);
-    stream >> lts;
+    if (!filename.empty() && atermpp::is_indexed_binary_aterm_file(filename))
+    {
+      // Files in the indexed format are mapped into memory and their sections are decoded in parallel.
+      atermpp::indexed_binary_aterm_istream stream(filename);
+      stream.set_decoding_threads(0);
+      stream >> lts;
+    }
+    else
+    {
+      atermpp::binary_aterm_istream stream(filename.empty() ? std::cin : fstream);
+      stream >> lts;
+    }
   }
   catch (const std::exception& ex)
   {
@@ -350,19 +360,10 @@ void write_initial_state(atermpp::aterm_ostream& stream, const lts_lts_t& lts)
   stream << probabilistic_lts_lts_t::probabilistic_state_t(lts.initial_state());
 }
 
+// Writes the transitions, the state labels and the initial state, which follow the header.
 template <class LTS>
-static void write_lts(atermpp::aterm_ostream& stream, const LTS& lts)
+static void write_lts_contents(atermpp::aterm_ostream& stream, const LTS& lts)
 {
-  static_assert(std::is_same<LTS,probabilistic_lts_lts_t>::value ||
-                std::is_same<LTS,lts_lts_t>::value,
-                "Function write_lts can only be applied to a (probabilistic) lts. ");
-
-  // Write the process related information.
-  write_lts_header(stream,
-   lts.data(),
-   lts.process_parameters(),
-   lts.action_label_declarations());
-
   for (const transition& trans : lts.get_transitions())
   {
     lts_lts_t::action_label_t label = lts.action_label(lts.apply_hidden_label_map(trans.label()));
@@ -390,8 +391,23 @@ static void write_lts(atermpp::aterm_ostream& stream, const LTS& lts)
   write_initial_state(stream, lts);
 }
 
+template <class LTS>
+static void write_lts(atermpp::aterm_ostream& stream, const LTS& lts)
+{
+  static_assert(std::is_same<LTS,probabilistic_lts_lts_t>::value ||
+                std::is_same<LTS,lts_lts_t>::value,
+                "Function write_lts can only be applied to a (probabilistic) lts. ");
+
+  // Write the process related information.
+  write_lts_header(stream,
+   lts.data(),
+   lts.process_parameters(),
+   lts.action_label_declarations());
+  write_lts_contents(stream, lts);
+}
+
 template <class LTS_TRANSITION_SYSTEM>
-static void write_to_lts(const LTS_TRANSITION_SYSTEM& lts, const std::string& filename)
+static void write_to_lts(const LTS_TRANSITION_SYSTEM& lts, const std::string& filename, std::size_t terms_per_section)
 {
   static_assert(std::is_same<LTS_TRANSITION_SYSTEM,probabilistic_lts_lts_t>::value ||
                 std::is_same<LTS_TRANSITION_SYSTEM,lts_lts_t>::value,
@@ -408,10 +424,26 @@ static void write_to_lts(const LTS_TRANSITION_SYSTEM& lts, const std::string& fi
     }
   }
 
+  if (terms_per_section > 0 && to_stdout)
+  {
+    throw mcrl2::runtime_error("An lts in the indexed format cannot be written to standard output.");
+  }
+
   try
   {
-    atermpp::binary_aterm_ostream stream(to_stdout ? std::cout : fstream);
-    stream << lts;
+    if (terms_per_section > 0)
+    {
+      // The header gets its own section, such that it can be read without decoding any transition.
+      atermpp::indexed_binary_aterm_ostream stream(fstream, terms_per_section);
+      write_lts_header(stream, lts.data(), lts.process_parameters(), lts.action_label_declarations());
+      stream.start_section();
+      write_lts_contents(stream, lts);
+    }
+    else
+    {
+      atermpp::binary_aterm_ostream stream(to_stdout ? std::cout : fstream);
+      stream << lts;
+    }
   }
   catch (const std::exception& ex)
   {
@@ -499,16 +531,16 @@ void write_initial_state(atermpp::aterm_ostream& stream, std::size_t index)
   stream << probabilistic_lts_lts_t::probabilistic_state_t(index);
 }
 
-void probabilistic_lts_lts_t::save(const std::string& filename) const
+void probabilistic_lts_lts_t::save(const std::string& filename, std::size_t terms_per_section) const
 {
   mCRL2log(log::verbose) << "Starting to save a probabilistic lts to the file " << filename << ".\n";
-  detail::write_to_lts(*this, filename);
+  detail::write_to_lts(*this, filename, terms_per_section);
 }
 
-void lts_lts_t::save(std::string const& filename) const
+void lts_lts_t::save(std::string const& filename, std::size_t terms_per_section) const
 {
   mCRL2log(log::verbose) << "Starting to save an lts to the file " << filename << ".\n";
-  detail::write_to_lts(*this, filename);
+  detail::write_to_lts(*this, filename, terms_per_section);
 }
 
 void probabilistic_lts_lts_t::load(const std::string& filename)
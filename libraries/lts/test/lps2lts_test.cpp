@@ -18,6 +18,7 @@
 
 #include "mcrl2/data/detail/rewrite_strategies.h"
 #include "mcrl2/lps/is_stochastic.h"
+#include "mcrl2/lts/lts_algorithm.h"
 #include "mcrl2/lts/state_space_generator.h"
 #include "mcrl2/lts/stochastic_lts_builder.h"
 #include "mcrl2/utilities/test_utilities.h"
@@ -51,7 +52,9 @@ void run_generatelts(
   lps::exploration_strategy estrategy,
   lts::lts_type output_format,
   const std::string& outputfile,
-  const std::string& priority_action
+  const std::string& priority_action,
+  bool tree_compression,
+  std::size_t number_of_shards
 )
 {
   lps::explorer_options options;
@@ -60,6 +63,8 @@ void run_generatelts(
   options.rewrite_strategy = rstrategy;
   options.search_strategy = estrategy;
   options.save_at_end = true;
+  options.tree_compression = tree_compression;
+  options.number_of_shards = number_of_shards;
 
   bool is_timed = stochastic_lpsspec.process().has_time();
 
@@ -99,15 +104,17 @@ void check_lts(
   std::size_t expected_states,
   std::size_t expected_transitions,
   std::size_t expected_labels,
-  const std::string& priority_action = ""
+  const std::string& priority_action = "",
+  bool tree_compression = false,
+  std::size_t number_of_shards = 0
 )
 {
-  std::cerr << "Translating LPS to LTS with exploration strategy " << estrategy << ", rewrite strategy " << rstrategy << "." << std::endl;
+  std::cerr << "Translating LPS to LTS with exploration strategy " << estrategy << ", rewrite strategy " << rstrategy << (tree_compression ? ", tree compression" : "") << (number_of_shards > 0 ? ", shards" : "") << "." << std::endl;
   std::cerr << format << " FORMAT\n";
   LTSType result;
   lts::lts_type output_format = result.type();
   std::string outputfile = static_cast<std::string>(boost::unit_test::framework::current_test_case().p_name) + ".generatelts" + file_extension(output_format);
-  run_generatelts(stochastic_lpsspec, rstrategy, estrategy, output_format, outputfile, priority_action);
+  run_generatelts(stochastic_lpsspec, rstrategy, estrategy, output_format, outputfile, priority_action, tree_compression, number_of_shards);
   result.load(outputfile);
 
   BOOST_CHECK_EQUAL(result.num_states(), expected_states);
@@ -137,14 +144,19 @@ static void check_lps2lts_specification(const std::string& specification,
         check_lts<lts::probabilistic_lts_aut_t>("PROBABILISTIC AUT", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action);
         check_lts<lts::probabilistic_lts_lts_t>("PROBABILISTIC LTS", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action);
         check_lts<lts::probabilistic_lts_fsm_t>("PROBABILISTIC FSM", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action);
+        check_lts<lts::probabilistic_lts_lts_t>("PROBABILISTIC LTS", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action, true);
+        check_lts<lts::probabilistic_lts_lts_t>("PROBABILISTIC LTS", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action, false, 2);
       }
       else
       {
         check_lts<lts::lts_aut_t>("AUT", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action);
         check_lts<lts::lts_lts_t>("LTS", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action);
         check_lts<lts::lts_fsm_t>("FSM", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action);
+        check_lts<lts::lts_lts_t>("LTS", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action, true);
+        check_lts<lts::lts_lts_t>("LTS", lpsspec, rstrategy, estrategy, expected_states, expected_transitions, expected_labels, priority_action, false, 2);
       }
     }
+
   }
 }
 
@@ -658,3 +670,394 @@ BOOST_AUTO_TEST_CASE(test_whether_action_a_b_and_b_a_are_the_same)   // Related
 }
 
 
+
+BOOST_AUTO_TEST_CASE(test_bitstate_hashing)
+{
+  std::string spec(
+    "act a, b;\n"
+    "proc P(n: Nat) = (n < 50) -> a.P(n + 1)\n"
+    "               + (n == 50) -> b.P(n + 1);\n"
+    "init P(0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  for (bool hash_compaction: { false, true })
+  {
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+    options.detect_deadlock = true;
+    options.bitstate_memory = 1024;
+    options.hash_compaction = hash_compaction;
+
+    lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+    lts::lts_none_builder builder;
+    BOOST_CHECK(generator.explore(builder));
+    BOOST_CHECK_EQUAL(generator.explorer.state_map().size(), 52u);
+    BOOST_CHECK(generator.explorer.state_map().bitstate_states().coverage() > 0.9);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_partial_order_reduction)
+{
+  std::string spec(
+    "act i, j, k, done;\n"
+    "proc P(a, b, c: Nat) = (a < 5) -> i . P(a = a + 1)\n"
+    "                     + (b < 5) -> j . P(b = b + 1)\n"
+    "                     + (c < 5) -> k . P(c = c + 1)\n"
+    "                     + (a == 5 && b == 5 && c == 5) -> done . P(0, 0, 6);\n"
+    "init P(0, 0, 0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  auto number_of_states = [&](lps::partial_order_reduction_mode mode)
+  {
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+    options.partial_order_reduction = mode;
+    options.trace_actions.insert(core::identifier_string("done"));
+
+    lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+    lts::lts_none_builder builder;
+    BOOST_CHECK(generator.explore(builder));
+    return generator.explorer.state_map().size();
+  };
+
+  // The interleavings of the three independent summands are reduced to a single one, while the state
+  // in which done is enabled and the deadlock after it are preserved.
+  BOOST_CHECK_EQUAL(number_of_states(lps::partial_order_reduction_mode::none), 252u);
+  BOOST_CHECK_EQUAL(number_of_states(lps::partial_order_reduction_mode::deadlock), 27u);
+  BOOST_CHECK_EQUAL(number_of_states(lps::partial_order_reduction_mode::actions), 27u);
+}
+
+BOOST_AUTO_TEST_CASE(test_symmetry_reduction)
+{
+  std::string spec(
+    "act inc, done;\n"
+    "proc P(a, b, c: Nat) = (a < 3) -> inc . P(a = a + 1)\n"
+    "                     + (b < 3) -> inc . P(b = b + 1)\n"
+    "                     + (c < 3) -> inc . P(c = c + 1)\n"
+    "                     + (a == 3) -> done . P(a = 4);\n"
+    "init P(0, 1, 0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  auto number_of_states = [&](const std::string& symmetry)
+  {
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+    options.symmetry = symmetry;
+
+    lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+    lts::lts_none_builder builder;
+    BOOST_CHECK(generator.explore(builder));
+    return generator.explorer.state_map().size();
+  };
+
+  // The summand with action done breaks the symmetry of a with b and c.
+  BOOST_CHECK_EQUAL(number_of_states(""), 60u);
+  BOOST_CHECK_EQUAL(number_of_states("auto"), 45u);
+  BOOST_CHECK_EQUAL(number_of_states("b,c"), 45u);
+  BOOST_CHECK_THROW(number_of_states("a,b"), mcrl2::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_swarm)
+{
+  std::string spec(
+    "act a, b;\n"
+    "proc P(n, m: Nat) = (n < 20 && !(n == 13 && m == 7)) -> a . P(n = n + 1)\n"
+    "                  + (m < 20 && !(n == 13 && m == 7)) -> b . P(m = m + 1)\n"
+    "                  + (n == 20 && m == 20) -> a . P(0, 0);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  lps::explorer_options options;
+  options.detect_deadlock = true;
+  options.bitstate_memory = 4 * 1024 * 1024;
+
+  lts::state_space_swarm<false, lps::specification> swarm(lpsspec, options, 3);
+  BOOST_CHECK(swarm.explore());
+
+  // Without the deadlock state the swarm finds nothing.
+  lps::specification lpsspec_without_deadlock;
+  parse_lps(utilities::regex_replace("n == 13 && m == 7", "n == 21", spec), lpsspec_without_deadlock);
+  lts::state_space_swarm<false, lps::specification> swarm_without_deadlock(lpsspec_without_deadlock, options, 3);
+  BOOST_CHECK(!swarm_without_deadlock.explore());
+}
+
+BOOST_AUTO_TEST_CASE(test_metrics)
+{
+  std::string spec(
+    "act a, b;\n"
+    "proc P(n: Nat) = (n < 50) -> a.P(n + 1)\n"
+    "               + (n == 50) -> b.P(n + 1);\n"
+    "init P(0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  const std::string metrics_file = static_cast<std::string>(boost::unit_test::framework::current_test_case().p_name) + ".jsonl";
+  lps::explorer_options options;
+  options.search_strategy = lps::es_breadth;
+  options.cached = true;
+  options.metrics_filename = metrics_file;
+  {
+    lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+    lts::lts_none_builder builder;
+    BOOST_CHECK(generator.explore(builder));
+
+    // Every summand is enumerated for all 52 states, and every state is computed with a single rewrite.
+    const lps::explorer_metrics metrics = generator.explorer.metrics();
+    BOOST_CHECK_EQUAL(metrics.summands.size(), 2u);
+    BOOST_CHECK_EQUAL(metrics.summands[0].visits, 52u);
+    BOOST_CHECK_EQUAL(metrics.summands[0].transitions, 50u);
+    BOOST_CHECK_EQUAL(metrics.summands[1].transitions, 1u);
+    BOOST_CHECK_EQUAL(metrics.cache_hits + metrics.cache_misses, 104u);
+    BOOST_CHECK(metrics.rewrites >= 52u);
+  }
+
+  std::ifstream in(metrics_file);
+  std::string line;
+  std::string last_line;
+  while (std::getline(in, line))
+  {
+    last_line = line;
+  }
+  BOOST_CHECK(last_line.find("\"states\":52,\"transitions\":51,") != std::string::npos);
+  BOOST_CHECK(last_line.find("\"final\":true}") != std::string::npos);
+  in.close();
+  std::remove(metrics_file.c_str());
+
+  // Without a file the metrics are not measured.
+  options.metrics_filename.clear();
+  lts::state_space_generator<false, false, lps::specification> generator(lpsspec, options);
+  lts::lts_none_builder builder;
+  BOOST_CHECK(generator.explore(builder));
+  BOOST_CHECK_EQUAL(generator.explorer.metrics().rewrites, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_probabilistic_multiple_threads)
+{
+  if constexpr (mcrl2::utilities::detail::GlobalThreadSafe)
+  {
+    std::string spec(
+      "act a, b: Nat;\n"
+      "proc P(n, m: Nat) = (n < 20) -> a(n) . dist k: Bool[if(k, 1 / 3, 2 / 3)] . P(if(k, n + 1, n), (m + n) mod 7)\n"
+      "                  + (m > 3) -> b(m) . dist j: Nat[if(j < 3, 1 / 3, 0)] . P(n, (m + j + 1) mod 11);\n"
+      "init dist k: Bool[1 / 2] . P(0, if(k, 5, 7));\n"
+    );
+    lps::stochastic_specification lpsspec;
+    parse_lps(spec, lpsspec);
+
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+    options.number_of_threads = 4;
+    options.save_at_end = true;
+    options.rewrite_actions = true;
+
+    const std::string outputfile = "test_probabilistic_multiple_threads.generatelts.lts";
+    auto builder = create_stochastic_lts_builder(lpsspec, options, lts::lts_lts);
+    generate_state_space<true, false>(lpsspec, *builder, outputfile, options);
+
+    lts::probabilistic_lts_lts_t result;
+    result.load(outputfile);
+    BOOST_CHECK_EQUAL(result.num_states(), 285u);
+    BOOST_CHECK_EQUAL(result.num_transitions(), 365u);
+    std::remove(outputfile.c_str());
+  }
+}
+
+// The builders that write to disk collect the transitions of each thread in a buffer. Check that the
+// result with several threads is the same as the one of the builders that save the state space at the end.
+template <typename LTSType>
+void check_disk_builder_multiple_threads(const lps::specification& lpsspec, std::size_t expected_states, std::size_t expected_transitions)
+{
+  LTSType result[2];
+  for (bool save_at_end: { false, true })
+  {
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+    options.number_of_threads = 4;
+    options.save_at_end = save_at_end;
+
+    const std::string outputfile = "test_disk_builders_multiple_threads.generatelts" + file_extension(result[save_at_end].type());
+    auto builder = create_lts_builder(lpsspec, options, result[save_at_end].type(), outputfile);
+    generate_state_space<false, false>(lpsspec, *builder, outputfile, options);
+    builder.reset();
+    result[save_at_end].load(outputfile);
+    std::remove(outputfile.c_str());
+
+    BOOST_CHECK_EQUAL(result[save_at_end].num_states(), expected_states);
+    BOOST_CHECK_EQUAL(result[save_at_end].num_transitions(), expected_transitions);
+  }
+
+  // No two states of the state space are bisimilar, so with the same number of states and transitions
+  // bisimilar state spaces are equal up to the numbering of states and the order of transitions.
+  BOOST_CHECK(lts::compare(result[0], result[1], lts::lts_eq_bisim));
+}
+
+BOOST_AUTO_TEST_CASE(test_disk_builders_multiple_threads)
+{
+  if constexpr (mcrl2::utilities::detail::GlobalThreadSafe)
+  {
+    std::string spec(
+      "act a, b: Nat;\n"
+      "proc P(n, m: Nat) = (n < 70) -> a(n) . P(n = n + 1)\n"
+      "                  + (m < 70) -> b(m) . P(m = m + 1);\n"
+      "init P(0, 0);\n"
+    );
+    lps::specification lpsspec;
+    parse_lps(spec, lpsspec);
+
+    check_disk_builder_multiple_threads<lts::lts_aut_t>(lpsspec, 5041, 9940);
+    check_disk_builder_multiple_threads<lts::lts_lts_t>(lpsspec, 5041, 9940);
+  }
+}
+
+// Generates the state space with the external breadth-first strategy, where the buffer holds at most buffer_size
+// states, explored states or transitions, and compares it with the state space of the breadth-first strategy.
+template <typename LTSType>
+void check_external_breadth_first(const lps::specification& lpsspec, std::size_t buffer_size, std::size_t expected_states, std::size_t expected_transitions)
+{
+  LTSType result[2];
+  for (lps::exploration_strategy strategy: { lps::es_breadth, lps::es_external_breadth })
+  {
+    lps::explorer_options options;
+    options.search_strategy = strategy;
+    options.external_buffer_size = buffer_size;
+    options.save_at_end = true;
+
+    LTSType& lts = result[strategy == lps::es_external_breadth];
+    const std::string outputfile = "test_external_breadth_first.generatelts" + file_extension(lts.type());
+    auto builder = create_lts_builder(lpsspec, options, lts.type(), outputfile);
+    generate_state_space<false, false>(lpsspec, *builder, outputfile, options);
+    builder.reset();
+    lts.load(outputfile);
+    std::remove(outputfile.c_str());
+
+    BOOST_CHECK_EQUAL(lts.num_states(), expected_states);
+    BOOST_CHECK_EQUAL(lts.num_transitions(), expected_transitions);
+  }
+
+  // No two states of the state space are bisimilar, see check_disk_builder_multiple_threads.
+  BOOST_CHECK(lts::compare(result[0], result[1], lts::lts_eq_bisim));
+}
+
+BOOST_AUTO_TEST_CASE(test_external_breadth_first)
+{
+  std::string spec(
+    "act a, b: Nat;\n"
+    "proc P(n, m: Nat) = (n < 9) -> a(n) . P(n = n + 1)\n"
+    "                  + (m < 9) -> b(m) . P(m = m + 1);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  // A buffer of three states forces a merge with the states on disk after every state or two.
+  for (std::size_t buffer_size: { 1, 3, 1000 })
+  {
+    check_external_breadth_first<lts::lts_aut_t>(lpsspec, buffer_size, 100, 180);
+    check_external_breadth_first<lts::lts_lts_t>(lpsspec, buffer_size, 100, 180);
+  }
+}
+
+// Explores the state space until max_states is reached, which saves a checkpoint, resumes from that checkpoint,
+// and compares the result with the state space that is generated without interruption.
+template <typename LTSType>
+void check_resume_from_checkpoint(const lps::specification& lpsspec, std::size_t max_states)
+{
+  LTSType result[2];
+  for (bool interrupted: { false, true })
+  {
+    lps::explorer_options options;
+    options.search_strategy = lps::es_breadth;
+
+    LTSType& lts = result[interrupted];
+    const std::string outputfile = "test_resume_from_checkpoint.generatelts" + file_extension(lts.type());
+    if (interrupted)
+    {
+      options.checkpoint_filename = "test_resume_from_checkpoint.checkpoint";
+      options.max_states = max_states;
+      auto builder = create_lts_builder(lpsspec, options, lts.type(), outputfile);
+      generate_state_space<false, false>(lpsspec, *builder, outputfile, options);
+      options.max_states = std::numeric_limits<std::size_t>::max();
+      options.resume = true;
+    }
+    auto builder = create_lts_builder(lpsspec, options, lts.type(), outputfile);
+    generate_state_space<false, false>(lpsspec, *builder, outputfile, options);
+    builder.reset();
+    lts.load(outputfile);
+    std::remove(outputfile.c_str());
+    if (interrupted)
+    {
+      std::remove(options.checkpoint_filename.c_str());
+      std::remove((options.checkpoint_filename + ".transitions").c_str());
+    }
+  }
+
+  BOOST_CHECK_EQUAL(result[0].num_states(), result[1].num_states());
+  BOOST_CHECK_EQUAL(result[0].num_transitions(), result[1].num_transitions());
+  BOOST_CHECK(lts::compare(result[0], result[1], lts::lts_eq_bisim));
+}
+
+BOOST_AUTO_TEST_CASE(test_resume_from_checkpoint)
+{
+  std::string spec(
+    "act a, b: Nat;\n"
+    "proc P(n, m: Nat) = (n < 9) -> a(n) . P(n = n + 1)\n"
+    "                  + (m < 9) -> b(m) . P(m = m + 1);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  check_resume_from_checkpoint<lts::lts_aut_t>(lpsspec, 20);
+  check_resume_from_checkpoint<lts::lts_lts_t>(lpsspec, 20);
+}
+
+// Writes a generated state space in the indexed binary aterm format, with sections that are much smaller than
+// the state space, and checks that reading it back yields the same lts.
+BOOST_AUTO_TEST_CASE(test_indexed_lts_format)
+{
+  std::string spec(
+    "act a, b: Nat;\n"
+    "proc P(n, m: Nat) = (n < 9) -> a(n) . P(n = n + 1)\n"
+    "                  + (m < 9) -> b(m) . P(m = m + 1);\n"
+    "init P(0, 0);\n"
+  );
+  lps::specification lpsspec;
+  parse_lps(spec, lpsspec);
+
+  lps::explorer_options options;
+  options.save_at_end = true;
+  const std::string outputfile = "test_indexed_lts_format.lts";
+  auto builder = create_lts_builder(lpsspec, options, lts::lts_lts, outputfile);
+  generate_state_space<false, false>(lpsspec, *builder, outputfile, options);
+  builder.reset();
+
+  lts::lts_lts_t expected;
+  expected.load(outputfile);
+  expected.save(outputfile, 7);
+  BOOST_CHECK(atermpp::is_indexed_binary_aterm_file(outputfile));
+
+  lts::lts_lts_t result;
+  result.load(outputfile);
+  std::remove(outputfile.c_str());
+
+  BOOST_CHECK_EQUAL(result.num_states(), 100u);
+  BOOST_CHECK_EQUAL(result.num_transitions(), 180u);
+  BOOST_CHECK_EQUAL(result.initial_state(), expected.initial_state());
+  BOOST_CHECK(result.process_parameters() == expected.process_parameters());
+  BOOST_CHECK(result.action_label_declarations() == expected.action_label_declarations());
+  BOOST_REQUIRE_EQUAL(result.num_state_labels(), expected.num_state_labels());
+  for (std::size_t i = 0; i < expected.num_state_labels(); ++i)
+  {
+    BOOST_CHECK(result.state_label(i) == expected.state_label(i));
+  }
+  BOOST_CHECK(lts::compare(result, expected, lts::lts_eq_bisim));
+}
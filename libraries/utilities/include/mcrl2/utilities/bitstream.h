@@ -10,7 +10,10 @@
 #ifndef MCRL2_UTILITIES_BITSTREAM_H
 #define MCRL2_UTILITIES_BITSTREAM_H
 
+#include "mcrl2/utilities/compression.h"
+
 #include <bitset>
+#include <chrono>
 #include <cstdint>
 #include <vector>
 
@@ -27,12 +30,18 @@ constexpr std::size_t integer_encoding_size()
 }
 
 /// \brief A bitstream provides per bit writing of data to any stream (including stdout).
-/// \details Internally uses bitpacking and buffering for compact and efficient IO.
+/// \details Internally uses bitpacking and buffering for compact and efficient IO. Optionally, the written bytes
+///          are compressed in blocks, in which case the stream starts with a marker that identifies the codec
+///          such that an ibitstream automatically decompresses it.
 class obitstream
 {
 public:
-  /// \brief Provides the stream on which the write function operate.
+  /// \brief Provides the stream on which the write function operate, using the default_compression_codec().
   obitstream(std::ostream& stream);
+
+  /// \brief Provides the stream on which the write function operate and the codec used to compress it.
+  obitstream(std::ostream& stream, compression_codec codec);
+
   ~obitstream() { flush(); }
 
   /// \brief Write the num_of_bits least significant bits in descending order from value.
@@ -56,8 +65,19 @@ private:
   /// \brief Writes size bytes from the given buffer.
   void write(const std::uint8_t* buffer, std::size_t size);
 
+  /// \brief Compresses the bytes in m_block and writes them to the stream.
+  void write_block();
+
   std::ostream& stream;
 
+  compression_codec m_codec; ///< The codec used to compress the blocks.
+  std::vector<std::uint8_t> m_block; ///< The bytes of the current block that is not yet compressed.
+  std::vector<std::uint8_t> m_compressed_block; ///< Stores the compressed block before it is written.
+
+  std::size_t m_uncompressed_bytes = 0; ///< The number of bytes that have been compressed.
+  std::size_t m_compressed_bytes = 0; ///< The number of bytes that have been written for the compressed blocks.
+  std::chrono::nanoseconds m_compression_time{0}; ///< The time spent compressing blocks.
+
   /// \brief Buffer that is filled starting from bit 127 when writing
   std::bitset<128> write_buffer = 0;
 
@@ -72,8 +92,11 @@ class ibitstream
 {
 public:
   /// \brief Provides the stream on which the read function operate.
+  /// \details Whether the stream is compressed, and with which codec, is derived from its first bytes.
   ibitstream(std::istream& stream);
 
+  ~ibitstream();
+
   /// \brief Reads an num_of_bits bits from the input stream and stores them in the least significant part (in descending order) of the return value.
   /// \param num_of_bits Number of bits to read from the input stream.
   std::size_t read_bits(unsigned int num_of_bits);
@@ -89,8 +112,19 @@ private:
   /// \brief Read size bytes into the provided buffer.
   void read(std::size_t size, std::uint8_t* buffer);
 
+  /// \brief Reads and decompresses the next block of the stream into m_block.
+  void read_block();
+
   std::istream& stream;
 
+  compression_codec m_codec = compression_codec::none; ///< The codec used to compress the blocks.
+  std::vector<std::uint8_t> m_block; ///< The decompressed bytes of the current block.
+  std::size_t m_block_position = 0; ///< The position of the next byte to read from m_block.
+  std::vector<std::uint8_t> m_compressed_block; ///< Stores the compressed block before it is decompressed.
+
+  std::size_t m_decompressed_bytes = 0; ///< The number of bytes that have been decompressed.
+  std::chrono::nanoseconds m_decompression_time{0}; ///< The time spent decompressing blocks.
+
   /// \brief Buffer that is filled starting from bit 127 when reading.
   std::bitset<128> read_buffer = 0;
 
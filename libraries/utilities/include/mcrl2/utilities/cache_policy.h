@@ -11,6 +11,9 @@
 #define MCRL2_UTILITIES_CACHE_POLICY_H
 
 #include <forward_list>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
 #include <cassert>
 
@@ -123,6 +126,80 @@ private:
   typename std::forward_list<key_type>::iterator m_last_element_it;
 };
 
+/// \brief A policy that approximates least recently used replacement using the CLOCK algorithm.
+/// \details Every key has a reference bit that is set when the key is touched. The keys are kept in a circular
+///          buffer, and a hand moves over the buffer clearing the reference bits until it finds a key of which
+///          the bit is not set, which is replaced. A key that is used frequently thus survives at least one round
+///          of the hand.
+template<typename Map>
+class clock_policy final : public replacement_policy<Map>
+{
+public:
+  using key_type = typename Map::key_type;
+
+  void clear() override
+  {
+    m_keys.clear();
+    m_referenced.clear();
+    m_positions.clear();
+    m_hand = 0;
+    m_free = npos;
+  }
+
+  typename Map::iterator replacement_candidate(Map& map) override
+  {
+    assert(!m_keys.empty());
+    while (m_referenced[m_hand])
+    {
+      m_referenced[m_hand] = false;
+      m_hand = (m_hand + 1) % m_keys.size();
+    }
+
+    // The position of the replaced key is reused for the key that is inserted next.
+    auto it = map.find(m_keys[m_hand]);
+    assert(it != map.end());
+    m_positions.erase(m_keys[m_hand]);
+    m_free = m_hand;
+    m_hand = (m_hand + 1) % m_keys.size();
+    return it;
+  }
+
+  void inserted(const key_type& key) override
+  {
+    if (m_free != npos)
+    {
+      m_keys[m_free] = key;
+      m_referenced[m_free] = false;
+      m_positions.emplace(key, m_free);
+      m_free = npos;
+    }
+    else
+    {
+      m_positions.emplace(key, m_keys.size());
+      m_keys.push_back(key);
+      m_referenced.push_back(false);
+    }
+  }
+
+  void touch(const key_type& key) override
+  {
+    auto it = m_positions.find(key);
+    if (it != m_positions.end())
+    {
+      m_referenced[it->second] = true;
+    }
+  }
+
+private:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  std::vector<key_type> m_keys;   ///< The circular buffer of keys.
+  std::vector<bool> m_referenced; ///< The reference bit of every key in the buffer.
+  std::unordered_map<key_type, std::size_t, typename Map::hasher, typename Map::key_equal> m_positions; ///< The position of every key in the buffer.
+  std::size_t m_hand = 0;         ///< The position of the hand of the clock.
+  std::size_t m_free = npos;      ///< The position of the key that was replaced last, if it has not been reused yet.
+};
+
 } // namespace utilities
 } // namespace mcrl2
 
@@ -0,0 +1,52 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_UTILITIES_COMPRESSION_H
+#define MCRL2_UTILITIES_COMPRESSION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mcrl2::utilities
+{
+
+/// \brief The codecs that can be used to compress the blocks of a bitstream.
+enum class compression_codec
+{
+  none, ///< The bytes are written as is.
+  lz    ///< A built-in LZ77 style block codec, which favours speed over compression ratio.
+};
+
+/// \returns The codec with the given name, which is either "none" or "lz".
+/// \throws mcrl2::runtime_error when the name does not refer to a codec.
+compression_codec parse_compression_codec(const std::string& name);
+
+/// \returns The name of the given codec.
+std::string print_compression_codec(compression_codec codec);
+
+/// \returns The codec that is used by obitstreams for which no codec is given explicitly.
+/// \details Initially no compression is used, tools can change this with the --compress option.
+compression_codec default_compression_codec();
+
+/// \brief Sets the codec that is used by obitstreams for which no codec is given explicitly.
+void set_default_compression_codec(compression_codec codec);
+
+/// \brief Appends the compression of size bytes from input to the given output.
+/// \details The block is a sequence of literal runs that are each followed by a match, consisting of an
+///          offset and a length, that refers to the already decompressed data.
+void lz_compress(const std::uint8_t* input, std::size_t size, std::vector<std::uint8_t>& output);
+
+/// \brief Decompresses a block produced by lz_compress, which must decompress to exactly output_size bytes.
+/// \throws mcrl2::runtime_error when the block is corrupted.
+void lz_decompress(const std::uint8_t* input, std::size_t size, std::uint8_t* output, std::size_t output_size);
+
+} // namespace mcrl2::utilities
+
+#endif // MCRL2_UTILITIES_COMPRESSION_H
@@ -0,0 +1,214 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef MCRL2_UTILITIES_CONCURRENT_INDEXED_SET_H
+#define MCRL2_UTILITIES_CONCURRENT_INDEXED_SET_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <limits>
+
+namespace mcrl2
+{
+namespace utilities
+{
+
+/// \brief A set that assigns each element an unique index, which can be used concurrently without a global lock.
+/// \details This is an alternative for indexed_set with the same interface. The keys are stored in segments
+///          that are never moved, and the indices are kept in an open addressing hash table. When the hash
+///          table becomes too full a table of twice the size is allocated, after which all threads that access
+///          the set cooperatively migrate the buckets of the old table in small chunks. The old tables are only
+///          released when the set is cleared or destroyed.
+///
+///          The set is not lock-free, as threads wait for each other in a few places: a thread that finds a
+///          bucket that another thread has reserved for a new key waits until its index is written, a thread
+///          that has migrated its chunks waits until the whole migration has completed, and a new index is only
+///          published after all smaller indices have been published. These waits are short, but a thread that
+///          is suspended while it holds a reservation delays the other threads that need its bucket.
+///
+///          As for indexed_set with multiple threads, indices are handed out in the order in which insertions
+///          claim them. The size of the set only counts keys of which the key, and the keys of all smaller
+///          indices, have been stored, so every index below size() can be dereferenced.
+/// \tparam Storage The type in which keys are stored, which must be constructible from a Key and convertible to a const Key&.
+template<typename Key,
+         typename Hash = std::hash<Key>,
+         typename Equals = std::equal_to<Key>,
+         typename Storage = Key>
+class concurrent_indexed_set
+{
+public:
+  typedef Key key_type;
+  typedef std::size_t size_type;
+  typedef Storage value_type;
+  typedef Equals key_equal;
+  typedef Hash hasher;
+  typedef std::ptrdiff_t difference_type;
+
+  /// \brief Random access iterator over the stored keys, in the order of their indices.
+  class const_iterator
+  {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef Storage value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const Storage* pointer;
+    typedef const Storage& reference;
+
+    const_iterator() = default;
+
+    const_iterator(const concurrent_indexed_set* set, std::size_t index)
+      : m_set(set),
+        m_index(index)
+    {}
+
+    reference operator*() const { return m_set->storage(m_index); }
+    pointer operator->() const { return &m_set->storage(m_index); }
+    reference operator[](difference_type n) const { return m_set->storage(m_index + n); }
+
+    const_iterator& operator++() { ++m_index; return *this; }
+    const_iterator operator++(int) { const_iterator result = *this; ++m_index; return result; }
+    const_iterator& operator--() { --m_index; return *this; }
+    const_iterator operator--(int) { const_iterator result = *this; --m_index; return result; }
+
+    const_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+    const_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+    const_iterator operator+(difference_type n) const { return const_iterator(m_set, m_index + n); }
+    const_iterator operator-(difference_type n) const { return const_iterator(m_set, m_index - n); }
+    difference_type operator-(const const_iterator& other) const { return static_cast<difference_type>(m_index) - static_cast<difference_type>(other.m_index); }
+
+    bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+    bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+    bool operator<(const const_iterator& other) const { return m_index < other.m_index; }
+    bool operator>(const const_iterator& other) const { return m_index > other.m_index; }
+    bool operator<=(const const_iterator& other) const { return m_index <= other.m_index; }
+    bool operator>=(const const_iterator& other) const { return m_index >= other.m_index; }
+
+  private:
+    const concurrent_indexed_set* m_set = nullptr;
+    std::size_t m_index = 0;
+  };
+
+  typedef const_iterator iterator;
+  typedef std::reverse_iterator<const_iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  /// \brief Value returned when an element does not exist in the set.
+  static constexpr size_type npos = std::numeric_limits<std::size_t>::max();
+
+  /// \brief Constructor of an empty indexed set.
+  concurrent_indexed_set();
+
+  /// \brief Constructor of an empty indexed set.
+  /// \param number_of_threads Only for compatibility with indexed_set, any thread can use the set.
+  concurrent_indexed_set(std::size_t number_of_threads);
+
+  /// \brief Constructor of an empty indexed set with a hash table of (at least) the given size.
+  /// \param number_of_threads Only for compatibility with indexed_set, any thread can use the set.
+  /// \param initial_hashtable_size The initial size of the hash table.
+  /// \param hash The hash function.
+  /// \param equals The comparison function for its elements.
+  concurrent_indexed_set(std::size_t number_of_threads,
+                       std::size_t initial_hashtable_size,
+                       const hasher& hash = hasher(),
+                       const key_equal& equals = key_equal());
+
+  ~concurrent_indexed_set();
+
+  concurrent_indexed_set(const concurrent_indexed_set&) = delete;
+  concurrent_indexed_set& operator=(const concurrent_indexed_set&) = delete;
+
+  /// \returns The index of the given key, or npos if the key does not occur in the set.
+  /// \details threadsafe
+  size_type index(const key_type& key, std::size_t thread_index = 0) const;
+
+  /// \returns The key at the given index.
+  /// \throws std::out_of_range when there is no key with the given index.
+  const key_type& at(size_type index) const;
+
+  /// \returns The key at the given index.
+  /// \details threadsafe
+  const key_type& operator[](size_type index) const
+  {
+    return static_cast<const key_type&>(storage(index));
+  }
+
+  /// \brief Insert a key in the indexed set and return its index.
+  /// \details If the element was already in the set, the resulting bool is false, and the existing index is returned.
+  ///          Otherwise, the key is inserted in the set, and the next available index is assigned to it.
+  /// \details threadsafe
+  std::pair<size_type, bool> insert(const key_type& key, std::size_t thread_index = 0);
+
+  /// \brief Provides an iterator to the stored key in the indexed set, otherwise end().
+  const_iterator find(const key_type& key, std::size_t thread_index = 0) const;
+
+  /// \brief Removes all elements, this is not threadsafe.
+  void clear(std::size_t thread_index = 0);
+
+  /// \returns The number of elements in the indexed set.
+  /// \details threadsafe
+  size_type size(std::size_t /* thread_index */ = 0) const
+  {
+    return m_size.load(std::memory_order_acquire);
+  }
+
+  const_iterator begin(std::size_t /* thread_index */ = 0) const { return const_iterator(this, 0); }
+  const_iterator end(std::size_t thread_index = 0) const { return const_iterator(this, size(thread_index)); }
+  const_iterator cbegin(std::size_t thread_index = 0) const { return begin(thread_index); }
+  const_iterator cend(std::size_t thread_index = 0) const { return end(thread_index); }
+  const_reverse_iterator rbegin(std::size_t thread_index = 0) const { return const_reverse_iterator(end(thread_index)); }
+  const_reverse_iterator rend(std::size_t thread_index = 0) const { return const_reverse_iterator(begin(thread_index)); }
+  const_reverse_iterator crbegin(std::size_t thread_index = 0) const { return rbegin(thread_index); }
+  const_reverse_iterator crend(std::size_t thread_index = 0) const { return rend(thread_index); }
+
+private:
+  /// \brief An open addressing hash table that stores indices, and refers to its successor during a resize.
+  struct table;
+
+  /// \returns The stored key with the given index.
+  const Storage& storage(std::size_t index) const;
+
+  /// \returns The location where the key with the given index is stored, allocating its segment when necessary.
+  Storage& allocate_storage(std::size_t index);
+
+  /// \returns The current table, after helping to complete a resize that is in progress.
+  table* current_table() const;
+
+  /// \brief Allocates the successor of the given table, unless another thread already did, and migrates to it.
+  void start_resize(table* old_table) const;
+
+  /// \brief Migrates chunks of the given table until none are left and waits until the migration has completed.
+  void migrate(table* old_table) const;
+
+  /// \brief Copies the index of the given bucket to the successor of old_table and marks the bucket as moved.
+  void migrate_bucket(table* old_table, std::size_t bucket) const;
+
+  /// \brief Increases the size to include the given index, after all smaller indices have been included.
+  void publish(std::size_t index);
+
+  /// \returns The first bucket that is probed for the given key.
+  std::size_t start_position(const key_type& key, const table& t) const;
+
+  static constexpr std::size_t number_of_segments = 48;
+
+  mutable std::atomic<table*> m_table;
+  std::atomic<Storage*> m_segments[number_of_segments];
+  std::atomic<std::size_t> m_next_index; ///< The next index that is claimed by an insertion.
+  std::atomic<std::size_t> m_size;       ///< The number of indices of which the key has been stored.
+
+  Hash m_hasher;
+  Equals m_equals;
+};
+
+} // end namespace utilities
+} // end namespace mcrl2
+
+#include "mcrl2/utilities/detail/concurrent_indexed_set.h"
+
+#endif // MCRL2_UTILITIES_CONCURRENT_INDEXED_SET_H
@@ -0,0 +1,453 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+/// \file utilities/detail/concurrent_indexed_set.h
+/// \brief The implementation of the concurrent_indexed_set.
+
+#ifndef MCRL2_UTILITIES_DETAIL_CONCURRENT_INDEXED_SET_H
+#define MCRL2_UTILITIES_DETAIL_CONCURRENT_INDEXED_SET_H
+#pragma once
+
+#include "mcrl2/utilities/concurrent_indexed_set.h"    // necessary for header test.
+#include "mcrl2/utilities/math.h"
+#include "mcrl2/utilities/power_of_two.h"
+#include "mcrl2/utilities/unused.h"
+
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace mcrl2
+{
+namespace utilities
+{
+namespace detail
+{
+
+/// \brief Special values of a bucket in the concurrent_indexed_set, all other values are indices of keys.
+static constexpr std::size_t concurrent_empty = std::numeric_limits<std::size_t>::max();     ///< A free bucket.
+static constexpr std::size_t concurrent_reserved = concurrent_empty - 1;                        ///< A bucket of which the index is being determined.
+static constexpr std::size_t concurrent_moved_empty = concurrent_empty - 2;                     ///< A free bucket that has been migrated.
+static constexpr std::size_t concurrent_moved_flag = std::size_t(1) << (std::numeric_limits<std::size_t>::digits - 2); ///< Marks a migrated index.
+
+static constexpr float concurrent_max_load_factor = 0.5f; ///< The load factor before the hash table is resized.
+static constexpr std::size_t concurrent_minimal_table_size = 1024;
+static constexpr std::size_t concurrent_first_segment_size = 1024; ///< The size of the first segment, every next segment is twice as large.
+static constexpr std::size_t concurrent_migration_chunk_size = 4096; ///< The number of buckets that a thread migrates at a time.
+
+static_assert(is_power_of_two(concurrent_minimal_table_size) && is_power_of_two(concurrent_first_segment_size));
+
+/// \returns True iff the bucket value indicates that the bucket has been moved to the next table.
+inline bool is_migrated(std::size_t value)
+{
+  return value == concurrent_moved_empty || (value < concurrent_moved_empty && (value & concurrent_moved_flag) != 0);
+}
+
+/// \brief Determines the segment, and the position in that segment, at which the key with the given index is stored.
+inline void concurrent_segment_position(std::size_t index, std::size_t& segment, std::size_t& offset)
+{
+  // Segment s stores the indices [F * (2^s - 1), F * (2^(s+1) - 1)) where F is the size of the first segment.
+  segment = ceil_log2(index / concurrent_first_segment_size + 1) - 1;
+  offset = index - concurrent_first_segment_size * ((std::size_t(1) << segment) - 1);
+}
+
+} // namespace detail
+
+#define CONCURRENT_INDEXED_SET_TEMPLATE template <typename Key, typename Hash, typename Equals, typename Storage>
+#define CONCURRENT_INDEXED_SET concurrent_indexed_set<Key, Hash, Equals, Storage>
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+struct CONCURRENT_INDEXED_SET::table
+{
+  table(std::size_t size, table* previous)
+    : buckets(new std::atomic<std::size_t>[size]),
+      size(size),
+      previous(previous)
+  {
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      buckets[i].store(detail::concurrent_empty, std::memory_order_relaxed);
+    }
+  }
+
+  std::unique_ptr<std::atomic<std::size_t>[]> buckets;
+  const std::size_t size;
+
+  table* previous; ///< The table that was replaced by this one, which is kept for threads that still read it.
+  std::atomic<table*> next{nullptr}; ///< The table that replaces this one, when a resize is in progress.
+
+  std::atomic<std::size_t> claimed{0};  ///< The number of buckets that threads have claimed for migration.
+  std::atomic<std::size_t> migrated{0}; ///< The number of buckets that have been migrated.
+};
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline CONCURRENT_INDEXED_SET::concurrent_indexed_set()
+  : concurrent_indexed_set(1, detail::concurrent_minimal_table_size)
+{}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline CONCURRENT_INDEXED_SET::concurrent_indexed_set(std::size_t number_of_threads)
+  : concurrent_indexed_set(number_of_threads, detail::concurrent_minimal_table_size)
+{}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline CONCURRENT_INDEXED_SET::concurrent_indexed_set(
+           std::size_t number_of_threads,
+           std::size_t initial_size,
+           const hasher& hasher,
+           const key_equal& equals)
+  : m_table(new table(round_up_to_power_of_two(std::max(initial_size, detail::concurrent_minimal_table_size)), nullptr)),
+    m_next_index(0),
+    m_size(0),
+    m_hasher(hasher),
+    m_equals(equals)
+{
+  assert(number_of_threads != 0);
+  mcrl2_unused(number_of_threads);
+
+  for (std::atomic<Storage*>& segment : m_segments)
+  {
+    segment.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline CONCURRENT_INDEXED_SET::~concurrent_indexed_set()
+{
+  // The newest table refers to all its predecessors.
+  table* t = m_table.load();
+  while (t->next.load() != nullptr)
+  {
+    t = t->next.load();
+  }
+
+  while (t != nullptr)
+  {
+    table* previous = t->previous;
+    delete t;
+    t = previous;
+  }
+
+  for (std::atomic<Storage*>& segment : m_segments)
+  {
+    delete[] segment.load();
+  }
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline const Storage& CONCURRENT_INDEXED_SET::storage(std::size_t index) const
+{
+  std::size_t segment;
+  std::size_t offset;
+  detail::concurrent_segment_position(index, segment, offset);
+  assert(segment < number_of_segments && m_segments[segment].load() != nullptr);
+  return m_segments[segment].load(std::memory_order_acquire)[offset];
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline Storage& CONCURRENT_INDEXED_SET::allocate_storage(std::size_t index)
+{
+  std::size_t segment;
+  std::size_t offset;
+  detail::concurrent_segment_position(index, segment, offset);
+  assert(segment < number_of_segments);
+
+  Storage* keys = m_segments[segment].load(std::memory_order_acquire);
+  if (keys == nullptr)
+  {
+    // Only one of the threads that allocate a segment concurrently succeeds in installing it.
+    Storage* fresh = new Storage[detail::concurrent_first_segment_size << segment];
+    if (m_segments[segment].compare_exchange_strong(keys, fresh))
+    {
+      keys = fresh;
+    }
+    else
+    {
+      delete[] fresh;
+    }
+  }
+
+  return keys[offset];
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline std::size_t CONCURRENT_INDEXED_SET::start_position(const key_type& key, const table& t) const
+{
+  return (m_hasher(key) * 999953) & (t.size - 1);
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline typename CONCURRENT_INDEXED_SET::table* CONCURRENT_INDEXED_SET::current_table() const
+{
+  table* t = m_table.load(std::memory_order_acquire);
+  while (t->next.load(std::memory_order_acquire) != nullptr)
+  {
+    migrate(t);
+    t = m_table.load(std::memory_order_acquire);
+  }
+  return t;
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline void CONCURRENT_INDEXED_SET::start_resize(table* old_table) const
+{
+  if (old_table->next.load(std::memory_order_acquire) == nullptr)
+  {
+    table* expected = nullptr;
+    table* fresh = new table(old_table->size * 2, old_table);
+    if (!old_table->next.compare_exchange_strong(expected, fresh))
+    {
+      // Another thread started the resize.
+      delete fresh;
+    }
+  }
+
+  migrate(old_table);
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline void CONCURRENT_INDEXED_SET::migrate(table* old_table) const
+{
+  // Claim chunks of buckets until all of them have been claimed.
+  while (true)
+  {
+    const std::size_t first = old_table->claimed.fetch_add(detail::concurrent_migration_chunk_size);
+    if (first >= old_table->size)
+    {
+      break;
+    }
+
+    const std::size_t last = std::min(first + detail::concurrent_migration_chunk_size, old_table->size);
+    for (std::size_t bucket = first; bucket < last; ++bucket)
+    {
+      migrate_bucket(old_table, bucket);
+    }
+    old_table->migrated.fetch_add(last - first, std::memory_order_release);
+  }
+
+  // The new table can only be used once it contains all keys, as otherwise keys could be inserted twice.
+  while (old_table->migrated.load(std::memory_order_acquire) < old_table->size)
+  {
+    std::this_thread::yield();
+  }
+
+  table* expected = old_table;
+  m_table.compare_exchange_strong(expected, old_table->next.load());
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline void CONCURRENT_INDEXED_SET::migrate_bucket(table* old_table, std::size_t bucket) const
+{
+  table& new_table = *old_table->next.load(std::memory_order_acquire);
+  std::atomic<std::size_t>& old_bucket = old_table->buckets[bucket];
+
+  while (true)
+  {
+    std::size_t value = old_bucket.load(std::memory_order_acquire);
+    if (value == detail::concurrent_empty)
+    {
+      if (old_bucket.compare_exchange_strong(value, detail::concurrent_moved_empty))
+      {
+        return;
+      }
+    }
+    else if (value == detail::concurrent_reserved)
+    {
+      // The inserting thread will shortly replace the reservation by an index.
+      std::this_thread::yield();
+    }
+    else
+    {
+      assert(!detail::is_migrated(value));
+
+      // The keys are unique so it suffices to find a free bucket in the new table.
+      std::size_t position = start_position((*this)[value], new_table);
+      while (true)
+      {
+        std::size_t expected = detail::concurrent_empty;
+        if (new_table.buckets[position].compare_exchange_strong(expected, value))
+        {
+          break;
+        }
+        position = (position + 1) & (new_table.size - 1);
+      }
+
+      old_bucket.store(value | detail::concurrent_moved_flag, std::memory_order_release);
+      return;
+    }
+  }
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline typename CONCURRENT_INDEXED_SET::size_type CONCURRENT_INDEXED_SET::index(const key_type& key, std::size_t /* thread_index */) const
+{
+  while (true)
+  {
+    table* t = current_table();
+    std::size_t position = start_position(key, *t);
+    bool retry = false;
+
+    for (std::size_t probes = 0; probes < t->size && !retry; )
+    {
+      const std::size_t value = t->buckets[position].load(std::memory_order_acquire);
+      if (value == detail::concurrent_empty)
+      {
+        return npos;
+      }
+      else if (value == detail::concurrent_reserved)
+      {
+        // Wait until the reservation has been replaced by an index, as it might be the key that is sought.
+        std::this_thread::yield();
+      }
+      else if (detail::is_migrated(value))
+      {
+        retry = true;
+      }
+      else
+      {
+        if (m_equals((*this)[value], key))
+        {
+          return value;
+        }
+
+        position = (position + 1) & (t->size - 1);
+        ++probes;
+      }
+    }
+
+    if (!retry)
+    {
+      return npos;
+    }
+  }
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline std::pair<typename CONCURRENT_INDEXED_SET::size_type, bool> CONCURRENT_INDEXED_SET::insert(const key_type& key, std::size_t /* thread_index */)
+{
+  while (true)
+  {
+    table* t = current_table();
+    if (m_next_index.load(std::memory_order_relaxed) + 1 > detail::concurrent_max_load_factor * t->size)
+    {
+      start_resize(t);
+      continue;
+    }
+
+    std::size_t position = start_position(key, *t);
+    for (std::size_t probes = 0; probes < t->size; )
+    {
+      std::atomic<std::size_t>& bucket = t->buckets[position];
+      std::size_t value = bucket.load(std::memory_order_acquire);
+
+      if (value == detail::concurrent_empty)
+      {
+        if (bucket.compare_exchange_strong(value, detail::concurrent_reserved))
+        {
+          // The bucket is reserved, so no other thread can insert the key before the index is published.
+          const std::size_t index = m_next_index.fetch_add(1);
+          allocate_storage(index) = Storage(key);
+          publish(index);
+          bucket.store(index, std::memory_order_release);
+          return std::make_pair(index, true);
+        }
+
+        // Another thread changed the bucket, inspect it again.
+        continue;
+      }
+      else if (value == detail::concurrent_reserved)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      else if (detail::is_migrated(value))
+      {
+        // A resize is in progress, continue in the new table.
+        break;
+      }
+      else if (m_equals((*this)[value], key))
+      {
+        return std::make_pair(value, false);
+      }
+
+      position = (position + 1) & (t->size - 1);
+      ++probes;
+    }
+
+    if (t->next.load(std::memory_order_acquire) == nullptr)
+    {
+      // The table is full, which can only happen when many threads pass the load check simultaneously.
+      start_resize(t);
+    }
+  }
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline void CONCURRENT_INDEXED_SET::publish(std::size_t index)
+{
+  // The size is increased in the order of the indices, as size() promises that all smaller keys are stored.
+  // The keys of the smaller indices are being stored by threads that do not wait for this one.
+  while (m_size.load(std::memory_order_acquire) != index)
+  {
+    std::this_thread::yield();
+  }
+  m_size.store(index + 1, std::memory_order_release);
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline typename CONCURRENT_INDEXED_SET::const_iterator CONCURRENT_INDEXED_SET::find(const key_type& key, std::size_t thread_index) const
+{
+  const std::size_t idx = index(key, thread_index);
+  if (idx != npos)
+  {
+    return begin(thread_index) + idx;
+  }
+
+  return end(thread_index);
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline const Key& CONCURRENT_INDEXED_SET::at(std::size_t index) const
+{
+  if (index >= size())
+  {
+    throw std::out_of_range("concurrent_indexed_set: index too large: " + std::to_string(index) + " >= " + std::to_string(size()) + ".");
+  }
+
+  return (*this)[index];
+}
+
+CONCURRENT_INDEXED_SET_TEMPLATE
+inline void CONCURRENT_INDEXED_SET::clear(std::size_t /* thread_index */)
+{
+  // Release the stored keys, but keep the segments for reuse.
+  for (std::size_t index = 0; index < size(); ++index)
+  {
+    allocate_storage(index) = Storage();
+  }
+  m_next_index.store(0);
+  m_size.store(0);
+
+  table* t = current_table();
+  for (std::size_t i = 0; i < t->size; ++i)
+  {
+    t->buckets[i].store(detail::concurrent_empty, std::memory_order_relaxed);
+  }
+}
+
+#undef CONCURRENT_INDEXED_SET_TEMPLATE
+#undef CONCURRENT_INDEXED_SET
+
+} // namespace utilities
+
+} // namespace mcrl2
+
+#endif // MCRL2_UTILITIES_DETAIL_CONCURRENT_INDEXED_SET_H
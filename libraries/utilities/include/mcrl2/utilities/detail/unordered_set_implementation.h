@@ -131,6 +131,39 @@ auto MCRL2_UNORDERED_SET_CLASS::erase(typename MCRL2_UNORDERED_SET_CLASS::const_
   return result_it;
 }
 
+MCRL2_UNORDERED_SET_TEMPLATES
+template<typename Predicate>
+std::size_t MCRL2_UNORDERED_SET_CLASS::erase_if(size_type first, size_type last, Predicate predicate)
+{
+  assert(first <= last && last <= m_buckets.size());
+
+  size_type number_of_erased = 0;
+  for (size_type index = first; index < last; ++index)
+  {
+    bucket_type& bucket = m_buckets[index];
+
+    typename bucket_type::const_iterator before_it = bucket.before_begin();
+    for (typename bucket_type::iterator it = bucket.begin(); it != bucket.end();)
+    {
+      if (predicate(*it))
+      {
+        // The before iterator remains valid, and the returned iterator points to the next element.
+        it = bucket.erase_after(m_allocator, before_it);
+        ++number_of_erased;
+      }
+      else
+      {
+        ++before_it;
+        ++it;
+      }
+    }
+  }
+
+  // This is a single atomic update when the set is threadsafe.
+  m_number_of_elements -= number_of_erased;
+  return number_of_erased;
+}
+
 MCRL2_UNORDERED_SET_TEMPLATES
 template<typename ...Args>
 std::size_t MCRL2_UNORDERED_SET_CLASS::count(const Args&... args) const
@@ -158,6 +158,11 @@ class dynamic_library
       }
       return result;
     }
+
+    const std::string& filename() const
+    {
+      return m_filename;
+    }
 };
 
 #endif // MCRL2_UTILITIES_DYNAMIC_LIBRARY_H
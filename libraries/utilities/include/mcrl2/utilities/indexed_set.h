@@ -234,6 +234,14 @@ public:
     size_type result=m_next_index;
     return result;
   }
+
+  /// \brief The number of positions in the hash table, which is resized when size() / capacity() exceeds the maximum load factor.
+  /// \details threadsafe
+  size_type capacity(std::size_t thread_index = 0) const
+  {
+    shared_guard guard = m_shared_mutexes[thread_index].lock_shared();
+    return m_hashtable.size();
+  }
 };
 
 } // end namespace utilities
@@ -49,11 +49,20 @@ protected:
     return "[OPTION]... [INFILE] OUTFILE1 OUTFILE2\n";
   }
 
+  /// \brief Add options to an interface description.
+  /// \param desc An interface description
+  void add_options(interface_description& desc)
+  {
+    tool::add_options(desc);
+    add_compression_option(desc);
+  }
+
   /// \brief Parse non-standard options
   /// \param parser A command line parser
   void parse_options(const command_line_parser& parser)
   {
     tool::parse_options(parser);
+    parse_compression_option(parser);
 
     if (parser.arguments.size() < 2)
     {
@@ -48,11 +48,20 @@ class input_output_tool: public input_tool
       return "[OPTION]... [INFILE [OUTFILE]]\n";
     }
 
+    /// \brief Add options to an interface description.
+    /// \param desc An interface description
+    void add_options(interface_description& desc)
+    {
+      input_tool::add_options(desc);
+      add_compression_option(desc);
+    }
+
     /// \brief Parse non-standard options
     /// \param parser A command line parser
     void parse_options(const command_line_parser& parser)
     {
       input_tool::parse_options(parser);
+      parse_compression_option(parser);
       if (1 < parser.arguments.size())
       {
         m_output_filename = parser.arguments[1];
@@ -0,0 +1,87 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MCRL2_UTILITIES_MEMORY_MAPPED_FILE_H
+#define MCRL2_UTILITIES_MEMORY_MAPPED_FILE_H
+
+#include "mcrl2/utilities/exception.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <istream>
+#include <streambuf>
+#include <string>
+
+namespace mcrl2::utilities
+{
+
+/// \brief Maps the contents of a file read-only into memory.
+/// \details The pages of the file are only loaded by the operating system when they are accessed, which makes
+///          it cheap to open large files of which only a small part is read.
+class memory_mapped_file
+{
+public:
+  /// \brief Maps the file with the given name into memory.
+  /// \throws mcrl2::runtime_error when the file cannot be mapped.
+  explicit memory_mapped_file(const std::string& filename)
+  {
+    try
+    {
+      m_mapping = boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+      m_region = boost::interprocess::mapped_region(m_mapping, boost::interprocess::read_only);
+    }
+    catch (const boost::interprocess::interprocess_exception& ex)
+    {
+      throw mcrl2::runtime_error("Could not map file " + filename + " into memory: " + ex.what());
+    }
+  }
+
+  /// \returns A pointer to the first byte of the file.
+  const char* data() const
+  {
+    return static_cast<const char*>(m_region.get_address());
+  }
+
+  /// \returns The size of the file in bytes.
+  std::size_t size() const
+  {
+    return m_region.get_size();
+  }
+
+private:
+  boost::interprocess::file_mapping m_mapping;
+  boost::interprocess::mapped_region m_region;
+};
+
+/// \brief A stream buffer that reads from a contiguous block of memory that is not owned by it.
+class memory_streambuf : public std::streambuf
+{
+public:
+  memory_streambuf(const char* data, std::size_t size)
+  {
+    // The get area is never written to, but std::streambuf requires non-const pointers.
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+/// \brief An input stream that reads from a contiguous block of memory, for example (part of) a memory mapped file.
+class memory_istream : private memory_streambuf, public std::istream
+{
+public:
+  memory_istream(const char* data, std::size_t size)
+    : memory_streambuf(data, size),
+      std::istream(static_cast<memory_streambuf*>(this))
+  {}
+};
+
+} // namespace mcrl2::utilities
+
+#endif // MCRL2_UTILITIES_MEMORY_MAPPED_FILE_H
@@ -250,6 +250,16 @@ public:
     m_reference.untag();
   }
 
+  bool try_tag() const
+  {
+    return m_reference.try_tag();
+  }
+
+  bool try_untag() const
+  {
+    return m_reference.try_untag();
+  }
+
 private:
   mutable utilities::tagged_pointer<T> m_reference;
 };
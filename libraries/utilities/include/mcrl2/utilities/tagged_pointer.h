@@ -88,6 +88,61 @@ public:
     m_pointer = const_cast<T*>(get());
   }
 
+  /// \brief Apply a tag to the pointer. When the pointer is shared between threads this is a single
+  ///        atomic operation, so several threads can tag the same pointer concurrently.
+  /// \returns True iff the pointer was not tagged before.
+  bool try_tag() const
+  {
+    if constexpr (detail::GlobalThreadSafe)
+    {
+      T* expected = m_pointer.load(std::memory_order_relaxed);
+      while (!mcrl2::utilities::tagged(expected))
+      {
+        if (m_pointer.compare_exchange_weak(expected, mcrl2::utilities::tag(expected), std::memory_order_relaxed))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+    else
+    {
+      if (tagged())
+      {
+        return false;
+      }
+      tag();
+      return true;
+    }
+  }
+
+  /// \brief Remove the tag, atomically when the pointer is shared between threads.
+  /// \returns True iff the pointer was tagged before.
+  bool try_untag() const
+  {
+    if constexpr (detail::GlobalThreadSafe)
+    {
+      T* expected = m_pointer.load(std::memory_order_relaxed);
+      while (mcrl2::utilities::tagged(expected))
+      {
+        if (m_pointer.compare_exchange_weak(expected, mcrl2::utilities::pointer(expected), std::memory_order_relaxed))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+    else
+    {
+      if (!tagged())
+      {
+        return false;
+      }
+      untag();
+      return true;
+    }
+  }
+
   bool defined() const
   {
     return get() != nullptr;
@@ -15,6 +15,7 @@
 #include "mcrl2/utilities/logger.h"
 
 #include "mcrl2/utilities/command_line_interface.h"
+#include "mcrl2/utilities/compression.h"
 #include "mcrl2/utilities/execution_timer.h"
 #include "mcrl2/utilities/platform.h"
 
@@ -83,6 +84,32 @@ class tool
       }
     }
 
+    /// \brief Adds the option to compress binary output, for tools that write their results to a file.
+    /// \param desc An interface description
+    void add_compression_option(interface_description& desc)
+    {
+      desc.add_option("compress", make_optional_argument<std::string>("CODEC", "lz"),
+                      "compress binary output using CODEC, which is either 'lz' (default) or 'none'. "
+                      "Compressed input is recognised automatically");
+    }
+
+    /// \brief Sets the default compression codec of binary output to the one given by the compress option.
+    /// \param parser A command line parser
+    void parse_compression_option(const command_line_parser& parser)
+    {
+      if (parser.options.count("compress") > 0)
+      {
+        try
+        {
+          set_default_compression_codec(parse_compression_codec(parser.option_argument("compress")));
+        }
+        catch (const mcrl2::runtime_error& ex)
+        {
+          parser.error(ex.what());
+        }
+      }
+    }
+
     /// \brief Executed only if run would be executed and invoked before run.
     /// \return Whether run should still be executed
     virtual bool pre_run(int& /*argc*/, char** /*argv*/)
@@ -119,6 +119,15 @@ class uncompiled_library : public dynamic_library
       m_filename = m_tempfiles.back();
     }
 
+    /// \brief Uses a library that was compiled before from the source file, where both files are removed as
+    ///        temporary files.
+    void use_compiled(const std::string& source_filename, const std::string& library_filename)
+    {
+      m_tempfiles.push_back(source_filename);
+      m_tempfiles.push_back(library_filename);
+      m_filename = library_filename;
+    }
+
     void leave_files()
     {
       m_tempfiles.clear();
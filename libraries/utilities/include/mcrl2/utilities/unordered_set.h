@@ -294,6 +294,12 @@ public:
   /// \returns An iterator to the next key.
   iterator erase(const_iterator it);
 
+  /// \brief Erases all elements in the buckets with index in [first, last) that satisfy the predicate.
+  /// \details Not standard. Calls on disjoint bucket ranges can be performed concurrently when ThreadSafe holds.
+  /// \returns The number of erased elements.
+  template<typename Predicate>
+  size_type erase_if(size_type first, size_type last, Predicate predicate);
+
   /// \brief Counts the number of occurrences of the given key (1 when it exists and 0 otherwise).
   template<typename ...Args>
   size_type count(const Args&... args) const;
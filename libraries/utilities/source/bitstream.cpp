@@ -22,6 +22,37 @@
 
 using namespace mcrl2::utilities;
 
+/// \brief The first byte of a compressed stream, followed by 'M', 'C' and the codec. Streams of binary aterms start with
+///        a zero byte so they can be distinguished from compressed streams.
+static constexpr std::uint8_t compressed_stream_marker = 0xff;
+
+/// \brief The number of bytes that are compressed together as a single block.
+static constexpr std::size_t compression_block_size = 1 << 20;
+
+/// \brief The largest block that is accepted when reading, which protects against corrupted block headers.
+static constexpr std::size_t max_compression_block_size = 1 << 26;
+
+/// \returns The throughput in megabytes per second, for the given number of bytes processed in the given time.
+static double throughput(std::size_t bytes, std::chrono::nanoseconds time)
+{
+  return time.count() == 0 ? 0.0 : (static_cast<double>(bytes) / (1024.0 * 1024.0)) / std::chrono::duration<double>(time).count();
+}
+
+/// \brief Writes the given value as four bytes, most significant byte first.
+static void write_uint32(std::ostream& stream, std::size_t value)
+{
+  for (int32_t i = 3; i >= 0; --i)
+  {
+    stream.put(static_cast<char>((value >> (8 * i)) & 255));
+  }
+}
+
+/// \brief Reads a value written by write_uint32.
+static std::size_t read_uint32(const std::uint8_t* buffer)
+{
+  return (static_cast<std::size_t>(buffer[0]) << 24) | (static_cast<std::size_t>(buffer[1]) << 16) | (static_cast<std::size_t>(buffer[2]) << 8) | buffer[3];
+}
+
 /// \brief Encodes an unsigned variable-length integer using the most significant bit (MSB) algorithm.
 ///        This function assumes that the value is stored as little endian.
 /// \param value The input value. Any standard integer type is allowed.
@@ -99,7 +130,12 @@ static void set_stream_binary(const std::string& name, FILE* handle)
 }
 
 obitstream::obitstream(std::ostream& stream)
-  : stream(stream)
+  : obitstream(stream, default_compression_codec())
+{}
+
+obitstream::obitstream(std::ostream& stream, compression_codec codec)
+  : stream(stream),
+    m_codec(codec)
 {
   // Ensures that the given stream is changed to binary mode.
   if (stream.rdbuf() == std::cout.rdbuf())
@@ -110,6 +146,16 @@ obitstream::obitstream(std::ostream& stream)
   {
     set_stream_binary("cerr", stderr);
   }
+
+  if (m_codec != compression_codec::none)
+  {
+    // Write the marker that indicates the codec of the following blocks.
+    stream.put(static_cast<char>(compressed_stream_marker));
+    stream.put('M');
+    stream.put('C');
+    stream.put(static_cast<char>(m_codec));
+    m_block.reserve(compression_block_size);
+  }
 }
 
 void obitstream::write_bits(std::size_t value, unsigned int number_of_bits)
@@ -131,6 +177,21 @@ void obitstream::write_bits(std::size_t value, unsigned int number_of_bits)
     write_buffer <<= 64;
     bits_in_buffer -= 64;
 
+    if (m_codec != compression_codec::none)
+    {
+      for (int32_t i = 7; i >= 0; --i)
+      {
+        // Collect the bytes in the current block, which is compressed once it is full.
+        m_block.push_back(static_cast<std::uint8_t>((write_value >> (8 * i)) & 255));
+      }
+
+      if (m_block.size() >= compression_block_size)
+      {
+        write_block();
+      }
+      return;
+    }
+
     for (int32_t i = 7; i >= 0; --i)
     {
       // Write the 8 * i most significant bits and mask out the other values.
@@ -168,6 +229,32 @@ ibitstream::ibitstream(std::istream& stream)
   {
     set_stream_binary("cin", stdin);
   }
+
+  if (stream.peek() == compressed_stream_marker)
+  {
+    char marker[4];
+    stream.read(marker, 4);
+    if (stream.fail() || marker[1] != 'M' || marker[2] != 'C' || static_cast<std::uint8_t>(marker[3]) != static_cast<std::uint8_t>(compression_codec::lz))
+    {
+      throw mcrl2::runtime_error("The input file/stream is compressed with an unknown codec.");
+    }
+
+    m_codec = static_cast<compression_codec>(marker[3]);
+  }
+  else
+  {
+    // Peeking at the end of an empty stream sets the eof flag, which is reported when reading.
+    stream.clear(stream.rdstate() & ~std::ios::eofbit);
+  }
+}
+
+ibitstream::~ibitstream()
+{
+  if (m_decompressed_bytes > 0)
+  {
+    mCRL2log(mcrl2::log::verbose) << "Decompressed " << m_decompressed_bytes << " bytes ("
+      << print_compression_codec(m_codec) << ") at " << throughput(m_decompressed_bytes, m_decompression_time) << " MB/s.\n";
+  }
 }
 
 const char* ibitstream::read_string()
@@ -198,15 +285,27 @@ std::size_t ibitstream::read_bits(unsigned int number_of_bits)
   while (bits_in_buffer < number_of_bits)
   {
     // Read bytes until the buffer is sufficiently full.
-    int byte = stream.get();
-
-    if (stream.eof())
+    int byte;
+    if (m_codec != compression_codec::none)
     {
-      throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
+      if (m_block_position == m_block.size())
+      {
+        read_block();
+      }
+      byte = m_block[m_block_position++];
     }
-    else if (stream.fail())
+    else
     {
-      throw mcrl2::runtime_error("Failed to read bytes from the input file/stream.");
+      byte = stream.get();
+
+      if (stream.eof())
+      {
+        throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
+      }
+      else if (stream.fail())
+      {
+        throw mcrl2::runtime_error("Failed to read bytes from the input file/stream.");
+      }
     }
 
     // Shift the 8 bits to the first free (120 - bits_in_buffer) position in the buffer.
@@ -237,6 +336,18 @@ void obitstream::flush()
   write_bits(0, 64 - bits_in_buffer);
   assert(bits_in_buffer == 0);
 
+  if (m_codec != compression_codec::none)
+  {
+    write_block();
+
+    if (m_uncompressed_bytes > 0)
+    {
+      mCRL2log(mcrl2::log::verbose) << "Compressed " << m_uncompressed_bytes << " bytes into " << m_compressed_bytes << " bytes ("
+        << print_compression_codec(m_codec) << ", ratio " << static_cast<double>(m_uncompressed_bytes) / static_cast<double>(std::max<std::size_t>(m_compressed_bytes, 1))
+        << ") at " << throughput(m_uncompressed_bytes, m_compression_time) << " MB/s.\n";
+    }
+  }
+
   stream.flush();
   if (stream.fail())
   {
@@ -253,6 +364,81 @@ void obitstream::write(const uint8_t* buffer, std::size_t size)
   }
 }
 
+void obitstream::write_block()
+{
+  if (m_block.empty())
+  {
+    return;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  m_compressed_block.clear();
+  lz_compress(m_block.data(), m_block.size(), m_compressed_block);
+  m_compression_time += std::chrono::steady_clock::now() - start;
+
+  // Blocks that do not compress are stored as is, which is indicated by an equal stored and original size.
+  const bool store = m_compressed_block.size() >= m_block.size();
+  const std::vector<std::uint8_t>& data = store ? m_block : m_compressed_block;
+
+  write_uint32(stream, m_block.size());
+  write_uint32(stream, data.size());
+  stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+  if (stream.fail())
+  {
+    throw mcrl2::runtime_error("Failed to write bytes to the output file/stream.");
+  }
+
+  m_uncompressed_bytes += m_block.size();
+  m_compressed_bytes += 8 + data.size();
+  m_block.clear();
+}
+
+void ibitstream::read_block()
+{
+  std::uint8_t header[8];
+  stream.read(reinterpret_cast<char*>(header), 8);
+  if (stream.eof())
+  {
+    throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
+  }
+  else if (stream.fail())
+  {
+    throw mcrl2::runtime_error("Failed to read bytes from the input file/stream.");
+  }
+
+  const std::size_t size = read_uint32(header);
+  const std::size_t stored_size = read_uint32(header + 4);
+  if (size == 0 || size > max_compression_block_size || stored_size > size)
+  {
+    throw mcrl2::runtime_error("The input file/stream contains a corrupted compressed block.");
+  }
+
+  m_block.resize(size);
+  m_block_position = 0;
+  if (stored_size == size)
+  {
+    stream.read(reinterpret_cast<char*>(m_block.data()), static_cast<std::streamsize>(size));
+  }
+  else
+  {
+    m_compressed_block.resize(stored_size);
+    stream.read(reinterpret_cast<char*>(m_compressed_block.data()), static_cast<std::streamsize>(stored_size));
+  }
+
+  if (stream.fail())
+  {
+    throw mcrl2::runtime_error("Unexpected end-of-file reached in the input file/stream.");
+  }
+
+  if (stored_size != size)
+  {
+    auto start = std::chrono::steady_clock::now();
+    lz_decompress(m_compressed_block.data(), stored_size, m_block.data(), size);
+    m_decompression_time += std::chrono::steady_clock::now() - start;
+  }
+  m_decompressed_bytes += size;
+}
+
 void ibitstream::read(std::size_t size, std::uint8_t* buffer)
 {
   for (std::size_t index = 0; index < size; ++index)
@@ -0,0 +1,239 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/utilities/compression.h"
+
+#include "mcrl2/utilities/exception.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+using namespace mcrl2::utilities;
+
+/// \brief The minimal length of a match, shorter matches are written as literals.
+static constexpr std::size_t min_match_length = 4;
+
+/// \brief The largest distance at which a match can be found, such that the offset fits into two bytes.
+static constexpr std::size_t max_match_offset = 65535;
+
+/// \brief The number of bits used to index the table with previous positions of four byte sequences.
+static constexpr unsigned int hash_bits = 16;
+
+/// \brief The length fields of a sequence token are four bits, the value 15 indicates that additional bytes follow.
+static constexpr std::size_t token_length_limit = 15;
+
+static std::atomic<compression_codec>& default_codec()
+{
+  static std::atomic<compression_codec> codec(compression_codec::none);
+  return codec;
+}
+
+compression_codec mcrl2::utilities::parse_compression_codec(const std::string& name)
+{
+  if (name == "none")
+  {
+    return compression_codec::none;
+  }
+  else if (name == "lz")
+  {
+    return compression_codec::lz;
+  }
+
+  throw mcrl2::runtime_error("Unknown compression codec " + name + ", expected either 'none' or 'lz'.");
+}
+
+std::string mcrl2::utilities::print_compression_codec(compression_codec codec)
+{
+  switch (codec)
+  {
+    case compression_codec::none: return "none";
+    case compression_codec::lz: return "lz";
+  }
+  return "unknown";
+}
+
+compression_codec mcrl2::utilities::default_compression_codec()
+{
+  return default_codec().load(std::memory_order_relaxed);
+}
+
+void mcrl2::utilities::set_default_compression_codec(compression_codec codec)
+{
+  default_codec().store(codec, std::memory_order_relaxed);
+}
+
+static std::uint32_t read32(const std::uint8_t* data)
+{
+  std::uint32_t value;
+  std::memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+static std::size_t hash32(std::uint32_t value)
+{
+  // Multiplicative hashing, the constant is taken from Knuth.
+  return (value * 2654435761u) >> (32 - hash_bits);
+}
+
+/// \brief Writes the remainder of a length that did not fit into the token.
+static void write_length(std::size_t length, std::vector<std::uint8_t>& output)
+{
+  while (length >= 255)
+  {
+    output.push_back(255);
+    length -= 255;
+  }
+  output.push_back(static_cast<std::uint8_t>(length));
+}
+
+/// \brief Writes a sequence consisting of the given literals followed by a match, where a length of zero
+///        indicates that there is no match (only for the last sequence of a block).
+static void write_sequence(const std::uint8_t* literals, std::size_t number_of_literals,
+                           std::size_t offset, std::size_t length,
+                           std::vector<std::uint8_t>& output)
+{
+  const std::size_t match_field = length == 0 ? 0 : length - min_match_length;
+  output.push_back(static_cast<std::uint8_t>((std::min(number_of_literals, token_length_limit) << 4) | std::min(match_field, token_length_limit)));
+
+  if (number_of_literals >= token_length_limit)
+  {
+    write_length(number_of_literals - token_length_limit, output);
+  }
+  output.insert(output.end(), literals, literals + number_of_literals);
+
+  if (length != 0)
+  {
+    output.push_back(static_cast<std::uint8_t>(offset & 0xff));
+    output.push_back(static_cast<std::uint8_t>(offset >> 8));
+
+    if (match_field >= token_length_limit)
+    {
+      write_length(match_field - token_length_limit, output);
+    }
+  }
+}
+
+void mcrl2::utilities::lz_compress(const std::uint8_t* input, std::size_t size, std::vector<std::uint8_t>& output)
+{
+  // Stores the last position (plus one) at which a four byte sequence with the given hash occurred.
+  std::vector<std::size_t> table(std::size_t(1) << hash_bits, 0);
+
+  std::size_t anchor = 0; // The first byte that has not been written yet.
+  std::size_t position = 0;
+  while (position + min_match_length <= size)
+  {
+    const std::uint32_t sequence = read32(input + position);
+    std::size_t& entry = table[hash32(sequence)];
+    const std::size_t candidate = entry;
+    entry = position + 1;
+
+    if (candidate != 0 && position - (candidate - 1) <= max_match_offset && read32(input + candidate - 1) == sequence)
+    {
+      const std::size_t match = candidate - 1;
+      std::size_t length = min_match_length;
+      while (position + length < size && input[match + length] == input[position + length])
+      {
+        ++length;
+      }
+
+      write_sequence(input + anchor, position - anchor, position - match, length, output);
+      position += length;
+      anchor = position;
+    }
+    else
+    {
+      ++position;
+    }
+  }
+
+  // The last sequence only consists of the remaining literals.
+  write_sequence(input + anchor, size - anchor, 0, 0, output);
+}
+
+/// \brief Reads the remainder of a length that did not fit into the token.
+static std::size_t read_length(const std::uint8_t*& input, const std::uint8_t* end)
+{
+  std::size_t length = 0;
+  std::uint8_t byte;
+  do
+  {
+    if (input == end)
+    {
+      throw mcrl2::runtime_error("Corrupted compressed block, the length of a sequence is truncated.");
+    }
+    byte = *input++;
+    length += byte;
+  }
+  while (byte == 255);
+
+  return length;
+}
+
+void mcrl2::utilities::lz_decompress(const std::uint8_t* input, std::size_t size, std::uint8_t* output, std::size_t output_size)
+{
+  const std::uint8_t* end = input + size;
+  std::size_t position = 0;
+
+  while (input != end)
+  {
+    const std::uint8_t token = *input++;
+
+    std::size_t number_of_literals = token >> 4;
+    if (number_of_literals == token_length_limit)
+    {
+      number_of_literals += read_length(input, end);
+    }
+
+    if (number_of_literals > static_cast<std::size_t>(end - input) || number_of_literals > output_size - position)
+    {
+      throw mcrl2::runtime_error("Corrupted compressed block, literals exceed the block.");
+    }
+    std::memcpy(output + position, input, number_of_literals);
+    input += number_of_literals;
+    position += number_of_literals;
+
+    if (input == end)
+    {
+      // The last sequence has no match.
+      break;
+    }
+
+    if (end - input < 2)
+    {
+      throw mcrl2::runtime_error("Corrupted compressed block, the offset of a match is truncated.");
+    }
+    const std::size_t offset = input[0] | (static_cast<std::size_t>(input[1]) << 8);
+    input += 2;
+
+    std::size_t length = (token & 0xf) + min_match_length;
+    if ((token & 0xf) == token_length_limit)
+    {
+      length += read_length(input, end);
+    }
+
+    if (offset == 0 || offset > position || length > output_size - position)
+    {
+      throw mcrl2::runtime_error("Corrupted compressed block, a match refers outside of the block.");
+    }
+
+    // The match can overlap with the bytes that it produces, so it is copied byte by byte.
+    const std::uint8_t* match = output + position - offset;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      output[position + i] = match[i];
+    }
+    position += length;
+  }
+
+  if (position != output_size)
+  {
+    throw mcrl2::runtime_error("Corrupted compressed block, it has an unexpected size.");
+  }
+}
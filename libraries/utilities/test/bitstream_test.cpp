@@ -47,3 +47,52 @@ BOOST_AUTO_TEST_CASE(fixed_sequence_test)
   
   BOOST_CHECK_EQUAL(output.read_integer(), std::size_t(1) << 63);
 }
+
+BOOST_AUTO_TEST_CASE(compressed_sequence_test)
+{
+  std::stringstream stream;
+
+  {
+    obitstream input(stream, compression_codec::lz);
+    input.write_string("function_symbol");
+
+    // Write enough repetitive data to span multiple compressed blocks.
+    for (std::size_t i = 0; i < 500000; ++i)
+    {
+      input.write_integer(i % 1000);
+      input.write_bits(i % 8, 3);
+    }
+
+    // The buffer is flushed here.
+  }
+
+  BOOST_CHECK_LT(stream.str().size(), 500000);
+
+  // The compression is detected automatically.
+  ibitstream output(stream);
+  BOOST_CHECK_EQUAL(strcmp(output.read_string(), "function_symbol"), 0);
+
+  for (std::size_t i = 0; i < 500000; ++i)
+  {
+    BOOST_CHECK_EQUAL(output.read_integer(), i % 1000);
+    BOOST_CHECK_EQUAL(output.read_bits(3), i % 8);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(lz_block_test)
+{
+  // A block with both incompressible and highly repetitive parts.
+  std::vector<std::uint8_t> block;
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    block.push_back(static_cast<std::uint8_t>(i < 50000 ? (i * 7919) % 251 : i % 3));
+  }
+
+  std::vector<std::uint8_t> compressed;
+  lz_compress(block.data(), block.size(), compressed);
+  BOOST_CHECK_LT(compressed.size(), block.size());
+
+  std::vector<std::uint8_t> decompressed(block.size());
+  lz_decompress(compressed.data(), compressed.size(), decompressed.data(), decompressed.size());
+  BOOST_CHECK(block == decompressed);
+}
@@ -0,0 +1,154 @@
+// Author(s): agent
+// Copyright: see the accompanying file COPYING or copy at
+// https://github.com/mCRL2org/mCRL2/blob/master/COPYING
+//
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#include "mcrl2/utilities/concurrent_indexed_set.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BOOST_AUTO_TEST_MAIN
+#include <boost/test/included/unit_test.hpp>
+
+using namespace mcrl2::utilities;
+
+BOOST_AUTO_TEST_CASE(basic_test_concurrent_indexed_set)
+{
+  concurrent_indexed_set<std::string> t(1, 100);
+
+  std::pair<std::size_t, bool> p;
+  p = t.insert("a");
+  BOOST_CHECK(p.second && p.first == 0);
+  p = t.insert("b");
+  BOOST_CHECK(t.size() == 2);
+  p = t.insert("a");
+  BOOST_CHECK(!p.second && p.first == 0);
+
+  BOOST_CHECK(t.index("a") == 0);
+  BOOST_CHECK(t.index("b") == 1);
+  BOOST_CHECK(t.index("c") == t.npos);
+  BOOST_CHECK(t.find("c") == t.end());
+  BOOST_CHECK(*t.find("b") == "b");
+  BOOST_CHECK(t.at(1) == "b");
+  BOOST_CHECK_THROW(t.at(2), std::out_of_range);
+
+  t.clear();
+  BOOST_CHECK(t.size() == 0);
+  BOOST_CHECK(t.index("a") == t.npos);
+}
+
+BOOST_AUTO_TEST_CASE(resize_concurrent_indexed_set)
+{
+  // Insert enough elements to span several tables and key segments.
+  concurrent_indexed_set<std::size_t> set;
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    BOOST_CHECK_EQUAL(set.insert(i * 7).first, i);
+  }
+
+  for (std::size_t i = 0; i < 100000; ++i)
+  {
+    BOOST_CHECK_EQUAL(set.index(i * 7), i);
+    BOOST_CHECK_EQUAL(set[i], i * 7);
+  }
+
+  std::size_t count = 0;
+  for (std::size_t key : set)
+  {
+    BOOST_CHECK_EQUAL(key, count * 7);
+    ++count;
+  }
+  BOOST_CHECK_EQUAL(count, 100000);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_concurrent_indexed_set)
+{
+  const std::size_t number_of_threads = 8;
+  const std::size_t number_of_keys = 1 << 16; // Coprime to the odd factors used to permute the keys.
+
+  concurrent_indexed_set<std::size_t> set(number_of_threads);
+  std::vector<std::vector<std::size_t>> indices(number_of_threads, std::vector<std::size_t>(number_of_keys));
+
+  // All threads insert the same keys, in a different order, while the table is resized concurrently.
+  std::vector<std::thread> threads;
+  for (std::size_t id = 0; id < number_of_threads; ++id)
+  {
+    threads.emplace_back([&, id]()
+      {
+        for (std::size_t i = 0; i < number_of_keys; ++i)
+        {
+          std::size_t key = (i * (2 * id + 1)) % number_of_keys;
+          indices[id][key] = set.insert(key, id + 1).first;
+        }
+      });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+
+  BOOST_CHECK_EQUAL(set.size(), number_of_keys);
+  for (std::size_t key = 0; key < number_of_keys; ++key)
+  {
+    // Every thread observed the same index for each key.
+    for (std::size_t id = 1; id < number_of_threads; ++id)
+    {
+      BOOST_CHECK_EQUAL(indices[id][key], indices[0][key]);
+    }
+    BOOST_CHECK_EQUAL(set[indices[0][key]], key);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_size_concurrent_indexed_set)
+{
+  const std::size_t number_of_threads = 4;
+  const std::size_t number_of_keys = 1 << 16;
+
+  concurrent_indexed_set<std::size_t> set(number_of_threads + 1);
+  std::atomic<bool> done = false;
+  bool all_stored = true;
+
+  // Every key that is counted by size() must have been stored, where a default constructed key is 0.
+  std::thread reader([&]()
+    {
+      std::size_t checked = 0;
+      while (!done.load())
+      {
+        const std::size_t size = set.size();
+        for (; checked < size; ++checked)
+        {
+          all_stored = all_stored && set[checked] != 0;
+        }
+      }
+    });
+
+  std::vector<std::thread> threads;
+  for (std::size_t id = 0; id < number_of_threads; ++id)
+  {
+    threads.emplace_back([&, id]()
+      {
+        for (std::size_t i = 0; i < number_of_keys; ++i)
+        {
+          set.insert(1 + id * number_of_keys + i, id + 1);
+        }
+      });
+  }
+
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+
+  BOOST_CHECK(all_stored);
+  BOOST_CHECK_EQUAL(set.size(), number_of_threads * number_of_keys);
+}
@@ -38,3 +38,32 @@ BOOST_AUTO_TEST_CASE(test_function_cache)
   }
 
 }
+
+BOOST_AUTO_TEST_CASE(test_clock_cache)
+{
+  clock_cache<int, int> cache(16);
+  const std::size_t max_size = cache.max_size();
+
+  // Fill the cache completely, and use the first key.
+  for (std::size_t i = 0; cache.size() + 1 < max_size; ++i)
+  {
+    cache.emplace(static_cast<int>(i), static_cast<int>(i * i));
+  }
+  const std::size_t size = cache.size();
+  BOOST_CHECK(cache.find(0) != cache.end());
+
+  // The used key gets a second chance, so inserting a new key evicts the second key.
+  cache.emplace(-1, 1);
+  BOOST_CHECK_EQUAL(cache.size(), size);
+  BOOST_CHECK(cache.find(0) != cache.end());
+  BOOST_CHECK(cache.find(1) == cache.end());
+  BOOST_CHECK(cache.find(-1) != cache.end());
+
+  // Inserting many keys never exceeds the maximum size, and the results remain correct.
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto it = cache.emplace(i, i * i).first;
+    BOOST_CHECK_EQUAL((*it).second, i * i);
+    BOOST_CHECK(cache.size() < max_size);
+  }
+}
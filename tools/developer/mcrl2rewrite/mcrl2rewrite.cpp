@@ -63,7 +63,9 @@ bool mcrl2rewriter_tool::run()
       data_specification.remove_mapping(mapping);
     }
     */
+    auto construction_start = std::chrono::high_resolution_clock::now();
     data::rewriter rewriter = create_rewriter(data_specification);
+    const std::chrono::duration<long, std::nano> construction_duration = std::chrono::high_resolution_clock::now() - construction_start;
 
     // Read and parse the data expressions to a vector.
     std::ifstream expressions_file(input_filename2());
@@ -81,6 +83,7 @@ bool mcrl2rewriter_tool::run()
 
     if (m_timing_enabled)
     {
+      std::cerr << "construction: " << std::chrono::duration_cast<std::chrono::milliseconds>(construction_duration).count() << " milliseconds.\n";
       std::cerr << "parsing: " << std::chrono::duration_cast<std::chrono::milliseconds>(parse_duration).count() << " milliseconds.\n";
     }
 
@@ -33,6 +33,7 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
   lts::lts_type output_format = lts::lts_none;
   lps::abortable* current_explorer = nullptr;
   std::set<std::string> trace_multiaction_strings;
+  std::size_t swarm_size = 0; // The number of explorers in swarm verification, 0 means that it is not used.
 
   public:
     lps2lts_tool()
@@ -55,6 +56,38 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       desc.add_option("no-probability-checking", "do not check if probabilities in stochastic specifications have sensible values");
       desc.add_hidden_option("dfs-recursive", "use recursive depth first search for divergence detection");
       desc.add_option("cached", "use enumeration caching techniques to speed up state space generation. ");
+      desc.add_option("cache-size", utilities::make_mandatory_argument("NUM"),
+                 "keep at most NUM enumeration results in each cache, evicting the results that have not been used "
+                 "recently. By default the caches are unbounded. This option can only be used in combination with --cached. ");
+      desc.add_option("tree-compression", "store the discovered states using tree compression, which splits the state vector "
+                 "recursively into two halves that are stored separately. This reduces the memory used per state, in particular "
+                 "for processes with many parameters, at the cost of a slower exploration. ");
+      desc.add_option("shards", utilities::make_mandatory_argument("NUM"),
+                 "divide the discovered states over NUM hash tables, where the hash of a state determines its table, "
+                 "such that fewer threads insert into and resize the same table at a time. "
+                 "This option cannot be combined with --tree-compression. ");
+      desc.add_option("bitstate", utilities::make_mandatory_argument("MB"),
+                 "only store hash values of the discovered states in a bit array of MB megabytes (bitstate hashing), such that "
+                 "larger state spaces can be searched for deadlocks and actions. Two states may get the same hash values, so part "
+                 "of the state space may not be explored; the estimated coverage is reported in verbose mode. Traces are "
+                 "constructed by exploring the state space again. This option cannot be used when an LTS is saved. ");
+      desc.add_option("bitstate-hashes", utilities::make_mandatory_argument("NUM"),
+                 "set NUM bits for every state in bitstate hashing (default 3). This option requires --bitstate. ");
+      desc.add_option("hash-compaction", "store a 64 bit hash value of every state in a hash table instead of setting bits, "
+                 "which is more precise when the memory suffices for all states. This option requires --bitstate. ");
+      desc.add_option("swarm", utilities::make_mandatory_argument("NUM"),
+                 "search for deadlocks and actions with a swarm of NUM independent explorers that run in parallel. Every explorer "
+                 "uses bitstate hashing with its share of the memory given by --bitstate (default 64 MB per explorer), a random "
+                 "order of the summands and a random hash function, and either depth-first or highway search, such that together they "
+                 "cover more of a state space that is too large to be explored completely. All explorers stop as soon as one of them "
+                 "finds a deadlock or an action. This option requires --deadlock, --action or --multiaction, and cannot be used when "
+                 "an LTS is saved. ");
+      desc.add_option("external-dir", utilities::make_mandatory_argument("DIR"),
+                 "store the discovered states of the external search strategy in a subdirectory of DIR, which is "
+                 "removed afterwards. By default the directory for temporary files is used. ");
+      desc.add_option("external-buffer", utilities::make_mandatory_argument("NUM"),
+                 "buffer at most NUM new states in memory before they are compared to the discovered states on disk "
+                 "(default 1000000); this option is only relevant for the external search strategy. ");
       desc.add_option("todo-max", utilities::make_mandatory_argument("NUM"),
                  "keep at most NUM states in the todo list; this option is only relevant for "
                  "highway search, where NUM is the maximum number of states per level per thread. ");
@@ -97,6 +130,19 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
                  "to tau use the flag -ctau. Only if the linear process is tau-confluent, the generated "
                  "state space is branching bisimilar to the state space of the lps. The generation "
                  "algorithm that is used does not require the linear process to be tau convergent. ", 'c');
+      desc.add_option("por", utilities::make_enum_argument<lps::partial_order_reduction_mode>("MODE")
+                   .add_value(lps::partial_order_reduction_mode::none, true)
+                   .add_value(lps::partial_order_reduction_mode::deadlock)
+                   .add_value(lps::partial_order_reduction_mode::actions),
+                 "apply partial-order reduction using stubborn sets of summands, which are computed from the parameters that "
+                 "the summands read and write. Only part of the interleavings of independent summands is explored:");
+      desc.add_option("symmetry", utilities::make_mandatory_argument("GROUPS"),
+                 "apply symmetry reduction, in which only one state is explored of every set of states that are equal up to a "
+                 "permutation of the blocks of process parameters in GROUPS. Groups are separated by semicolons, the blocks of a "
+                 "group by commas and the parameters of a block by colons, e.g. 'pc1:x1,pc2:x2,pc3:x3'. "
+                 "It is checked that every permutation maps the summands of the linear process to summands. With the value "
+                 "'auto' groups of single parameters are detected. States in the output and in traces are the representatives "
+                 "of their sets.");
       desc.add_option("out", utilities::make_mandatory_argument("FORMAT"), "save the output in the specified FORMAT. ", 'o');
       desc.add_option("tau", utilities::make_mandatory_argument("NAMES"),
                  "consider actions that occur in the comma-separated list of action names "
@@ -105,12 +151,28 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
                    .add_value_short(lps::es_breadth, "b", true)
                    .add_value_short(lps::es_depth, "d")
                    .add_value_short(lps::es_highway, "h")
+                   .add_value_short(lps::es_external_breadth, "e")
         , "explore the state space using strategy NAME:"
         , 's');
       desc.add_option("suppress","in verbose mode, do not print progress messages indicating the number of visited states and transitions.");
       desc.add_option("save-at-end", "delay saving of the generated LTS until the end. "
                  "This option only applies to .aut and .lts files, which are by default saved on the fly.");
       desc.add_option("no-info", "do not add state label information to OUTFILE. This option only applies to .lts files.");
+      desc.add_option("checkpoint", utilities::make_mandatory_argument("FILE"),
+                 "periodically save the progress of the state space generation to FILE, and also when the generation "
+                 "is interrupted. With .lts output the transitions are kept in FILE.transitions until the generation "
+                 "has finished. This option requires a single thread and .aut or .lts output that is saved on the fly. ");
+      desc.add_option("checkpoint-interval", utilities::make_mandatory_argument("SEC"),
+                 "save a checkpoint every SEC seconds (default 1800). This option requires --checkpoint. ");
+      desc.add_option("resume", "resume the state space generation from the checkpoint given by --checkpoint, "
+                 "where OUTFILE must be the partially generated output of the interrupted run. ");
+      desc.add_option("metrics", utilities::make_mandatory_argument("FILE"),
+                 "write metrics of the state space generation to FILE as JSON lines, such as the numbers of states and "
+                 "transitions per second, the size of the todo list, the load factor of the stored states, the number of "
+                 "rewrites, the hit rate of the enumeration caches, garbage collections and the enumeration time per summand. ");
+      desc.add_option("metrics-interval", utilities::make_mandatory_argument("SEC"),
+                 "write a line of metrics every SEC seconds (default 1), and a final line when the generation has finished. "
+                 "This option requires --metrics. ");
     }
 
     static std::list<std::string> split_actions(const std::string& s)
@@ -215,9 +277,106 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       options.suppress_progress_messages            = parser.has_option("suppress");
       options.dfs_recursive                         = parser.has_option("dfs-recursive");
       options.discard_lts_state_labels              = parser.has_option("no-info");
+      options.tree_compression                      = parser.has_option("tree-compression");
       options.search_strategy = parser.option_argument_as<lps::exploration_strategy>("strategy");
+      options.partial_order_reduction = parser.option_argument_as<lps::partial_order_reduction_mode>("por");
+      if (parser.has_option("symmetry"))
+      {
+        options.symmetry = parser.option_argument("symmetry");
+      }
       options.number_of_threads = number_of_threads();
       bool to_stdout = output_filename().empty() || output_filename() == "-";
+      if (parser.has_option("cache-size"))
+      {
+        if (!options.cached)
+        {
+          parser.error("Option 'cache-size' can only be used in combination with --cached.");
+        }
+        options.cache_size = parser.option_argument_as<std::size_t>("cache-size");
+      }
+      if (parser.has_option("shards"))
+      {
+        if (options.tree_compression)
+        {
+          parser.error("Option 'shards' cannot be used in combination with --tree-compression.");
+        }
+        options.number_of_shards = parser.option_argument_as<std::size_t>("shards");
+        if (options.number_of_shards == 0)
+        {
+          parser.error("The number of shards must be positive.");
+        }
+      }
+      if (parser.has_option("checkpoint"))
+      {
+        options.checkpoint_filename = parser.option_argument("checkpoint");
+        options.resume = parser.has_option("resume");
+        if (parser.has_option("checkpoint-interval"))
+        {
+          options.checkpoint_interval = parser.option_argument_as<std::size_t>("checkpoint-interval");
+        }
+      }
+      else if (parser.has_option("checkpoint-interval") || parser.has_option("resume"))
+      {
+        parser.error("Options 'checkpoint-interval' and 'resume' require the option --checkpoint.");
+      }
+      if (parser.has_option("metrics"))
+      {
+        options.metrics_filename = parser.option_argument("metrics");
+        if (parser.has_option("metrics-interval"))
+        {
+          options.metrics_interval = parser.option_argument_as<std::size_t>("metrics-interval");
+        }
+      }
+      else if (parser.has_option("metrics-interval"))
+      {
+        parser.error("Option 'metrics-interval' requires the option --metrics.");
+      }
+      // bitstate hashing
+      if (parser.has_option("bitstate"))
+      {
+        options.bitstate_memory = parser.option_argument_as<std::size_t>("bitstate") * 1024 * 1024;
+        options.hash_compaction = parser.has_option("hash-compaction");
+        if (parser.has_option("bitstate-hashes"))
+        {
+          options.bitstate_hashes = parser.option_argument_as<std::size_t>("bitstate-hashes");
+        }
+        if (options.bitstate_memory == 0 || options.bitstate_hashes == 0)
+        {
+          parser.error("The memory and the number of hashes of bitstate hashing must be positive.");
+        }
+        if (options.tree_compression || parser.has_option("shards") || parser.has_option("checkpoint") || options.search_strategy == lps::es_external_breadth)
+        {
+          parser.error("Option 'bitstate' cannot be used in combination with --tree-compression, --shards, --checkpoint or external search.");
+        }
+      }
+      else if (parser.has_option("bitstate-hashes") || parser.has_option("hash-compaction"))
+      {
+        parser.error("Options 'bitstate-hashes' and 'hash-compaction' require the option --bitstate.");
+      }
+      // external breadth-first search
+      if (options.search_strategy == lps::es_external_breadth)
+      {
+        if (parser.has_option("external-dir"))
+        {
+          options.external_directory = parser.option_argument("external-dir");
+        }
+        if (parser.has_option("external-buffer"))
+        {
+          options.external_buffer_size = parser.option_argument_as<std::size_t>("external-buffer");
+          if (options.external_buffer_size == 0)
+          {
+            parser.error("The size of the external buffer must be positive.");
+          }
+        }
+        if (options.number_of_threads > 1 || options.tree_compression || parser.has_option("shards") || parser.has_option("checkpoint"))
+        {
+          parser.error("Search strategy 'external' cannot be used in combination with multiple threads, --tree-compression, --shards or --checkpoint.");
+        }
+      }
+      else if (parser.has_option("external-dir") || parser.has_option("external-buffer"))
+      {
+        parser.error("Options 'external-dir' and 'external-buffer' can only be used in combination with external search.");
+      }
       // highway search
       if (parser.has_option("todo-max"))
       {
@@ -318,6 +477,72 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       {
         parser.error("Option '--no-info' requires that the output is in .lts format.");
       }
+      if (!options.checkpoint_filename.empty())
+      {
+        if (options.number_of_threads > 1)
+        {
+          parser.error("Option 'checkpoint' can only be used in single thread mode.");
+        }
+        if (options.save_at_end || (output_format != lts::lts_aut && output_format != lts::lts_lts && output_format != lts::lts_none))
+        {
+          parser.error("Option 'checkpoint' requires that the output is in .aut or .lts format and is saved on the fly.");
+        }
+        if (options.generate_traces || options.save_error_trace)
+        {
+          parser.error("Option 'checkpoint' cannot be used in combination with --trace.");
+        }
+      }
+      if (parser.has_option("swarm"))
+      {
+        swarm_size = parser.option_argument_as<std::size_t>("swarm");
+        if (swarm_size == 0)
+        {
+          parser.error("The number of explorers of a swarm must be positive.");
+        }
+        if (!options.detect_deadlock && !options.detect_action)
+        {
+          parser.error("Option 'swarm' requires --deadlock, --action or --multiaction.");
+        }
+        if (output_format != lts::lts_none || options.number_of_threads > 1 || parser.has_option("checkpoint") ||
+            options.detect_divergence || options.save_error_trace || parser.has_option("metrics"))
+        {
+          parser.error("Option 'swarm' cannot be used when an LTS is saved, or in combination with --threads, --checkpoint, --divergence, --error-trace or --metrics.");
+        }
+        if (options.bitstate_memory == 0)
+        {
+          options.bitstate_memory = swarm_size * 64 * 1024 * 1024;
+        }
+      }
+      if (options.bitstate_memory > 0 && output_format != lts::lts_none)
+      {
+        parser.error("Option 'bitstate' cannot be used when an LTS is saved, as the states are not stored.");
+      }
+      if (options.partial_order_reduction != lps::partial_order_reduction_mode::none)
+      {
+        if (options.confluence || options.detect_divergence || options.search_strategy == lps::es_external_breadth)
+        {
+          parser.error("Option 'por' cannot be used in combination with --confluence, --divergence or external search.");
+        }
+        if (options.detect_nondeterminism)
+        {
+          mCRL2log(log::warning) << "Partial-order reduction does not preserve nondeterministic states, so not all of them may be reported." << std::endl;
+        }
+      }
+      if (!options.symmetry.empty())
+      {
+        if (options.confluence || options.partial_order_reduction != lps::partial_order_reduction_mode::none)
+        {
+          parser.error("Option 'symmetry' cannot be used in combination with --confluence or --por.");
+        }
+        if (options.detect_nondeterminism)
+        {
+          mCRL2log(log::warning) << "Symmetry reduction does not preserve nondeterministic states, so not all of them may be reported." << std::endl;
+        }
+      }
+      if (options.search_strategy == lps::es_external_breadth && (options.generate_traces || options.save_error_trace))
+      {
+        parser.error("Search strategy 'external' cannot be used in combination with --trace.");
+      }
       if (options.number_of_threads>1)
       {
          if (options.save_error_trace)
@@ -351,6 +576,17 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
       return result;
     }
 
+    template <bool Timed>
+    void explore_with_swarm(const lps::specification& lpsspec)
+    {
+      lts::state_space_swarm<Timed, lps::specification> swarm(lpsspec, options, swarm_size);
+      current_explorer = &swarm;
+      if (!swarm.explore())
+      {
+        mCRL2log(log::info) << "The swarm found no deadlocks or actions.\n";
+      }
+    }
+
     bool run() override
     {
       mCRL2log(log::debug) << options << std::endl;
@@ -366,6 +602,10 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
 
       if (lps::is_stochastic(stochastic_lpsspec))
       {
+        if (swarm_size > 0)
+        {
+          throw mcrl2::runtime_error("Option 'swarm' is not supported for stochastic specifications.");
+        }
         auto builder = create_stochastic_lts_builder(stochastic_lpsspec, options, output_format);
         if (is_timed)
         {
@@ -376,6 +616,18 @@ class lps2lts_tool: public parallel_tool<rewriter_tool<input_output_tool>>
           result = generate_state_space<true, false>(stochastic_lpsspec, *builder);
         }
       }
+      else if (swarm_size > 0)
+      {
+        lps::specification lpsspec = lps::remove_stochastic_operators(stochastic_lpsspec);
+        if (is_timed)
+        {
+          explore_with_swarm<true>(lpsspec);
+        }
+        else
+        {
+          explore_with_swarm<false>(lpsspec);
+        }
+      }
       else
       {
         lps::specification lpsspec = lps::remove_stochastic_operators(stochastic_lpsspec);
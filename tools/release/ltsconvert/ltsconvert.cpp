@@ -36,6 +36,7 @@ class t_tool_options
     bool            determinise=false;
     bool            check_reach=true;
     bool            add_state_as_state_label=false;
+    std::size_t     terms_per_section=0;    // If positive, a .lts file is written in the indexed format.
 
     inline t_tool_options() 
      : intype(lts_none), 
@@ -248,14 +249,14 @@ class ltsconvert_tool : public input_output_tool
         {
           lts_lts_t l_out;
           lts_convert(l,l_out,spec.data(),spec.action_labels(),spec.process().process_parameters(),!tool_options.lpsfile.empty());
-          l_out.save(tool_options.outfilename);
+          l_out.save(tool_options.outfilename, tool_options.terms_per_section);
           return true;
         }
         case lts_lts_probabilistic:
         {
           probabilistic_lts_lts_t l_out;
           lts_convert(l,l_out,spec.data(),spec.action_labels(),spec.process().process_parameters(),!tool_options.lpsfile.empty());
-          l_out.save(tool_options.outfilename);
+          l_out.save(tool_options.outfilename, tool_options.terms_per_section);
           return true;
         }
         case lts_none:
@@ -392,6 +393,10 @@ class ltsconvert_tool : public input_output_tool
                       "consider actions with a name in the comma separated list ACTNAMES to "
                       "be internal (tau) actions in addition to those defined as such by "
                       "the input.");
+      desc.add_option("indexed", make_optional_argument("NUM", "65536"),
+                      "write an LTS in the mCRL2 format in sections of NUM terms, together with an index of "
+                      "these sections, such that the sections can be read in parallel. Such files cannot be "
+                      "read by older versions of the toolset.");
       desc.add_hidden_option("add-state-as-state-label",
                              "add the state number as the label of the states in the input file, "
                              "and remove other state labels if they exist");
@@ -459,6 +464,15 @@ class ltsconvert_tool : public input_output_tool
         set_tau_actions(tool_options.tau_actions, parser.option_argument("tau"));
       }
 
+      if (parser.options.count("indexed"))
+      {
+        tool_options.terms_per_section = parser.option_argument_as<std::size_t>("indexed");
+        if (tool_options.terms_per_section == 0)
+        {
+          parser.error("the number of terms per section of option --indexed must be positive");
+        }
+      }
+
       if (parser.options.count("add-state-as-state-label"))
       {
         if (tool_options.intype == lts_aut)
@@ -516,6 +530,18 @@ class ltsconvert_tool : public input_output_tool
           }
         }
       }
+
+      if (tool_options.terms_per_section > 0)
+      {
+        if (tool_options.outtype != lts_lts && tool_options.outtype != lts_lts_probabilistic)
+        {
+          parser.error("option --indexed can only be used when the output is in the mCRL2 LTS format");
+        }
+        if (parser.arguments.size() < 2)
+        {
+          parser.error("option --indexed cannot be used when the output is written to stdout");
+        }
+      }
     }
 
 };